@@ -0,0 +1,280 @@
+/******************************************************************************/
+/*!
+\file   PostProBatch.cpp
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Lays the layers of a texture array out as tiles of one target, so the effect
+stack runs once for all of them
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+
+/*****************************************************************************/
+/*!
+Includes
+*/
+/*****************************************************************************/
+#include "Precompiled.h" //Precompiled header
+#include "RenderBuffer.h"
+#include "GraphicsManager.h"
+#include "ShaderManager.h"
+#include "RenderTargetPool.h"
+#include "PostProEffect.h"
+#include "PostProcessingManager.h"
+
+#include "PostProBatch.h" //Own header
+
+/*****************************************************************************/
+/*!
+Use the engine namespace, for convenience
+*/
+/*****************************************************************************/
+using namespace wfe;
+
+PostProBatch::PostProBatch() : mAtlas(0), mOutput(0), mFormat(RT_FORMAT_RGBA8), mWidth(0), mHeight(0), mGutter(0), mLayerCount(0), mColumns(0), mRows(0), mAtlasGeneration(0)
+{
+  mShader = &WFE_SHADER_MANAGER->GetResource("BatchGather.xml");
+
+  //Corners of a tile, every instance moves them onto its own tile
+  const f32 corners[] = { 0.f, 0.f, 1.f, 0.f, 0.f, 1.f, 1.f, 1.f };
+  glGenBuffers(1, &mCornerBuffer);
+  glBindBuffer(GL_ARRAY_BUFFER, mCornerBuffer);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  mCornerAttrib = glGetAttribLocation(mShader->GetHandle(), "aTexCoord");
+
+  //The gutters read past the edges of the images. A sampler object clamps
+  //them without touching the parameters of the caller's texture
+  glGenSamplers(1, &mSampler);
+  glSamplerParameteri(mSampler, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glSamplerParameteri(mSampler, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glSamplerParameteri(mSampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glSamplerParameteri(mSampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+  glGenFramebuffers(1, &mLayerFramebuffer);
+}
+
+PostProBatch::~PostProBatch()
+{
+  Clear();
+
+  glDeleteBuffers(1, &mCornerBuffer);
+  glDeleteSamplers(1, &mSampler);
+  glDeleteFramebuffers(1, &mLayerFramebuffer);
+}
+
+/*****************************************************************************/
+/*!
+The grid is as square as the layer count allows, so the atlas stays within
+the texture size limit for as many layers as possible. The atlas is only
+reallocated when the layout, the gutter or the color format changes
+*/
+/*****************************************************************************/
+RenderBuffer* PostProBatch::Reserve(s32 width, s32 height, u32 layerCount, const std::vector<PostProEffect*>& effects)
+{
+  if (layerCount > sMaxLayers)
+  {
+    WFE_LOGGER_POPUP << "Post processing batch of " << layerCount << " images, only the first " << sMaxLayers << " are processed" << std::endl;
+    layerCount = sMaxLayers;
+  }
+
+  if (!layerCount || width <= 0 || height <= 0)
+  {
+    Clear();
+    return 0;
+  }
+
+  RenderTargetFormat format = PostProEffect::GetColorFormat(false);
+
+  u32 columns = 1;
+  while (columns * columns < layerCount)
+  {
+    ++columns;
+  }
+  u32 rows = (layerCount + columns - 1) / columns;
+
+  s32 gutter = GetGutter(effects, width, height, columns, rows);
+
+  if (mAtlas && width == mWidth && height == mHeight && gutter == mGutter && layerCount == mLayerCount && format == mFormat)
+  {
+    return mAtlas;
+  }
+
+  Clear();
+
+  GLint maxSize = 0;
+  glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+  if (static_cast<s32>(columns) * width > maxSize || static_cast<s32>(rows) * height > maxSize)
+  {
+    WFE_LOGGER_POPUP << "Post processing batch of " << layerCount << " " << width << "x" << height << " images does not fit into a texture" << std::endl;
+    return 0;
+  }
+
+  //Narrower gutters let the widest reaching effects bleed between images,
+  //but still beat not batching at all
+  s32 maxGutter = std::min((maxSize / static_cast<s32>(columns) - width) / 2, (maxSize / static_cast<s32>(rows) - height) / 2);
+  if (gutter > maxGutter)
+  {
+    WFE_LOGGER_POPUP << "Post processing batch gutter cut from " << gutter << " to " << maxGutter << " pixels to fit into a texture, effects may bleed between images" << std::endl;
+    gutter = maxGutter;
+  }
+
+  s32 atlasWidth = columns * (width + 2 * gutter);
+  s32 atlasHeight = rows * (height + 2 * gutter);
+
+  mWidth = width;
+  mHeight = height;
+  mGutter = gutter;
+  mLayerCount = layerCount;
+  mColumns = columns;
+  mRows = rows;
+  mFormat = format;
+  mAtlas = PostProcessingManager::sRenderTargetPool->Acquire(atlasWidth, atlasHeight, format, 0);
+  ++mAtlasGeneration;
+
+  return mAtlas;
+}
+
+/*****************************************************************************/
+/*!
+One instance per layer. The quad of an instance covers its tile and the
+gutter around it, the texture coordinates run past the image there and the
+clamped sampler repeats the edge texels
+*/
+/*****************************************************************************/
+void PostProBatch::Gather(GLuint images)
+{
+  ASSERT(mAtlas);
+
+  s32 usedWidth = GetUsedWidth();
+  s32 usedHeight = GetUsedHeight();
+
+  //Tile corners in clip space of the used part of the atlas
+  std::vector<f32> tileRects(sMaxLayers * 4, 0.f);
+  for (u32 i = 0; i < mLayerCount; ++i)
+  {
+    s32 x;
+    s32 y;
+    GetTileOrigin(i, x, y);
+
+    tileRects[i * 4 + 0] = static_cast<f32>(x - mGutter) / usedWidth * 2.f - 1.f;
+    tileRects[i * 4 + 1] = static_cast<f32>(y - mGutter) / usedHeight * 2.f - 1.f;
+    tileRects[i * 4 + 2] = static_cast<f32>(x + mWidth + mGutter) / usedWidth * 2.f - 1.f;
+    tileRects[i * 4 + 3] = static_cast<f32>(y + mHeight + mGutter) / usedHeight * 2.f - 1.f;
+  }
+
+  GLboolean blend = glIsEnabled(GL_BLEND);
+  glDisable(GL_BLEND);
+
+  mAtlas->Bind();
+  glViewport(0, 0, usedWidth, usedHeight);
+
+  WFE_GRAPHICS->SwitchShader(mShader);
+  GLuint program = mShader->GetHandle();
+  glUniform4fv(glGetUniformLocation(program, "uTileRects"), sMaxLayers, &tileRects[0]);
+  glUniform2f(glGetUniformLocation(program, "uGutter"), static_cast<f32>(mGutter) / mWidth, static_cast<f32>(mGutter) / mHeight);
+  glUniform1i(glGetUniformLocation(program, "uImages"), 0);
+
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, images);
+  glBindSampler(0, mSampler);
+
+  glBindBuffer(GL_ARRAY_BUFFER, mCornerBuffer);
+  glEnableVertexAttribArray(mCornerAttrib);
+  glVertexAttribPointer(mCornerAttrib, 2, GL_FLOAT, GL_FALSE, 0, 0);
+  glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, mLayerCount);
+  glDisableVertexAttribArray(mCornerAttrib);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  glBindSampler(0, 0);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+  if (blend)
+  {
+    glEnable(GL_BLEND);
+  }
+}
+
+/*****************************************************************************/
+/*!
+A blit per layer. Blits convert between formats, so results does not have
+to match the format the stack ended in
+*/
+/*****************************************************************************/
+void PostProBatch::Scatter(RenderBuffer* output, GLuint results)
+{
+  output->Bind();
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mLayerFramebuffer);
+
+  for (u32 i = 0; i < mLayerCount; ++i)
+  {
+    s32 x;
+    s32 y;
+    GetTileOrigin(i, x, y);
+
+    glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, results, 0, i);
+    glBlitFramebuffer(x, y, x + mWidth, y + mHeight,
+      0, 0, mWidth, mHeight,
+      GL_COLOR_BUFFER_BIT,
+      GL_NEAREST);
+  }
+
+  glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, 0, 0, 0);
+}
+
+void PostProBatch::Clear()
+{
+  PostProcessingManager::sRenderTargetPool->Release(mAtlas);
+
+  mAtlas = 0;
+  mOutput = 0;
+  mWidth = 0;
+  mHeight = 0;
+  mGutter = 0;
+  mLayerCount = 0;
+  mColumns = 0;
+  mRows = 0;
+}
+
+void PostProBatch::GetTileOrigin(u32 layer, s32& x, s32& y) const
+{
+  x = (layer % mColumns) * (mWidth + 2 * mGutter) + mGutter;
+  y = (layer / mColumns) * (mHeight + 2 * mGutter) + mGutter;
+}
+
+/*****************************************************************************/
+/*!
+Effects run one after the other, so their reaches add up. Some reach further
+the larger the render rect is, and the render rect grows with the gutter, so
+the sum is taken again until the gutter covers it
+*/
+/*****************************************************************************/
+s32 PostProBatch::GetGutter(const std::vector<PostProEffect*>& effects, s32 width, s32 height, u32 columns, u32 rows)
+{
+  s32 gutter = 0;
+
+  for (u32 i = 0; i < 4; ++i)
+  {
+    s32 usedWidth = columns * (width + 2 * gutter);
+    s32 usedHeight = rows * (height + 2 * gutter);
+
+    s32 reach = 0;
+    std::vector<PostProEffect*>::const_iterator ite = effects.begin();
+    while (ite != effects.end())
+    {
+      reach += (*ite)->GetSampleReach(usedWidth, usedHeight);
+      ++ite;
+    }
+
+    if (reach <= gutter)
+    {
+      break;
+    }
+    gutter = reach;
+  }
+
+  return gutter;
+}
@@ -0,0 +1,112 @@
+/******************************************************************************/
+/*!
+\file   PostProBatch.h
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Lays the layers of a texture array out as tiles of one target, so the effect
+stack runs once for all of them
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+#ifndef POSTPROBATCH_H
+#define POSTPROBATCH_H
+
+/*****************************************************************************/
+/*!
+  Includes (Only include if required! Forward declare if you can!)
+*/
+/*****************************************************************************/
+#include "RenderTargetPool.h"
+
+/*****************************************************************************/
+/*!
+  Forward Declarations
+*/
+/*****************************************************************************/
+namespace wfe
+{
+  class RenderBuffer;
+  class Shader;
+}
+
+//The layers go into a grid of tiles starting at the lower left of the atlas.
+//Every tile is surrounded by a gutter holding copies of its edge texels, so
+//effects that read neighbours see the same clamped edges they would see on
+//a single image, as long as they read no further than the gutter is wide.
+//The gutter is as wide as the stack reaches. Every pass of the stack then
+//draws all layers with one quad
+class PostProBatch
+{
+public:
+  //////////////////////////////////////////////////////////////////////////
+  //Ctors
+  PostProBatch();
+  ~PostProBatch();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Member functions
+  //Makes room for layerCount images of width x height, with a gutter as wide
+  //as effects reach, and returns the atlas, or 0 if they do not fit into a texture
+  wfe::RenderBuffer* Reserve(s32 width, s32 height, u32 layerCount, const std::vector<PostProEffect*>& effects);
+  //Copies the layers of the GL_TEXTURE_2D_ARRAY images into their tiles with one instanced draw
+  void Gather(GLuint images);
+  //Copies the tiles of the stack's output into the layers of the GL_TEXTURE_2D_ARRAY results
+  void Scatter(wfe::RenderBuffer* output, GLuint results);
+  //Hands the atlas back to the pool
+  void Clear();
+
+  //Lower left corner of the layer's image inside the atlas and the output, in pixels
+  void GetTileOrigin(u32 layer, s32& x, s32& y) const;
+
+  //////////////////////////////////////////////////////////////////////////
+  //Getters (Implement simple ones here)
+  wfe::RenderBuffer* GetAtlas() const { return mAtlas; }
+  //Goes up whenever Reserve acquires a new atlas. The pool can hand out a new
+  //buffer at the address of the old one, so compare this instead of the pointer
+  u32 GetAtlasGeneration() const { return mAtlasGeneration; }
+  //Result of the last batch. Only valid until the stack runs again
+  wfe::RenderBuffer* GetOutput() const { return mOutput; }
+  u32 GetLayerCount() const { return mLayerCount; }
+  s32 GetImageWidth() const { return mWidth; }
+  s32 GetImageHeight() const { return mHeight; }
+  s32 GetGutter() const { return mGutter; }
+  //Part of the atlas covered by tiles, the render rect of the stack
+  s32 GetUsedWidth() const { return mColumns * (mWidth + 2 * mGutter); }
+  s32 GetUsedHeight() const { return mRows * (mHeight + 2 * mGutter); }
+
+  //////////////////////////////////////////////////////////////////////////
+  //Setters (Implement simple ones here)
+  void SetOutput(wfe::RenderBuffer* output) { mOutput = output; }
+
+  //Size of the tile array in BatchGather.vs
+  static const u32 sMaxLayers = 16;
+
+private:
+  //////////////////////////////////////////////////////////////////////////
+  //Private member functions (functions for internal class use only)
+  //Sum of the reaches of effects over the atlas of columns x rows tiles
+  static s32 GetGutter(const std::vector<PostProEffect*>& effects, s32 width, s32 height, u32 columns, u32 rows);
+
+  //////////////////////////////////////////////////////////////////////////
+  //Private member data
+  wfe::RenderBuffer* mAtlas;
+  wfe::RenderBuffer* mOutput;
+  RenderTargetFormat mFormat;
+  s32 mWidth;
+  s32 mHeight;
+  s32 mGutter; //In pixels, around every tile
+  u32 mLayerCount;
+  u32 mColumns;
+  u32 mRows;
+  u32 mAtlasGeneration;
+
+  wfe::Shader* mShader;
+  GLuint mCornerBuffer;
+  GLuint mSampler;
+  GLuint mLayerFramebuffer;
+  GLint mCornerAttrib;
+}; // class PostProBatch
+
+#endif // POSTPROBATCH_H
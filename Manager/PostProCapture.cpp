@@ -0,0 +1,352 @@
+/******************************************************************************/
+/*!
+\file   PostProCapture.cpp
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Captures the post processed frames to a numbered PNG sequence. Frames come
+back through a ring of pixel buffers and are written by a pool of worker
+threads, so the render thread never waits on the GPU or the disk
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+
+/*****************************************************************************/
+/*!
+Includes
+*/
+/*****************************************************************************/
+#include "Precompiled.h" //Precompiled header
+#include "RenderBuffer.h"
+
+#include "PostProCapture.h" //Own header
+
+#include <fstream>
+#include <iomanip>
+
+/*****************************************************************************/
+/*!
+Use the engine namespace, for convenience
+*/
+/*****************************************************************************/
+using namespace wfe;
+
+/*****************************************************************************/
+/*!
+PNG writing. The image data goes into stored (uncompressed) deflate blocks,
+which needs no zlib and costs little more than a copy. Compression would
+make the workers, not the disk, the bottleneck
+*/
+/*****************************************************************************/
+static const u32* GetCRCTable()
+{
+  static u32 table[256];
+  static b8 built = false;
+
+  if (!built)
+  {
+    for (u32 n = 0; n < 256; ++n)
+    {
+      u32 c = n;
+      for (u32 k = 0; k < 8; ++k)
+      {
+        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      }
+      table[n] = c;
+    }
+    built = true;
+  }
+
+  return table;
+}
+
+static void PushU32(std::vector<u8>& out, u32 value)
+{
+  out.push_back(static_cast<u8>(value >> 24));
+  out.push_back(static_cast<u8>(value >> 16));
+  out.push_back(static_cast<u8>(value >> 8));
+  out.push_back(static_cast<u8>(value));
+}
+
+static void WriteChunk(std::ofstream& file, cstr type, const std::vector<u8>& data)
+{
+  const u32* crcTable = GetCRCTable();
+  std::vector<u8> chunk;
+  chunk.reserve(data.size() + 12);
+
+  PushU32(chunk, data.size());
+  chunk.insert(chunk.end(), type, type + 4);
+  chunk.insert(chunk.end(), data.begin(), data.end());
+
+  //CRC covers the type and the data
+  u32 crc = 0xFFFFFFFFu;
+  for (u32 i = 4; i < chunk.size(); ++i)
+  {
+    crc = crcTable[(crc ^ chunk[i]) & 0xFF] ^ (crc >> 8);
+  }
+  PushU32(chunk, crc ^ 0xFFFFFFFFu);
+
+  file.write(reinterpret_cast<const char*>(&chunk[0]), chunk.size());
+}
+
+static b8 WritePNG(const std::string& path, const u8* rgba, s32 width, s32 height)
+{
+  std::ofstream file(path.c_str(), std::ios::binary);
+  if (!file)
+  {
+    return false;
+  }
+
+  static const u8 signature[8] = { 137, 'P', 'N', 'G', '\r', '\n', 26, '\n' };
+  file.write(reinterpret_cast<const char*>(signature), 8);
+
+  std::vector<u8> header;
+  PushU32(header, width);
+  PushU32(header, height);
+  header.push_back(8); //Bit depth
+  header.push_back(2); //RGB
+  header.push_back(0); //Deflate
+  header.push_back(0); //Adaptive filtering
+  header.push_back(0); //No interlace
+  WriteChunk(file, "IHDR", header);
+
+  //Rows top first, each with filter type 0, alpha dropped
+  u32 rowSize = width * 3 + 1;
+  std::vector<u8> raw(rowSize * height);
+  for (s32 y = 0; y < height; ++y)
+  {
+    const u8* src = rgba + (height - 1 - y) * width * 4;
+    u8* dst = &raw[y * rowSize];
+    *dst++ = 0;
+
+    for (s32 x = 0; x < width; ++x)
+    {
+      *dst++ = src[0];
+      *dst++ = src[1];
+      *dst++ = src[2];
+      src += 4;
+    }
+  }
+
+  //zlib stream of stored blocks
+  std::vector<u8> data;
+  data.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+  data.push_back(0x78);
+  data.push_back(0x01);
+
+  u32 adlerA = 1;
+  u32 adlerB = 0;
+  u32 offset = 0;
+  do
+  {
+    u32 length = std::min<u32>(raw.size() - offset, 65535);
+    b8 last = offset + length == raw.size();
+
+    data.push_back(last ? 1 : 0);
+    data.push_back(static_cast<u8>(length));
+    data.push_back(static_cast<u8>(length >> 8));
+    data.push_back(static_cast<u8>(~length));
+    data.push_back(static_cast<u8>(~length >> 8));
+    data.insert(data.end(), raw.begin() + offset, raw.begin() + offset + length);
+
+    for (u32 i = offset; i < offset + length; ++i)
+    {
+      adlerA = (adlerA + raw[i]) % 65521;
+      adlerB = (adlerB + adlerA) % 65521;
+    }
+
+    offset += length;
+  } while (offset < raw.size());
+
+  PushU32(data, (adlerB << 16) | adlerA);
+  WriteChunk(file, "IDAT", data);
+  WriteChunk(file, "IEND", std::vector<u8>());
+
+  return file.good();
+}
+
+PostProCapture::PostProCapture() : mCapturing(false), mFrameIndex(0), mDropped(0), mSession(0)
+{
+  //Built before any worker can race on it
+  GetCRCTable();
+}
+
+PostProCapture::~PostProCapture()
+{
+  RetireSession();
+  JoinRetired(true);
+}
+
+void PostProCapture::Start(const std::string& directory, u32 workerCount)
+{
+  //Workers of an earlier capture still write to the old directory. Its reads
+  //still in flight would be numbered into the new one, drop them
+  RetireSession();
+  mReadback.Clear();
+
+  mSession = new Session;
+  mSession->mDirectory = directory;
+  mFrameIndex = 0;
+  mDropped = 0;
+  mCapturing = true;
+
+  StartWorkers(mSession, std::max<u32>(workerCount, 1));
+}
+
+void PostProCapture::Stop()
+{
+  mCapturing = false;
+}
+
+/*****************************************************************************/
+/*!
+Picks up the frames whose copy finished and starts the read of this frame.
+A frame is dropped instead of waiting when all pixel buffers are busy or
+the workers are too far behind
+*/
+/*****************************************************************************/
+void PostProCapture::Update(RenderBuffer* output, s32 width, s32 height)
+{
+  while (mReadback.GetPendingCount())
+  {
+    Frame* frame = new Frame;
+    if (!mReadback.Poll(frame->mPixels, frame->mWidth, frame->mHeight, frame->mIndex))
+    {
+      delete frame;
+      break;
+    }
+
+    std::unique_lock<std::mutex> lock(mSession->mFramesMutex);
+    if (mSession->mFrames.size() >= sMaxQueuedFrames)
+    {
+      ++mDropped;
+      delete frame;
+      continue;
+    }
+
+    mSession->mFrames.push_back(frame);
+    mSession->mFrameQueued.notify_one();
+  }
+
+  //The logger is not for worker threads
+  if (mSession)
+  {
+    ReportFailures(mSession);
+  }
+  JoinRetired(false);
+
+  if (!mCapturing)
+  {
+    return;
+  }
+
+  //Every captured frame takes a number, a dropped one leaves a gap
+  if (!mReadback.Read(output, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 4, mFrameIndex++))
+  {
+    ++mDropped;
+  }
+}
+
+void PostProCapture::StartWorkers(Session* session, u32 count)
+{
+  session->mRunning = count;
+
+  for (u32 i = 0; i < count; ++i)
+  {
+    session->mWorkers.push_back(std::thread(&PostProCapture::WorkerLoop, session));
+  }
+}
+
+void PostProCapture::RetireSession()
+{
+  if (!mSession)
+  {
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mSession->mFramesMutex);
+    mSession->mQuit = true;
+    mSession->mFrameQueued.notify_all();
+  }
+
+  mRetired.push_back(mSession);
+  mSession = 0;
+}
+
+void PostProCapture::JoinRetired(b8 wait)
+{
+  std::vector<Session*>::iterator ite = mRetired.begin();
+  while (ite != mRetired.end())
+  {
+    Session* session = *ite;
+
+    //Workers finish the queue before they leave
+    if (!wait)
+    {
+      std::unique_lock<std::mutex> lock(session->mFramesMutex);
+      if (session->mRunning)
+      {
+        ++ite;
+        continue;
+      }
+    }
+
+    std::vector<std::thread>::iterator worker = session->mWorkers.begin();
+    while (worker != session->mWorkers.end())
+    {
+      worker->join();
+      ++worker;
+    }
+
+    ReportFailures(session);
+    delete session;
+    ite = mRetired.erase(ite);
+  }
+}
+
+void PostProCapture::ReportFailures(Session* session)
+{
+  std::unique_lock<std::mutex> lock(session->mFramesMutex);
+  if (session->mFailed != session->mReportedFailed)
+  {
+    WFE_LOGGER_POPUP << "Frame capture could not write " << session->mFailed - session->mReportedFailed << " frames to " << session->mDirectory << std::endl;
+    session->mReportedFailed = session->mFailed;
+  }
+}
+
+void PostProCapture::WorkerLoop(Session* session)
+{
+  for (;;)
+  {
+    Frame* frame = 0;
+    {
+      std::unique_lock<std::mutex> lock(session->mFramesMutex);
+      while (session->mFrames.empty() && !session->mQuit)
+      {
+        session->mFrameQueued.wait(lock);
+      }
+
+      if (session->mFrames.empty())
+      {
+        --session->mRunning;
+        return;
+      }
+
+      frame = session->mFrames.front();
+      session->mFrames.pop_front();
+    }
+
+    std::stringstream path;
+    path << session->mDirectory << "/frame_" << std::setw(6) << std::setfill('0') << frame->mIndex << ".png";
+
+    if (!WritePNG(path.str(), &frame->mPixels[0], frame->mWidth, frame->mHeight))
+    {
+      std::unique_lock<std::mutex> lock(session->mFramesMutex);
+      ++session->mFailed;
+    }
+
+    delete frame;
+  }
+}
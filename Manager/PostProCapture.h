@@ -0,0 +1,121 @@
+/******************************************************************************/
+/*!
+\file   PostProCapture.h
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Captures the post processed frames to a numbered PNG sequence. Frames come
+back through a ring of pixel buffers and are written by a pool of worker
+threads, so the render thread never waits on the GPU or the disk
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+#ifndef POSTPROCAPTURE_H
+#define POSTPROCAPTURE_H
+
+/*****************************************************************************/
+/*!
+  Includes (Only include if required! Forward declare if you can!)
+*/
+/*****************************************************************************/
+#include "PostProReadback.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+/*****************************************************************************/
+/*!
+  Forward Declarations
+*/
+/*****************************************************************************/
+namespace wfe
+{
+  class RenderBuffer;
+}
+
+class PostProCapture
+{
+public:
+  //////////////////////////////////////////////////////////////////////////
+  //Ctors
+  PostProCapture();
+  ~PostProCapture();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Member functions
+
+  //Writes every following frame to directory/frame_000000.png and so on.
+  //The directory has to exist
+  void Start(const std::string& directory, u32 workerCount);
+  //No new frames are read. Frames already on their way are still written
+  void Stop();
+
+  //Call once per frame with the final image, whether capturing or not, so
+  //reads started earlier get picked up
+  void Update(wfe::RenderBuffer* output, s32 width, s32 height);
+
+  //////////////////////////////////////////////////////////////////////////
+  //Getters (Implement simple ones here)
+  b8 IsCapturing() const { return mCapturing; }
+  //Frames skipped because the GPU or the disk fell behind. Their numbers
+  //are left out of the sequence, so the timing of the rest stays right
+  u32 GetDroppedCount() const { return mDropped; }
+
+  //////////////////////////////////////////////////////////////////////////
+  //Frames waiting for a worker at most, before new ones are dropped
+  static const u32 sMaxQueuedFrames = 16;
+
+private:
+  //////////////////////////////////////////////////////////////////////////
+  //Private types
+  struct Frame
+  {
+    std::vector<u8> mPixels; //RGBA, bottom row first
+    s32 mWidth;
+    s32 mHeight;
+    u32 mIndex;
+  };
+
+  //Everything the workers of one capture share. A restarted capture gets a
+  //new one, the old workers finish their queue on their own and are joined
+  //once they are done, so the render thread never waits for the disk
+  struct Session
+  {
+    Session() : mFailed(0), mReportedFailed(0), mRunning(0), mQuit(false) {}
+
+    std::string mDirectory;
+    std::vector<std::thread> mWorkers;
+    std::deque<Frame*> mFrames;
+    std::mutex mFramesMutex;
+    std::condition_variable mFrameQueued;
+    u32 mFailed; //Written by the workers, guarded by mFramesMutex
+    u32 mReportedFailed;
+    u32 mRunning; //Workers that haven't returned yet, guarded by mFramesMutex
+    b8 mQuit;
+  };
+
+  //////////////////////////////////////////////////////////////////////////
+  //Private member functions (functions for internal class use only)
+  void StartWorkers(Session* session, u32 count);
+  //Lets the workers run out of frames and moves the session to mRetired
+  void RetireSession();
+  //Joins retired workers. Only waits for them when wait is set
+  void JoinRetired(b8 wait);
+  void ReportFailures(Session* session);
+  static void WorkerLoop(Session* session);
+
+  //////////////////////////////////////////////////////////////////////////
+  //Private member data
+  PostProReadback mReadback;
+  b8 mCapturing;
+  u32 mFrameIndex;
+  u32 mDropped;
+
+  Session* mSession; //0 until the first capture
+  std::vector<Session*> mRetired;
+}; // class PostProCapture
+
+#endif // POSTPROCAPTURE_H
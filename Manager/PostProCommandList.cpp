@@ -0,0 +1,207 @@
+/******************************************************************************/
+/*!
+\file   PostProCommandList.cpp
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Flat list of recorded post processing passes, replayed every frame
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+
+/*****************************************************************************/
+/*!
+Includes
+*/
+/*****************************************************************************/
+#include "Precompiled.h" //Precompiled header
+#include "RenderBuffer.h"
+#include "GraphicsManager.h"
+#include "ShaderManager.h"
+#include "PostProEffect.h"
+#include "PostProStateCache.h"
+#include "PostProcessingManager.h"
+
+#include "PostProCommandList.h" //Own header
+
+/*****************************************************************************/
+/*!
+Use the engine namespace, for convenience
+*/
+/*****************************************************************************/
+using namespace wfe;
+
+PostProCommandList::PostProCommandList() : mOutput(0)
+{
+}
+
+void PostProCommandList::Clear()
+{
+  mPasses.clear();
+  mTextures.clear();
+  mUniforms.clear();
+  mOutput = 0;
+}
+
+void PostProCommandList::BeginPass(Shader* shader, RenderBuffer* target, GLuint program)
+{
+  PostProPass pass;
+  pass.mEffect = 0;
+  pass.mSource = 0;
+  pass.mShader = shader;
+  pass.mProgram = program;
+  pass.mTarget = target;
+  pass.mTextureOffset = mTextures.size();
+  pass.mTextureCount = 0;
+  pass.mUniformOffset = mUniforms.size();
+  pass.mUniformCount = 0;
+
+  mPasses.push_back(pass);
+}
+
+void PostProCommandList::AbortPass()
+{
+  ASSERT(!mPasses.empty());
+
+  mTextures.resize(mPasses.back().mTextureOffset);
+  mUniforms.resize(mPasses.back().mUniformOffset);
+  mPasses.pop_back();
+}
+
+void PostProCommandList::AddEffectPass(PostProEffect* effect, RenderBuffer* source, RenderBuffer* dest)
+{
+  BeginPass(0, dest);
+  mPasses.back().mEffect = effect;
+  mPasses.back().mSource = source;
+}
+
+void PostProCommandList::AddTexture(GLuint handle, s32 mapType)
+{
+  PostProTextureBinding binding = { handle, mapType };
+  mTextures.push_back(binding);
+  ++mPasses.back().mTextureCount;
+}
+
+void PostProCommandList::AddUniform(GLint location, const f32* source)
+{
+  PostProUniform uniform = { location, POSTPRO_UNIFORM_FLOAT, source };
+  mUniforms.push_back(uniform);
+  ++mPasses.back().mUniformCount;
+}
+
+void PostProCommandList::AddUniform(GLint location, const s32* source)
+{
+  PostProUniform uniform = { location, POSTPRO_UNIFORM_INT, source };
+  mUniforms.push_back(uniform);
+  ++mPasses.back().mUniformCount;
+}
+
+void PostProCommandList::AddUniform(GLint location, const b8* source)
+{
+  PostProUniform uniform = { location, POSTPRO_UNIFORM_BOOL, source };
+  mUniforms.push_back(uniform);
+  ++mPasses.back().mUniformCount;
+}
+
+void PostProCommandList::AddUniform(GLint location, f32 value)
+{
+  PostProUniform uniform = { location, POSTPRO_UNIFORM_FLOAT, 0, { value, 0.f } };
+  mUniforms.push_back(uniform);
+  ++mPasses.back().mUniformCount;
+}
+
+void PostProCommandList::AddUniformInt(GLint location, s32 value)
+{
+  PostProUniform uniform = { location, POSTPRO_UNIFORM_INT, 0, { 0.f, 0.f }, value };
+  mUniforms.push_back(uniform);
+  ++mPasses.back().mUniformCount;
+}
+
+void PostProCommandList::AddUniform2(GLint location, f32 x, f32 y)
+{
+  PostProUniform uniform = { location, POSTPRO_UNIFORM_VEC2, 0, { x, y } };
+  mUniforms.push_back(uniform);
+  ++mPasses.back().mUniformCount;
+}
+
+void PostProCommandList::AddUniform2(GLint location, const f32* source)
+{
+  PostProUniform uniform = { location, POSTPRO_UNIFORM_VEC2, source };
+  mUniforms.push_back(uniform);
+  ++mPasses.back().mUniformCount;
+}
+
+/*****************************************************************************/
+/*!
+Replays the recorded passes. No virtual calls or name lookups are done here
+except for the passes of effects that could not be recorded
+*/
+/*****************************************************************************/
+void PostProCommandList::Replay() const
+{
+  PostProStateCache* state = PostProcessingManager::sStateCache;
+
+  std::vector<PostProPass>::const_iterator ite = mPasses.begin();
+  while (ite != mPasses.end())
+  {
+    const PostProPass& pass = *ite;
+    ++ite;
+
+    if (pass.mEffect)
+    {
+      RenderBuffer* source = pass.mSource;
+      RenderBuffer* dest = pass.mTarget;
+      pass.mEffect->Apply(source, dest);
+
+      //Effects may touch any state they like
+      state->Invalidate();
+      continue;
+    }
+
+    state->SetCombineBlending(POSTPRO_CM_REPLACE);
+    state->ClearTarget(pass.mTarget);
+    state->SwitchShader(pass.mShader, pass.mProgram);
+
+    for (u32 i = 0; i < pass.mTextureCount; ++i)
+    {
+      const PostProTextureBinding& binding = mTextures[pass.mTextureOffset + i];
+      state->EnableTexture(binding.mHandle, binding.mMapType);
+    }
+
+    for (u32 i = 0; i < pass.mUniformCount; ++i)
+    {
+      ApplyUniform(mUniforms[pass.mUniformOffset + i]);
+    }
+
+    state->DrawOverScreen();
+  }
+}
+
+void PostProCommandList::ApplyUniform(const PostProUniform& uniform) const
+{
+  switch (uniform.mType)
+  {
+  case POSTPRO_UNIFORM_FLOAT:
+    glUniform1f(uniform.mLocation, uniform.mSource ? *static_cast<const f32*>(uniform.mSource) : uniform.mValue[0]);
+    break;
+  case POSTPRO_UNIFORM_INT:
+    glUniform1i(uniform.mLocation, uniform.mSource ? *static_cast<const s32*>(uniform.mSource) : uniform.mIntValue);
+    break;
+  case POSTPRO_UNIFORM_BOOL:
+    glUniform1i(uniform.mLocation, *static_cast<const b8*>(uniform.mSource));
+    break;
+  case POSTPRO_UNIFORM_VEC2:
+    if (uniform.mSource)
+    {
+      glUniform2fv(uniform.mLocation, 1, static_cast<const f32*>(uniform.mSource));
+    }
+    else
+    {
+      glUniform2f(uniform.mLocation, uniform.mValue[0], uniform.mValue[1]);
+    }
+    break;
+  default:
+    ASSERT(false);
+  }
+}
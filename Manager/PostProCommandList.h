@@ -0,0 +1,125 @@
+/******************************************************************************/
+/*!
+\file   PostProCommandList.h
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Flat list of recorded post processing passes, replayed every frame
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+#ifndef POSTPROCOMMANDLIST_H
+#define POSTPROCOMMANDLIST_H
+
+/*****************************************************************************/
+/*!
+  Forward Declarations
+*/
+/*****************************************************************************/
+namespace wfe
+{
+  class RenderBuffer;
+  class Shader;
+}
+
+class PostProEffect;
+
+/*****************************************************************************/
+/*!
+  Type Declarations (Types that are associated with this class declared here)
+*/
+/*****************************************************************************/
+enum PostProUniformType
+{
+  POSTPRO_UNIFORM_FLOAT,
+  POSTPRO_UNIFORM_INT,
+  POSTPRO_UNIFORM_BOOL,
+  POSTPRO_UNIFORM_VEC2,
+  POSTPRO_UNIFORM_NUM
+};
+
+//A uniform either reads its value from mSource at replay time (so tweak bar
+//edits show up without re-recording) or uses the value captured when recorded
+struct PostProUniform
+{
+  GLint mLocation;
+  PostProUniformType mType;
+  const void* mSource;
+  f32 mValue[2];
+  s32 mIntValue;
+};
+
+struct PostProTextureBinding
+{
+  GLuint mHandle;
+  s32 mMapType; //wfe::Shader::WFE_SHADER_MAPTYPE_*
+};
+
+struct PostProPass
+{
+  //Set for effects that cannot be recorded. The effect's Apply is called instead
+  PostProEffect* mEffect;
+  wfe::RenderBuffer* mSource;
+
+  wfe::Shader* mShader;
+  GLuint mProgram; //Variant of mShader, 0 for its own program
+  wfe::RenderBuffer* mTarget;
+  u32 mTextureOffset;
+  u32 mTextureCount;
+  u32 mUniformOffset;
+  u32 mUniformCount;
+};
+
+class PostProCommandList
+{
+public:
+  //////////////////////////////////////////////////////////////////////////
+  //Ctors
+  PostProCommandList();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Member functions
+  void Clear();
+
+  //Recording. Textures and uniforms go to the pass begun last
+  //Passes always overwrite their target, combine modes are done in the shaders
+  void BeginPass(wfe::Shader* shader, wfe::RenderBuffer* target, GLuint program = 0);
+  void AbortPass();
+  void AddEffectPass(PostProEffect* effect, wfe::RenderBuffer* source, wfe::RenderBuffer* dest);
+  void AddTexture(GLuint handle, s32 mapType);
+  void AddUniform(GLint location, const f32* source);
+  void AddUniform(GLint location, const s32* source);
+  void AddUniform(GLint location, const b8* source);
+  void AddUniform(GLint location, f32 value);
+  void AddUniformInt(GLint location, s32 value);
+  void AddUniform2(GLint location, f32 x, f32 y);
+  void AddUniform2(GLint location, const f32* source);
+
+  //Runs every recorded pass in order
+  void Replay() const;
+
+  //////////////////////////////////////////////////////////////////////////
+  //Getters (Implement simple ones here)
+  b8 IsEmpty() const { return mPasses.empty(); }
+  u32 GetPassCount() const { return mPasses.size(); }
+  wfe::RenderBuffer* GetOutput() const { return mOutput; }
+
+  //////////////////////////////////////////////////////////////////////////
+  //Setters (Implement simple ones here)
+  void SetOutput(wfe::RenderBuffer* output) { mOutput = output; }
+
+private:
+  //////////////////////////////////////////////////////////////////////////
+  //Private member functions (functions for internal class use only)
+  void ApplyUniform(const PostProUniform& uniform) const;
+
+  //////////////////////////////////////////////////////////////////////////
+  //Private member data
+  std::vector<PostProPass> mPasses;
+  std::vector<PostProTextureBinding> mTextures;
+  std::vector<PostProUniform> mUniforms;
+  wfe::RenderBuffer* mOutput;
+}; // class PostProCommandList
+
+#endif // POSTPROCOMMANDLIST_H
@@ -0,0 +1,148 @@
+/******************************************************************************/
+/*!
+\file   PostProDepthMask.cpp
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Stencil mask of the pixels whose depth lies within a range, so effects that
+only touch part of the scene can skip the rest before shading
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+
+/*****************************************************************************/
+/*!
+Includes
+*/
+/*****************************************************************************/
+#include "Precompiled.h" //Precompiled header
+#include "RenderBuffer.h"
+#include "GraphicsManager.h"
+#include "ShaderManager.h"
+#include "PostProEffect.h"
+#include "PostProStateCache.h"
+#include "PostProcessingManager.h"
+
+#include "PostProDepthMask.h" //Own header
+
+/*****************************************************************************/
+/*!
+Use the engine namespace, for convenience
+*/
+/*****************************************************************************/
+using namespace wfe;
+
+PostProDepthMask::PostProDepthMask() : mStencilBuffer(0), mWidth(0), mHeight(0), mReportedIncomplete(false)
+{
+  mShader = &WFE_SHADER_MANAGER->GetResource("DepthMask.xml");
+}
+
+PostProDepthMask::~PostProDepthMask()
+{
+  if (mStencilBuffer)
+  {
+    glDeleteRenderbuffers(1, &mStencilBuffer);
+  }
+}
+
+/*****************************************************************************/
+/*!
+The mask pass only reads the depth texture and writes stencil, which is far
+cheaper than running the effect shader and branching on depth in there
+*/
+/*****************************************************************************/
+b8 PostProDepthMask::Begin(RenderBuffer* target, RenderBuffer* source, const PostProDepthMaskRange& range)
+{
+  PostProStateCache* state = PostProcessingManager::sStateCache;
+  s32 width = PostProEffect::GetRenderWidth();
+  s32 height = PostProEffect::GetRenderHeight();
+
+  Reserve(target->GetWidth(), target->GetHeight());
+
+  state->Invalidate();
+  state->BindTarget(target);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, mStencilBuffer);
+
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+  {
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, 0);
+
+    if (!mReportedIncomplete)
+    {
+      WFE_LOGGER_POPUP << "Post processing depth mask can't be attached, masked effects draw every pixel" << std::endl;
+      mReportedIncomplete = true;
+    }
+    return false;
+  }
+
+  //Pixels the effect will not draw
+  if (range.mKeepSource)
+  {
+    GLint sourceFramebuffer = 0;
+    source->Bind();
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &sourceFramebuffer);
+
+    target->Bind();
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, sourceFramebuffer);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+    state->Invalidate();
+    state->BindTarget(target);
+  }
+
+  GLfloat clearColor[4];
+  glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+  glClearColor(0.f, 0.f, 0.f, 0.f);
+  glClearStencil(0);
+  glClear(range.mKeepSource ? GL_STENCIL_BUFFER_BIT : GL_STENCIL_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
+  glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+
+  //Mark the pixels in range. The shader discards the others
+  glEnable(GL_STENCIL_TEST);
+  glStencilFunc(GL_ALWAYS, 1, 0xFF);
+  glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+  glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+  state->SetCombineBlending(POSTPRO_CM_REPLACE);
+  state->SwitchShader(mShader);
+  state->EnableTexture(WFE_GRAPHICS->GetDepthAndNormalBuffer()->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_SHADOW);
+  glUniform1f(glGetUniformLocation(mShader->GetHandle(), "uMinDepth"), range.mMinDepth);
+  glUniform1f(glGetUniformLocation(mShader->GetHandle(), "uMaxDepth"), range.mMaxDepth);
+  state->DrawOverScreen();
+
+  //Only the marked pixels from here on
+  glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+  glStencilFunc(GL_EQUAL, 1, 0xFF);
+  glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+  return true;
+}
+
+void PostProDepthMask::End(RenderBuffer* target)
+{
+  PostProcessingManager::sStateCache->BindTarget(target);
+
+  glDisable(GL_STENCIL_TEST);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, 0);
+}
+
+void PostProDepthMask::Reserve(s32 width, s32 height)
+{
+  if (mStencilBuffer && width == mWidth && height == mHeight)
+  {
+    return;
+  }
+
+  if (!mStencilBuffer)
+  {
+    glGenRenderbuffers(1, &mStencilBuffer);
+  }
+
+  //Attachments must all be the same size on older drivers
+  mWidth = width;
+  mHeight = height;
+
+  glBindRenderbuffer(GL_RENDERBUFFER, mStencilBuffer);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, mWidth, mHeight);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+}
@@ -0,0 +1,74 @@
+/******************************************************************************/
+/*!
+\file   PostProDepthMask.h
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Stencil mask of the pixels whose depth lies within a range, so effects that
+only touch part of the scene can skip the rest before shading
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+#ifndef POSTPRODEPTHMASK_H
+#define POSTPRODEPTHMASK_H
+
+/*****************************************************************************/
+/*!
+  Forward Declarations
+*/
+/*****************************************************************************/
+namespace wfe
+{
+  class RenderBuffer;
+  class Shader;
+}
+
+/*****************************************************************************/
+/*!
+  Type Declarations (Types that are associated with this class declared here)
+*/
+/*****************************************************************************/
+struct PostProDepthMaskRange
+{
+  f32 mMinDepth;
+  f32 mMaxDepth;
+  //Masked out pixels get the source image. Otherwise they are cleared to 0
+  b8 mKeepSource;
+};
+
+class PostProDepthMask
+{
+public:
+  //////////////////////////////////////////////////////////////////////////
+  //Ctors
+  PostProDepthMask();
+  ~PostProDepthMask();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Member functions
+
+  //Attaches the stencil buffer to target, fills the masked out pixels and
+  //leaves the stencil test on so the next draws only touch pixels in range.
+  //Returns false and leaves target alone if the driver can't render to it with
+  //the stencil buffer attached, the caller draws everything then
+  b8 Begin(wfe::RenderBuffer* target, wfe::RenderBuffer* source, const PostProDepthMaskRange& range);
+  //Turns the stencil test off and detaches the stencil buffer again
+  void End(wfe::RenderBuffer* target);
+
+private:
+  //////////////////////////////////////////////////////////////////////////
+  //Private member functions (functions for internal class use only)
+  void Reserve(s32 width, s32 height);
+
+  //////////////////////////////////////////////////////////////////////////
+  //Private member data
+  //Packed depth and stencil, stencil only buffers are not supported everywhere
+  GLuint mStencilBuffer;
+  s32 mWidth;
+  s32 mHeight;
+  b8 mReportedIncomplete;
+  wfe::Shader* mShader;
+}; // class PostProDepthMask
+
+#endif // POSTPRODEPTHMASK_H
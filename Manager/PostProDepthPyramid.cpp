@@ -0,0 +1,134 @@
+/******************************************************************************/
+/*!
+\file   PostProDepthPyramid.cpp
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Chain of ever smaller depth targets holding the average, minimum and maximum
+depth below each texel, built once per frame for all effects
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+
+/*****************************************************************************/
+/*!
+Includes
+*/
+/*****************************************************************************/
+#include "Precompiled.h" //Precompiled header
+#include "RenderBuffer.h"
+#include "GraphicsManager.h"
+#include "ShaderManager.h"
+#include "RenderTargetPool.h"
+#include "PostProEffect.h"
+#include "PostProStateCache.h"
+#include "PostProcessingManager.h"
+
+#include "PostProDepthPyramid.h" //Own header
+
+/*****************************************************************************/
+/*!
+Use the engine namespace, for convenience
+*/
+/*****************************************************************************/
+using namespace wfe;
+
+PostProDepthPyramid::PostProDepthPyramid() : mWidth(0), mHeight(0)
+{
+  mShader = &WFE_SHADER_MANAGER->GetResource("DepthPyramid.xml");
+}
+
+PostProDepthPyramid::~PostProDepthPyramid()
+{
+  Clear();
+}
+
+/*****************************************************************************/
+/*!
+Every level reads the one before it, the first one reads the depth buffer.
+Odd sizes fold the extra row and column into the last texel, so no depth
+is ever skipped by the minimum and maximum
+*/
+/*****************************************************************************/
+void PostProDepthPyramid::Build()
+{
+  PostProStateCache* state = PostProcessingManager::sStateCache;
+  RenderBuffer* depth = WFE_GRAPHICS->GetDepthAndNormalBuffer();
+  Reserve(depth->GetWidth(), depth->GetHeight());
+
+  state->SetCombineBlending(POSTPRO_CM_REPLACE);
+  state->SwitchShader(mShader);
+  GLint sourceSizeHandle = glGetUniformLocation(mShader->GetHandle(), "uSourceSize");
+  GLint firstLevelHandle = glGetUniformLocation(mShader->GetHandle(), "uFirstLevel");
+
+  RenderBuffer* source = depth;
+  std::vector<RenderBuffer*>::iterator ite = mLevels.begin();
+  while (ite != mLevels.end())
+  {
+    RenderBuffer* level = *ite;
+    ++ite;
+
+    state->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+    glUniform2f(sourceSizeHandle, static_cast<f32>(source->GetWidth()), static_cast<f32>(source->GetHeight()));
+    glUniform1i(firstLevelHandle, source == depth);
+
+    level->Bind();
+    glViewport(0, 0, level->GetWidth(), level->GetHeight());
+    WFE_GRAPHICS->DrawOverScreen();
+
+    source = level;
+  }
+
+  //The levels are smaller than the render rect, so they were bound behind the cache's back
+  state->Invalidate();
+}
+
+void PostProDepthPyramid::Clear()
+{
+  std::vector<RenderBuffer*>::iterator ite = mLevels.begin();
+  while (ite != mLevels.end())
+  {
+    PostProcessingManager::sRenderTargetPool->Release(*ite);
+    ++ite;
+  }
+
+  mLevels.clear();
+  mWidth = 0;
+  mHeight = 0;
+}
+
+u32 PostProDepthPyramid::GetLevelForSize(f32 pixels) const
+{
+  //Level n texels cover 2^(n+1) depth buffer pixels
+  u32 level = 0;
+  while (level + 1 < mLevels.size() && static_cast<f32>(4 << level) <= pixels)
+  {
+    ++level;
+  }
+
+  return level;
+}
+
+void PostProDepthPyramid::Reserve(s32 width, s32 height)
+{
+  if (!mLevels.empty() && width == mWidth && height == mHeight)
+  {
+    return;
+  }
+
+  Clear();
+  mWidth = width;
+  mHeight = height;
+
+  do
+  {
+    width = std::max(1, width / 2);
+    height = std::max(1, height / 2);
+
+    //Nonlinear depth crowds into the last few thousandths near 1, half floats
+    //only keep about 0.0005 steps there and would flatten everything past the
+    //first meters into a handful of values
+    mLevels.push_back(PostProcessingManager::sRenderTargetPool->Acquire(width, height, RT_FORMAT_RGBA32F, 0));
+  } while (width > 1 || height > 1);
+}
@@ -0,0 +1,69 @@
+/******************************************************************************/
+/*!
+\file   PostProDepthPyramid.h
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Chain of ever smaller depth targets holding the average, minimum and maximum
+depth below each texel, built once per frame for all effects
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+#ifndef POSTPRODEPTHPYRAMID_H
+#define POSTPRODEPTHPYRAMID_H
+
+/*****************************************************************************/
+/*!
+  Forward Declarations
+*/
+/*****************************************************************************/
+namespace wfe
+{
+  class RenderBuffer;
+  class Shader;
+}
+
+//Level 0 is half the size of the depth buffer, every level after that half
+//the size of the one before, down to 1x1. Texels hold
+// r - average depth, so a level can stand in for a blurred depth buffer
+// g - minimum depth
+// b - maximum depth
+//Like the depth buffer, every level covers the whole view
+class PostProDepthPyramid
+{
+public:
+  //////////////////////////////////////////////////////////////////////////
+  //Ctors
+  PostProDepthPyramid();
+  ~PostProDepthPyramid();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Member functions
+  //Reduces the current depth buffer. Call before the effects run
+  void Build();
+  //Hands all levels back to the pool
+  void Clear();
+
+  //Coarsest level whose texels are no wider than pixels depth buffer pixels
+  u32 GetLevelForSize(f32 pixels) const;
+
+  //////////////////////////////////////////////////////////////////////////
+  //Getters (Implement simple ones here)
+  u32 GetLevelCount() const { return mLevels.size(); }
+  wfe::RenderBuffer* GetLevel(u32 level) const { return mLevels[std::min<u32>(level, mLevels.size() - 1)]; }
+
+private:
+  //////////////////////////////////////////////////////////////////////////
+  //Private member functions (functions for internal class use only)
+  void Reserve(s32 width, s32 height);
+
+  //////////////////////////////////////////////////////////////////////////
+  //Private member data
+  std::vector<wfe::RenderBuffer*> mLevels;
+  s32 mWidth;
+  s32 mHeight;
+  wfe::Shader* mShader;
+}; // class PostProDepthPyramid
+
+#endif // POSTPRODEPTHPYRAMID_H
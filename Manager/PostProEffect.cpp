@@ -1,988 +1,3068 @@
-/******************************************************************************/
-/*!
-\file   PostProEffect.cpp
-\par    email: y.li\@digipen.edu
-\par    name:  Sebastian Li Ye Wei
-\par    Project: CS370 
-\date   02/08/2013
-\brief  
-Class that performs post processing effects for the game
-
-All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
-*/
-/******************************************************************************/
-
-/*****************************************************************************/
-/*!
-Includes
-*/
-/*****************************************************************************/
-#include "Precompiled.h" //Precompiled header
-#include "RenderBuffer.h"
-#include "Window.h"
-#include "GraphicsManager.h"
-#include "ShaderManager.h"
-
-#include "PostProEffect.h" //Own header
-#include "PostProcessingManager.h"
-#include "LevelEditor.h"
-#include "GameplayState.h"
-#include "GameStateManager.h"
-#include "TextureManager.h"
-#include "Camera.h"
-
-/*****************************************************************************/
-/*!
-Use the engine namespace, for convenience
-*/
-/*****************************************************************************/
-using namespace wfe;
-
-void TW_CALL SetCombineModeCB(const void *value, void *clientData)
-{ 
-  static_cast<PostProEffect*>(clientData)->SetCombineMode(*static_cast<const PostProcessingCombineModes*>(value));
-}
-
-void TW_CALL GetCombineModeCB(void *value, void *clientData)
-{ 
-  *static_cast<s32*>(value) = static_cast<PostProEffect*>(clientData)->GetCombineMode();
-}
-
-
-PostProEffect::PostProEffect(s32 type)
-  :  mType(type), mShader(0), mCombineMode(POSTPRO_CM_REPLACE), mKeepInputImage(false)
-{  
-  //Init texture handle
-  glGenTextures(1, &mInputTextureHandle);
-  //Setup texture params
-  glBindTexture(GL_TEXTURE_2D, mInputTextureHandle);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-  glBindTexture(GL_TEXTURE_2D, 0);
-
-  mData = new u8[4 * WFE_WINDOW->GetResoWidth() * WFE_WINDOW->GetResoHeight()];
-}
-
-PostProEffect::~PostProEffect()
-{
-  delete[] mData;
-
-  while(!mPrePostProEffect.empty())
-  {
-    FactoryFree(PostProcessingManager::mPostProEffectFactoryContainer, mPrePostProEffect.back()->GetType(), mPrePostProEffect.back());
-    mPrePostProEffect.pop_back();
-  }
-}
-
-/*****************************************************************************/
-/*!
-Applies the effect using the shader and combine mode
-*/
-/*****************************************************************************/
-void PostProEffect::Apply(RenderBuffer*& source, RenderBuffer*& dest)
-{
-  if(mKeepInputImage)
-  {
-    // always keep image that was fed into this effect
-    s32 sizeX = WFE_WINDOW->GetResoWidth();
-    s32 sizeY = WFE_WINDOW->GetResoHeight();
-    // Assume we are having a clean image here
-    glReadPixels(0, 0, sizeX, sizeY, GL_RGBA, GL_UNSIGNED_BYTE, mData);
-    //Setup texture params
-    glBindTexture(GL_TEXTURE_2D, mInputTextureHandle);
-    //Allocate the texture
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, sizeX, sizeY, 0, GL_RGBA, GL_UNSIGNED_BYTE, mData);
-    glBindTexture(GL_TEXTURE_2D, 0);
-  }
-
-  PostProEffectContainerIt ite = mPrePostProEffect.begin();
-  while (ite != mPrePostProEffect.end())
-  {
-    (*ite)->Apply(source, dest);
-
-    // swap around to save memory, no reason to create tons of frame buffer 
-    // NOTE: limitation to this implementation is that every frame buffer are of the same size
-    //       this can still be solved, inform me (ES) if you need such functionality (i was lazy to implement it)
-    std::swap(source, dest);
-
-    ++ite;
-  }
-
-  if(mPrePostProEffect.size() % 2)
-  {
-    std::swap(source, dest);
-  }
-
-  PreBindUpdate(source);
-
-  //Dest buffer is not guaranteed to be cleared so we bind and clear it first
-  dest->Bind();
-  dest->Clear();
-  // if null ptr, most likely u forgot to give ur post pro effect the name of the shader file
-  ASSERT(mShader);
-
-  //Use the shader for this effect
-  WFE_GRAPHICS->SwitchShader(mShader);
-
-  //Enable the color texture for the shader
-  //You can enable other types of textures by changing the enum provided in the second argument
-  //In your shaders, your samplers are expected to be named one of the following:
-  // uColorMap
-  // uEmissiveMap
-  // uSpecularMap
-  // uNormalMap 
-  // uDissolveMap
-  // uShadowMap
-  //If you want to use a texture that is named something else you are going to have
-  //to bind the texture unit and uniform manually. The enable texture function will
-  //NOT work if you try to enable a texture that the shader does not have a
-  //corresponding sampler for (with the expected name).
-
-  EnableUniforms(source);
-
-  //This is how you would pass in a custom uniform
-  //glUniform1f(glGetUniformLocation(mShader->GetHandle(), "uMyUniformName"), 1.0f);
-
-  //Draw a fullscreen quad over the screen (assumes that view proj mtx has been set to identity)
-  //The view proj mtx should have been set in the PostProcessing class before this
-  WFE_GRAPHICS->DrawOverScreen();
-
-  //Any additional steps to apply the effect would go here.
-  //For example, for 2 pass blur, you would draw to an intermediate buffer for the 
-  //vertical pass, draw to another buffer for the horizontal pass and finally
-  //use the code below to draw the results back into the source.
-
-  //////////////////////////////////////////////////////////////////////////
-  //Combine the result back into the source buffer.
-  //Combine Modes Available:
-  // REPLACE: What the shader draws is what the effect outputs
-  // ADD: What the shader draws is added to the source image
-  // SUB: What the shader draws is subtracted from the source image
-  if (POSTPRO_CM_REPLACE != mCombineMode)
-  {
-    std::swap(source, dest);
-
-    switch(mCombineMode)
-    {
-    case POSTPRO_CM_NORMAL:
-      WFE_GRAPHICS->SwitchBlendingMode(WFE_BM_NORMAL);
-      break;
-    case POSTPRO_CM_ADD:
-      WFE_GRAPHICS->SwitchBlendingMode(WFE_BM_ADD);
-      break;
-    case POSTPRO_CM_SUB:
-      WFE_GRAPHICS->SwitchBlendingMode(WFE_BM_SUB);
-      break;
-    default:
-      ASSERT(false);
-    }
-
-    dest->Bind();
-    dest->Clear();
-
-    //Draw the results back into the buffer
-    WFE_GRAPHICS->SwitchShader(mShader);  //The SimpleAttribs shader simply draws the texture directly
-    //mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR); //Tell the shader to use the given texture
-    EnableUniforms(source);
-    WFE_GRAPHICS->DrawOverScreen();
-  }
-}
-
-void PostProEffect::EnableUniforms(RenderBuffer* source)
-{
-  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
-}
-
-void PostProEffect::CreateATBMain(u32 index)
-{
-  std::stringstream ss;
-
-  ss << "Post Processing Effect #" << index;
-  mName = ss.str();
-
-  mNameFormatted = " group='" + mName + "' ";
-
-  StringContainer stringContainer;
-
-  stringContainer.push_back("REPLACE");
-  stringContainer.push_back("NORMAL");
-  stringContainer.push_back("ADD");
-  stringContainer.push_back("SUB");
-
-  TwAddSeparator(PostProcessingManager::sStackBar, "", mNameFormatted.c_str());
-  AddDropDownVarCB(PostProcessingManager::sStackBar, 
-    EDITOR_MODE_PAUSE, 
-    "", 
-    SetCombineModeCB, 
-    GetCombineModeCB, 
-    this, 
-    ("label='Combine Mode'" + mNameFormatted).c_str(),
-    "CombineModeEnum",
-    stringContainer,
-    false);
-
-  CreateATB();
-}
-
-void PostProEffect::AddVarRW( cstr const name, TwType type, void* var, cstr const def )
-{
-  TwAddVarRW(PostProcessingManager::sStackBar, name, type, var, def);
-}
-
-void PostProEffect::PushbackPreEffects( s32 type )
-{
-  mPrePostProEffect.push_back(FactoryCreate(PostProcessingManager::mPostProEffectFactoryContainer,type));
-}
-
-Desaturation::Desaturation() : PostProEffect(sType), mSaturation(.5f)
-{  
-  mShader = &WFE_SHADER_MANAGER->GetResource("Desaturation.xml");
-
-  if(!mShader)
-  {
-    WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-  }
-}
-
-void Desaturation::CreateATB()
-{
-  AddVarRW("", TW_TYPE_FLOAT, &mSaturation, ("label='Saturation' min=0.0 max=1.0 step=0.01" + GetNameFormatted()).c_str());
-}
-
-void Desaturation::EnableUniforms(RenderBuffer* source)
-{
-  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
-  //Pass a saturation value into the shader
-  glUniform1f(mShader->GetSaturationHandle(), mSaturation);
-}
-
-SepiaTone::SepiaTone() : PostProEffect(sType)
-{  
-  mShader = &WFE_SHADER_MANAGER->GetResource("SepiaTone.xml");
-
-  if(!mShader)
-  {
-    WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-  }
-}
-
-BlurHorizontal::BlurHorizontal() : PostProEffect(sType), mHalfSize(7), mApplyNaiveDOF(false), mInvert(false), mBlurCutoff(0.3f)
-{  
-  mShader = &WFE_SHADER_MANAGER->GetResource("BlurHorizontal.xml");
-
-  if(!mShader)
-  {
-    WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-  }
-  else
-  {
-    mApplyNaiveDOFHandle = glGetUniformLocation(mShader->GetHandle(), "uNaiveDOF");
-    mBlurCutoffHandle = glGetUniformLocation(mShader->GetHandle(), "uBlurCutoff");
-    mInvertHandle = glGetUniformLocation(mShader->GetHandle(), "uInvert");
-  }
-}
-
-void BlurHorizontal::CreateATB()
-{
-  AddVarRW("", TW_TYPE_INT32, &mHalfSize, ("label='Kernel Half Size' min=1" + GetNameFormatted()).c_str());
-  AddVarRW("", TW_TYPE_BOOLCPP, &mApplyNaiveDOF, ("label='Naive DOF'" + GetNameFormatted()).c_str());
-  AddVarRW("", TW_TYPE_FLOAT, &mBlurCutoff, ("label='Blur Cutoff' min=0.0 max=1.0 step=0.01" + GetNameFormatted()).c_str());
-  AddVarRW("", TW_TYPE_BOOLCPP, &mInvert, ("label='Invert'" + GetNameFormatted()).c_str());
-}
-
-void BlurHorizontal::EnableUniforms( wfe::RenderBuffer* source )
-{
-  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
-  mShader->EnableTexture(WFE_GRAPHICS->GetDepthAndNormalBuffer()->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_SHADOW);
-
-  glUniform1f(mShader->GetMapSizeHandle(), 1.0f / (source->GetWidth()));
-  glUniform1i(mShader->GetBlurHalfSizeHandle(), mHalfSize);
-
-  glUniform1f(mBlurCutoffHandle, mBlurCutoff);
-  glUniform1i(mInvertHandle, mInvert);
-  glUniform1i(mApplyNaiveDOFHandle, mApplyNaiveDOF);
-}
-
-BlurVertical::BlurVertical() : PostProEffect(sType), mHalfSize(7), mApplyNaiveDOF(false), mInvert(false), mBlurCutoff(0.3f)
-{  
-  mShader = &WFE_SHADER_MANAGER->GetResource("BlurVertical.xml");
-
-  if(!mShader)
-  {
-    WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-  }
-  else
-  {
-    mApplyNaiveDOFHandle = glGetUniformLocation(mShader->GetHandle(), "uNaiveDOF");
-    mBlurCutoffHandle = glGetUniformLocation(mShader->GetHandle(), "uBlurCutoff");
-    mInvertHandle = glGetUniformLocation(mShader->GetHandle(), "uInvert");
-  }
-}
-
-void BlurVertical::CreateATB()
-{
-  AddVarRW("", TW_TYPE_INT32, &mHalfSize, ("label='Kernel Half Size' min=1" + GetNameFormatted()).c_str());
-  AddVarRW("", TW_TYPE_BOOLCPP, &mApplyNaiveDOF, ("label='Naive DOF'" + GetNameFormatted()).c_str());
-  AddVarRW("", TW_TYPE_FLOAT, &mBlurCutoff, ("label='Blur Cutoff' min=0.0 max=1.0 step=0.01" + GetNameFormatted()).c_str());
-  AddVarRW("", TW_TYPE_BOOLCPP, &mInvert, ("label='Invert'" + GetNameFormatted()).c_str());
-}
-
-void BlurVertical::EnableUniforms( wfe::RenderBuffer* source )
-{
-  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
-  mShader->EnableTexture(WFE_GRAPHICS->GetDepthAndNormalBuffer()->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_SHADOW);
-
-  glUniform1f(mShader->GetMapSizeHandle(), 1.0f / (source->GetHeight()));
-  glUniform1i(mShader->GetBlurHalfSizeHandle(), mHalfSize);
-  glUniform1f(mBlurCutoffHandle, mBlurCutoff);
-  glUniform1i(mInvertHandle, mInvert);
-  glUniform1i(mApplyNaiveDOFHandle, mApplyNaiveDOF);
-}
-
-BlackWhite::BlackWhite() : PostProEffect(sType), mTolerance(.4f)
-{  
-  mShader = &WFE_SHADER_MANAGER->GetResource("BlackWhite.xml");
-
-  if(!mShader)
-  {
-    WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-  }
-}
-
-void BlackWhite::CreateATB()
-{
-  AddVarRW("", TW_TYPE_FLOAT, &mTolerance, ("label='Tolerance' min=0.0 step=0.001" + GetNameFormatted()).c_str());
-}
-
-void BlackWhite::EnableUniforms( wfe::RenderBuffer* source )
-{
-  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
-
-  glUniform1f(mShader->GetToleranceHandle(), mTolerance);
-}
-
-UnsharpMaskingDepth::UnsharpMaskingDepth() : PostProEffect(sType), mLambda(.1f), mLambdaHandle(-1), mHalfSize(9)
-{  
-  mKeepInputImage = true;
-  mShader = &WFE_SHADER_MANAGER->GetResource("UnsharpMaskingDepth.xml");
-
-  if(!mShader)
-  {
-    WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-  }  
-  PushbackPreEffects(BlurVerticalDepth::sType);
-  PushbackPreEffects(BlurHorizontalDepth::sType);
-
-  mLambdaHandle = glGetUniformLocation(mShader->GetHandle(), "uLambda");
-}
-
-void UnsharpMaskingDepth::CreateATB()
-{
-  AddVarRW("", TW_TYPE_FLOAT, &mLambda, ("label='Lambda' step=0.01" + GetNameFormatted()).c_str());
-  AddVarRW("", TW_TYPE_INT32, &mHalfSize, ("label='Kernel Half Size' min=1" + GetNameFormatted()).c_str());
-}
-
-void UnsharpMaskingDepth::EnableUniforms( wfe::RenderBuffer* source )
-{
-  static_cast<BlurVerticalDepth*>(mPrePostProEffect[0])->mHalfSize = mHalfSize;
-  static_cast<BlurHorizontalDepth*>(mPrePostProEffect[1])->mHalfSize = mHalfSize;
-
-    // Enable the original texture
-  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
-
-  // Enable the original depth texture map
-  mShader->EnableTexture(WFE_GRAPHICS->GetDepthAndNormalBuffer()->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_SHADOW);
-
-  // Send output texture from previous effects
-  mShader->EnableTexture(mInputTextureHandle, Shader::WFE_SHADER_MAPTYPE_ORIGINAL);
-  glUniform1f(mLambdaHandle, mLambda);
-}
-
-
-GaussianBlur::GaussianBlur() : PostProEffect(sType), mRadius(1.f)
-{  
-  mShader = &WFE_SHADER_MANAGER->GetResource("GaussianBlur.xml");
-
-  if(!mShader)
-  {
-    WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-  }
-}
-
-void GaussianBlur::CreateATB()
-{
-  AddVarRW("", TW_TYPE_FLOAT, &mRadius, ("label='Radius' min=0.0 step=1.0" + GetNameFormatted()).c_str());
-}
-
-void GaussianBlur::EnableUniforms( wfe::RenderBuffer* source )
-{
-  // Enable current texture map
-  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
-
-  // Send uniforms for buffer height and width
-  glUniform1f(mShader->GetMapHeightHandle(), static_cast<GLfloat>(source->GetHeight()));
-  glUniform1f(mShader->GetMapWidthHandle(), static_cast<GLfloat>(source->GetWidth()));
-  glUniform1f(glGetUniformLocation(mShader->GetHandle(), "uRadius"), mRadius);
-  //mShader->EnableTexture(WFE_GRAPHICS->GetDepthAndNormalBuffer()->GetDepthTextureHandle(), Shader::WFE_SHADER_MAPTYPE_DEPTH);
-}
-
-Laplacian::Laplacian() : PostProEffect(sType)
-{  
-  mShader = &WFE_SHADER_MANAGER->GetResource("Laplacian.xml");
-
-  if(!mShader)
-  {
-    WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-  }
-}
-
-void Laplacian::CreateATB()
-{
-
-}
-
-void Laplacian::EnableUniforms( wfe::RenderBuffer* source )
-{
-  // Enable current texture map
-  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
-
-  // Send uniforms for buffer height and width
-  glUniform1f(mShader->GetMapHeightHandle(), static_cast<GLfloat>(source->GetHeight()));
-  glUniform1f(mShader->GetMapWidthHandle(), static_cast<GLfloat>(source->GetWidth()));
-}
-
-Sobel::Sobel() : PostProEffect(sType)
-{  
-  mShader = &WFE_SHADER_MANAGER->GetResource("Sobel.xml");
-
-  if(!mShader)
-  {
-    WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-  }
-}
-
-void Sobel::CreateATB()
-{
-}
-
-void Sobel::EnableUniforms( wfe::RenderBuffer* source )
-{
-  // Enable current texture map
-  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
-
-  // Send uniforms for buffer height and width
-  glUniform1f(mShader->GetMapHeightHandle(), static_cast<GLfloat>(source->GetHeight()));
-  glUniform1f(mShader->GetMapWidthHandle(), static_cast<GLfloat>(source->GetWidth()));
-}
-
-UnsharpMasking::UnsharpMasking() : PostProEffect(sType), mWeightage(1.f), mWeightageHandle(-1)
-{  
-  mKeepInputImage = true;
-  mShader = &WFE_SHADER_MANAGER->GetResource("UnsharpMasking.xml");
-
-  if(!mShader)
-  {
-    WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-  }
-  else
-  {
-    mWeightageHandle = glGetUniformLocation(mShader->GetHandle(), "uWeightage");
-    PushbackPreEffects(BlurHorizontal::sType);
-    PushbackPreEffects(BlurVertical::sType);
-  } 
-}
-
-void UnsharpMasking::CreateATB()
-{
-  AddVarRW("", TW_TYPE_FLOAT, &mWeightage, ("label='Weightage' min=0.0 step=0.001" + GetNameFormatted()).c_str());
-}
-
-void UnsharpMasking::EnableUniforms( wfe::RenderBuffer* source )
-{
-  // Enable current texture map
-  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
-
-  // Send uniforms for buffer height and width
-  glUniform1f(mShader->GetMapHeightHandle(), static_cast<GLfloat>(source->GetHeight()));
-  glUniform1f(mShader->GetMapWidthHandle(), static_cast<GLfloat>(source->GetWidth()));
-  glUniform1f(mWeightageHandle, mWeightage);
-
-  // Send default original clean image
-  mShader->EnableTexture(mInputTextureHandle, Shader::WFE_SHADER_MAPTYPE_ORIGINAL);
-}
-
-Negative::Negative() : PostProEffect(sType)
-{  
-  mShader = &WFE_SHADER_MANAGER->GetResource("Negative.xml");
-
-  if(!mShader)
-  {
-    WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-  }
-}
-
-HueChange::HueChange() : PostProEffect(sType), mHue(.0f), mSaturation(.0f), mValue(.0f)
-{  
-  mShader = &WFE_SHADER_MANAGER->GetResource("HueChange.xml");
-
-  if(!mShader)
-  {
-    WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-  }
-  else
-  {
-    mHueHandle = glGetUniformLocation(mShader->GetHandle(), "uHue");
-    mSaturationHandle = glGetUniformLocation(mShader->GetHandle(), "uSaturation");
-    mValueHandle = glGetUniformLocation(mShader->GetHandle(), "uValue");
-  }
-}
-
-void HueChange::CreateATB()
-{
-  AddVarRW("", TW_TYPE_FLOAT, &mHue, ("label='Hue' min=-1.0 max=1.0 step=0.001" + GetNameFormatted()).c_str());
-  AddVarRW("", TW_TYPE_FLOAT, &mSaturation, ("label='Saturation' min=-1.0 max=1.0 step=0.001" + GetNameFormatted()).c_str());
-  AddVarRW("", TW_TYPE_FLOAT, &mValue, ("label='Value' min=-1.0 max=1.0 step=0.001" + GetNameFormatted()).c_str());
-}
-
-void HueChange::EnableUniforms( wfe::RenderBuffer* source )
-{
-  // Enable current texture map
-  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
-
-  // Send uniforms for buffer height and width
-  glUniform1f(mHueHandle, mHue);
-  glUniform1f(mSaturationHandle, mSaturation);
-  glUniform1f(mValueHandle, mValue);
-}
-
-RealisticDOF::RealisticDOF() : PostProEffect(sType), mBias(2.5), mInvert(false)
-{
-  mKeepInputImage = true;
-  mShader = &WFE_SHADER_MANAGER->GetResource("RealisticDOF.xml");
-
-  if(!mShader)
-  {
-    WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-  }
-  else
-  { 
-    PushbackPreEffects(BlurHorizontal::sType);
-    PushbackPreEffects(BlurVertical::sType);
-
-    mInvertHandle = glGetUniformLocation(mShader->GetHandle(), "uInvert");
-    mBiasHandle = glGetUniformLocation(mShader->GetHandle(), "uBias");
-  } 
-}
-
-void RealisticDOF::CreateATB()
-{
-  AddVarRW("", TW_TYPE_FLOAT, &mBias, ("label='Bias' min=-0.0 step=0.1" + GetNameFormatted()).c_str());
-  AddVarRW("", TW_TYPE_BOOLCPP, &mInvert, ("label='Invert'" + GetNameFormatted()).c_str());
-}
-
-void RealisticDOF::EnableUniforms( wfe::RenderBuffer* source )
-{
-  // Enable current texture map
-  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
-
-  // Send default original clean image
-  mShader->EnableTexture(mInputTextureHandle, Shader::WFE_SHADER_MAPTYPE_ORIGINAL);
-
-  mShader->EnableTexture(WFE_GRAPHICS->GetDepthAndNormalBuffer()->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_SHADOW);
-
-  glUniform1f(mBiasHandle, mBias);
-  glUniform1i(mInvertHandle, mInvert);
-}
-
-BlurHorizontalDepth::BlurHorizontalDepth() : PostProEffect(sType), mHalfSize(5)
-{  
-  mShader = &WFE_SHADER_MANAGER->GetResource("BlurHorizontal.xml");
-
-  if(!mShader)
-  {
-    WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-  }
-  else
-  {
-    mApplyNaiveDOFHandle = glGetUniformLocation(mShader->GetHandle(), "uNaiveDOF");
-  }
-}
-
-void BlurHorizontalDepth::EnableUniforms( wfe::RenderBuffer* source )
-{
-  mShader->EnableTexture(WFE_GRAPHICS->GetDepthAndNormalBuffer()->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
-
-  glUniform1f(mShader->GetMapSizeHandle(), 1.0f / (source->GetWidth()));
-  glUniform1i(mShader->GetBlurHalfSizeHandle(), mHalfSize);
-
-  glUniform1i(mApplyNaiveDOFHandle, false);
-}
-
-BlurVerticalDepth::BlurVerticalDepth() : PostProEffect(sType), mHalfSize(5)
-{  
-  mShader = &WFE_SHADER_MANAGER->GetResource("BlurVertical.xml");
-
-  if(!mShader)
-  {
-    WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-  }
-  else
-  {
-    mApplyNaiveDOFHandle = glGetUniformLocation(mShader->GetHandle(), "uNaiveDOF");
-  }
-}
-
-void BlurVerticalDepth::EnableUniforms( wfe::RenderBuffer* source )
-{
-  mShader->EnableTexture(WFE_GRAPHICS->GetDepthAndNormalBuffer()->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
-
-  glUniform1f(mShader->GetMapSizeHandle(), 1.0f / (source->GetHeight()));
-  glUniform1i(mShader->GetBlurHalfSizeHandle(), mHalfSize);
-
-  glUniform1i(mApplyNaiveDOFHandle, false);
-}
-
-AdditiveNoise::AdditiveNoise() : PostProEffect(sType), mOffsetYHandle(-1), mOffsetXHandle(-1), mBias(0.4f)
-{  
-  mShader = &WFE_SHADER_MANAGER->GetResource("AdditiveNoise.xml");
-
-  if(!mShader)
-  {
-    WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-  }
-  s32 sizeX = WFE_WINDOW->GetResoWidth();
-  s32 sizeY = WFE_WINDOW->GetResoHeight();
-  s32 size = 4 * sizeX * sizeY;
-  u8* data = new u8[size]();
-
-  // Create a new noisy texture
-  glGenTextures(1, &mNoisyTextureHandle);
-  //Setup texture params
-  glBindTexture(GL_TEXTURE_2D, mNoisyTextureHandle);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-  f32 standardDeviation = 5.f;
-  // Perform the noisiness
-  for(s32 i = 0; i < size; ++i)
-  {
-    //Generate amount to be added
-    f32 ran = glm::gaussRand1(0.1f, standardDeviation);      
-    data[i] += (u8)ran;
-
-    data[i] = Clamp<u8>(data[i], 0, 255);
-  }
-  // Upload to GPU
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, sizeX, sizeY, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-  glBindTexture(GL_TEXTURE_2D, 0);
-  delete [] data;
-
-  mOffsetXHandle = glGetUniformLocation(mShader->GetHandle(), "uOffsetX");
-  mOffsetYHandle = glGetUniformLocation(mShader->GetHandle(), "uOffsetY");
-  mBiasHandle = glGetUniformLocation(mShader->GetHandle(), "uBias");
-}
-
-void AdditiveNoise::CreateATB()
-{
-  AddVarRW("", TW_TYPE_FLOAT, &mBias, ("label='Value' min=-0.0 max=1.0 step=0.001" + GetNameFormatted()).c_str());
-}
-
-void AdditiveNoise::EnableUniforms( wfe::RenderBuffer* source )
-{
-  // Enable current texture map
-  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
-
-  // Enable noisy texture map
-  mShader->EnableTexture(mNoisyTextureHandle, Shader::WFE_SHADER_MAPTYPE_OTHER);
-
-  // Send uniforms
-  glUniform1f(mOffsetXHandle, glm::compRand1(0.f, 1.f));
-  glUniform1f(mOffsetYHandle, glm::compRand1(0.f, 1.f));
-  glUniform1f(mBiasHandle, mBias);
-}
-
-// AdditiveNoise::~AdditiveNoise()
-// {
-//     //delete [] m_data;
-// }
-
-
-
-
-BloomCombine::BloomCombine():PostProEffect(sType),
-                             m_coefP1(.15f),
-                             m_coefP1x(1.0f),
-                             m_coefP1y(1.0f),
-                             m_coefP1z(1.0f),
-                             m_coefP2(1.f)
-{
-	mShader = &WFE_SHADER_MANAGER->GetResource("Bloom_combine.xml");
-  mKeepInputImage = true;
-
-	if(!mShader)
-	{
-		WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-	}
-	else
-	{ 
-    PushbackPreEffects(LuminanceThreshold::sType);
-		PushbackPreEffects(BlurHorizontal::sType);
-		PushbackPreEffects(BlurVertical::sType);
-    static_cast<BlurHorizontal*>(mPrePostProEffect[1])->mHalfSize = 3;
-    static_cast<BlurVertical*>(mPrePostProEffect[2])->mHalfSize = 3;
-	}
-
-	s32 size = 1024;
-
-  for(u32 i = 0; i < 6; i +=2)
-  {
-    mRenderBuffer[i] = new wfe::RenderBuffer(size, size, false);
-    mRenderBuffer[i + 1] = new wfe::RenderBuffer(size, size, false);
-
-    size /= 2;
-  }
-
-	locC1 = glGetUniformLocation(mShader->GetHandle(),"uCoeft1") ;
-	locC2 =	glGetUniformLocation(mShader->GetHandle(),"uCoeft1x");
-	locC3 =	glGetUniformLocation(mShader->GetHandle(),"uCoeft1y");
-	locC4 =	glGetUniformLocation(mShader->GetHandle(),"uCoeft1z");
-	locC5 =	glGetUniformLocation(mShader->GetHandle(),"uCoeft2") ;
-}
-
-void BloomCombine::CreateATB()
-{
-	AddVarRW("", TW_TYPE_FLOAT, &m_coefP1, ("label='t1 Coefficient' step=0.01" + GetNameFormatted()).c_str());
-	AddVarRW("", TW_TYPE_FLOAT, &m_coefP1x, ("label='t1x Coefficient' step=0.01" + GetNameFormatted()).c_str());
-	AddVarRW("", TW_TYPE_FLOAT, &m_coefP1y, ("label='t1y Coefficient' step=0.01" + GetNameFormatted()).c_str());
-	AddVarRW("", TW_TYPE_FLOAT, &m_coefP1z, ("label='t1z Coefficient' step=0.01" + GetNameFormatted()).c_str());
-	AddVarRW("", TW_TYPE_FLOAT, &m_coefP2, ("label='t2 Coefficient' step=0.01" + GetNameFormatted()).c_str());	
-}
-
-void BloomCombine::PreBindUpdate(wfe::RenderBuffer* source )
-{
-  for(u32 i = 0; i < 6; i += 2)
-  {
-    WFE_GRAPHICS->SwitchShader(&WFE_SHADER_MANAGER->GetResource("BlurVertical.xml"));
-    glUniform1f(mShader->GetMapSizeHandle(), 1.0f / mRenderBuffer[i]->GetWidth());
-    glUniform1i(mShader->GetBlurHalfSizeHandle(), 3);
-    mRenderBuffer[i]->Bind();
-    glBindTexture(GL_TEXTURE_2D, source->GetColorTextureHandle());
-    WFE_GRAPHICS->DrawOverScreen();
-
-    WFE_GRAPHICS->SwitchShader(&WFE_SHADER_MANAGER->GetResource("BlurHorizontal.xml"));
-    glUniform1f(mShader->GetMapSizeHandle(), 1.0f / (mRenderBuffer[i]->GetWidth()));
-    glUniform1i(mShader->GetBlurHalfSizeHandle(), 3);
-    mRenderBuffer[i + 1]->Bind();
-    glBindTexture(GL_TEXTURE_2D, mRenderBuffer[i]->GetColorTextureHandle());
-    WFE_GRAPHICS->DrawOverScreen();
-  }
-}
-
-void BloomCombine::EnableUniforms( wfe::RenderBuffer* source)
-{
-	mShader->EnableTexture(mInputTextureHandle, Shader::WFE_SHADER_MAPTYPE_COLOR);
-  mShader->EnableTexture(source->GetColorTextureHandle(),Shader::WFE_SHADER_MAPTYPE_BLOOMZERO);
-  mShader->EnableTexture(mRenderBuffer[1]->GetColorTextureHandle(),Shader::WFE_SHADER_MAPTYPE_BLOOMONE);
-  mShader->EnableTexture(mRenderBuffer[3]->GetColorTextureHandle(),Shader::WFE_SHADER_MAPTYPE_BLOOMTWO);
-  mShader->EnableTexture(mRenderBuffer[5]->GetColorTextureHandle(),Shader::WFE_SHADER_MAPTYPE_BLOOMTHREE);
-
-  glUniform1f(locC1 , m_coefP1);
-  glUniform1f(locC2 , m_coefP1x);
-  glUniform1f(locC3 , m_coefP1y);
-  glUniform1f(locC4 , m_coefP1z);
-  glUniform1f(locC5 , m_coefP2);
-}
-
-LuminanceThreshold::LuminanceThreshold() : PostProEffect(sType)
-{
-  mShader = &WFE_SHADER_MANAGER->GetResource("Luminance.xml");
-
-  if(!mShader)
-  {
-    WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-  }
-}
-
-
-OldFilm::OldFilm() : PostProEffect(sType), mSepiaVaue(1.0f), mNoiseValue(1.0f),mScratchValue(1.0f)
-										 , mInnerVignetting(0.5f), mOuterVignetting(0.9f)
-										 , mRandomValue(0.5f), mTimeLapse(1.f),m_multiplier(0.f)	
-{  
-	mShader = &WFE_SHADER_MANAGER->GetResource("OldFilm.xml");
-
-	if(!mShader)
-	{
-		WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-	}
-	
-	mSepiaHandle = glGetUniformLocation(mShader->GetHandle(),"uSpeiaValue");
-	mNoiseHandle = glGetUniformLocation(mShader->GetHandle(),"uNoiseValue");
-	mScratchHandle = glGetUniformLocation(mShader->GetHandle(),"uScratchValue");
-	mInnerVignettingHandle = glGetUniformLocation(mShader->GetHandle(),"uInnerVignetting");
-	mOuterVignettingHandle = glGetUniformLocation(mShader->GetHandle(),"uOuterVignetting");
-	mRandomValueHandle = glGetUniformLocation(mShader->GetHandle(),"uRandomValue");
-	mTimeLapseHandle = glGetUniformLocation(mShader->GetHandle(),"uTimeLapse");
-
-	
-}
-
-void OldFilm::CreateATB()
-{
-	AddVarRW("", TW_TYPE_FLOAT, &mSepiaVaue, ("label='Sepia Value' step=0.01" + GetNameFormatted()).c_str());
-	AddVarRW("", TW_TYPE_FLOAT, &mNoiseValue, ("label='Noise Value' step=0.01" + GetNameFormatted()).c_str());
-	AddVarRW("", TW_TYPE_FLOAT, &mScratchValue, ("label='Scratch Value' step=0.01" + GetNameFormatted()).c_str());
-	AddVarRW("", TW_TYPE_FLOAT, &mInnerVignetting, ("label='Inner Vignetting ' step=0.01" + GetNameFormatted()).c_str());
-	AddVarRW("", TW_TYPE_FLOAT, &mOuterVignetting, ("label='Outer Vignetting' step=0.01" + GetNameFormatted()).c_str());
-	AddVarRW("", TW_TYPE_FLOAT, &mRandomValue, ("label='Random Value' step=0.01" + GetNameFormatted()).c_str());
-	AddVarRW("", TW_TYPE_FLOAT, &mTimeLapse, ("label='Time Lapse' step=0.01" + GetNameFormatted()).c_str());
-}
-
-void OldFilm::EnableUniforms( wfe::RenderBuffer* source )
-{
-	// Enable current texture map
-	mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
-
-	//0.1-1.1
-	m_multiplier =  cos(WFE_FRC->GetLevelTime() / 3.f + 7.f);
-	
-	// Send uniforms
-	glUniform1f(mSepiaHandle,			mSepiaVaue);
-	glUniform1f(mNoiseHandle,			.5f + cos(WFE_FRC->GetLevelTime() / 2.f + 3.f ) * mNoiseValue) ;
-	glUniform1f(mScratchHandle,		.5f + 	cos(WFE_FRC->GetLevelTime() * 10.f  + 11.f) * mScratchValue);
-	glUniform1f(mInnerVignettingHandle, cos(WFE_FRC->GetLevelTime()) * mInnerVignetting + .1f);
-	glUniform1f(mOuterVignettingHandle, mOuterVignetting);
-	glUniform1f(mRandomValueHandle,		m_multiplier * mRandomValue / 2.f) ;
-	glUniform1f(mTimeLapseHandle,	.5f + 	cos(WFE_FRC->GetLevelTime() * 10.f + 13.f) * mTimeLapse);
-}
-
-PPSSAO::PPSSAO(): PostProEffect(sType), 
-  mAOStrength(0.33f), 
-  mAOSampleDistance(8.f),
-  mAOScale(20.0f),
-  mAOSamples(6), 
-  mAOSamples2(2)
-{  
-  mShader = &WFE_SHADER_MANAGER->GetResource("SimpleAttribs.xml");
-
-  if(!mShader)
-  {
-    WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-  }
-}
-
-PPSSAO::~PPSSAO()
-{
-  WFE_GRAPHICS->SetAOActive(false);
-}
-
-void PPSSAO::CreateATB()
-{
-  AddVarRW("", TW_TYPE_FLOAT, &WFE_GRAPHICS->mAOStrength, ("label='AO Strength' step=0.01" + GetNameFormatted()).c_str());
-  AddVarRW("", TW_TYPE_FLOAT, &WFE_GRAPHICS->mAOSampleDistance, ("label='Sample Distance' step=0.01" + GetNameFormatted()).c_str());
-  AddVarRW("", TW_TYPE_FLOAT, &WFE_GRAPHICS->mAOScale, ("label='AO Scale' step=0.01" + GetNameFormatted()).c_str());
-  AddVarRW("", TW_TYPE_INT32, &WFE_GRAPHICS->mAOSamples, ("label='AO Samples' min=1" + GetNameFormatted()).c_str());
-  AddVarRW("", TW_TYPE_INT32, &WFE_GRAPHICS->mAOSamples2, ("label='AO Samples2' min=1" + GetNameFormatted()).c_str());
-}
-
-void PPSSAO::EnableUniforms( wfe::RenderBuffer* source)
-{
-  PostProEffect::EnableUniforms(source);
-  // hacking it in, not sure why it isnt working properly when i add it in stack
-  WFE_GRAPHICS->SetAOActive(true);
-}
-
-
-Fog::Fog() : PostProEffect(sType), mCameraViewVecHandle(-1), mCameraEyePosHandle(-1)
-{  
-    mShader = &WFE_SHADER_MANAGER->GetResource("Fog.xml");
-
-    if(!mShader)
-    {
-        WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
-    }
-
-    mCameraViewVecHandle = glGetUniformLocation(mShader->GetHandle(),"uCameraViewVec");
-    mCameraEyePosHandle = glGetUniformLocation(mShader->GetHandle(),"uCameraEyePos");  
-    mCameraNear = glGetUniformLocation(mShader->GetHandle(),"uCameraNear");  
-    mCameraFar = glGetUniformLocation(mShader->GetHandle(),"uCameraFar");
-    if(mCameraEyePosHandle == -1)
-    {
-        assert(0);
-    }
-    if(mCameraViewVecHandle == -1)
-    {
-        assert(0);
-    }
-}
-
-void Fog::CreateATB()
-{
-//     AddVarRW("", TW_TYPE_FLOAT, &mSepiaVaue, ("label='Sepia Value' step=0.01" + GetNameFormatted()).c_str());
-//     AddVarRW("", TW_TYPE_FLOAT, &mNoiseValue, ("label='Noise Value' step=0.01" + GetNameFormatted()).c_str());
-//     AddVarRW("", TW_TYPE_FLOAT, &mScratchValue, ("label='Scratch Value' step=0.01" + GetNameFormatted()).c_str());
-//     AddVarRW("", TW_TYPE_FLOAT, &mInnerVignetting, ("label='Inner Vignetting ' step=0.01" + GetNameFormatted()).c_str());
-//     AddVarRW("", TW_TYPE_FLOAT, &mOuterVignetting, ("label='Outer Vignetting' step=0.01" + GetNameFormatted()).c_str());
-//     AddVarRW("", TW_TYPE_FLOAT, &mRandomValue, ("label='Random Value' step=0.01" + GetNameFormatted()).c_str());
-//     AddVarRW("", TW_TYPE_FLOAT, &mTimeLapse, ("label='Time Lapse' step=0.01" + GetNameFormatted()).c_str());
-}
-
-void Fog::EnableUniforms( wfe::RenderBuffer* source )
-{
-    // Enable current texture map
-    mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
-
-    // Enable the original depth texture map
-    mShader->EnableTexture(WFE_GRAPHICS->GetDepthAndNormalBuffer()->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_SHADOW);
-
-    Camera * camera = WFE_CAMERA->GetActiveCamera();
-
-	Vec3 nearCenter = camera->GetViewVec() * camera->GetNearPlaneDistance() * 1.2f;
-    //Vec3 viewVec = camera->GetViewVec();
-    nearCenter = Vec3(glm::inverse(camera->GetWorldToViewMtx()) * Vec4(nearCenter, 0));
-    glUniform3f(mCameraViewVecHandle, -nearCenter.x, -nearCenter.y , -nearCenter.z);// -viewVec.x,-viewVec.y, -viewVec.z);
-    Vec3 camPos = camera->GetEyePos();
-    glUniform3f(mCameraEyePosHandle, camPos.x, camPos.y, camPos.z);
-    glUniform1f(mCameraNear, camera->GetNearPlaneDistance());
-    glUniform1f(mCameraFar, camera->GetFarPlaneDistance());
-
-  
-    float distEyeToNearPlane = glm::length(nearCenter - camera->GetEyePos());
-	 float a = camera->GetFov();
-
-    float nearHalfHeight = tan(a * 0.5f/180.f) * distEyeToNearPlane;
-	float w = static_cast<float>(source->GetWidth());
-	float h = static_cast<float>(source->GetHeight()); 
-    float nearHalfWidth = nearHalfHeight * ( w/h )/*WFE_WINDOW->GetResoWidth() / WFE_WINDOW->GetResoHeight()*/;
-
-    GLint pos = glGetUniformLocation(mShader->GetHandle(),"uNearTopLeft");
-    Vec3 corner = nearCenter + (camera->GetUpVec() * nearHalfHeight) - (camera->GetSideVec() * nearHalfWidth);
-    corner = Vec3(glm::inverse(camera->GetWorldToViewMtx()) * Vec4(corner, 0));
-    glUniform3f(pos, corner.x, corner.y, corner.z);
-    corner = nearCenter + (camera->GetUpVec() * nearHalfHeight) + (camera->GetSideVec() * nearHalfWidth);
-    corner = Vec3(glm::inverse(camera->GetWorldToViewMtx()) * Vec4(corner, 0));
-    pos = glGetUniformLocation(mShader->GetHandle(),"uNearTopRight");
-    glUniform3f(pos, corner.x, corner.y, corner.z);
-    corner = nearCenter - (camera->GetUpVec() * nearHalfHeight) - (camera->GetSideVec() * nearHalfWidth);
-    corner = Vec3(glm::inverse(camera->GetWorldToViewMtx()) * Vec4(corner, 0));
-    pos = glGetUniformLocation(mShader->GetHandle(),"uNearBottomLeft");
-    glUniform3f(pos, corner.x, corner.y, corner.z);
-    corner = nearCenter - (camera->GetUpVec() * nearHalfHeight) + (camera->GetSideVec() * nearHalfWidth);
-    corner = Vec3(glm::inverse(camera->GetWorldToViewMtx()) * Vec4(corner, 0));
-    pos = glGetUniformLocation(mShader->GetHandle(),"uNearBottomRight");
-    glUniform3f(pos, corner.x, corner.y, corner.z);
-
-//     //0.1-1.1
-//     m_multiplier =  cos(WFE_FRC->GetLevelTime() / 3.f + 7.f);
-// 
-//     // Send uniforms
-//     glUniform1f(mSepiaHandle,			mSepiaVaue);
-//     glUniform1f(mNoiseHandle,			.5f + cos(WFE_FRC->GetLevelTime() / 2.f + 3.f ) * mNoiseValue) ;
-//     glUniform1f(mScratchHandle,		.5f + 	cos(WFE_FRC->GetLevelTime() * 10.f  + 11.f) * mScratchValue);
-//     glUniform1f(mInnerVignettingHandle, cos(WFE_FRC->GetLevelTime()) * mInnerVignetting + .1f);
-//     glUniform1f(mOuterVignettingHandle, mOuterVignetting);
-//     glUniform1f(mRandomValueHandle,		m_multiplier * mRandomValue / 2.f) ;
-//     glUniform1f(mTimeLapseHandle,	.5f + 	cos(WFE_FRC->GetLevelTime() * 10.f + 13.f) * mTimeLapse);
-}
\ No newline at end of file
+/******************************************************************************/
+/*!
+\file   PostProEffect.cpp
+\par    email: y.li\@digipen.edu
+\par    name:  Sebastian Li Ye Wei
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Class that performs post processing effects for the game
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+
+/*****************************************************************************/
+/*!
+Includes
+*/
+/*****************************************************************************/
+#include "Precompiled.h" //Precompiled header
+#include "RenderBuffer.h"
+#include "Window.h"
+#include "GraphicsManager.h"
+#include "ShaderManager.h"
+
+#include "PostProEffect.h" //Own header
+#include "PostProcessingManager.h"
+#include "PostProCommandList.h"
+#include "PostProStateCache.h"
+#include "PostProDepthPyramid.h"
+#include "PostProExposure.h"
+#include "LevelEditor.h"
+#include "GameplayState.h"
+#include "GameStateManager.h"
+#include "TextureManager.h"
+#include "Camera.h"
+#include <random>
+
+/*****************************************************************************/
+/*!
+Use the engine namespace, for convenience
+*/
+/*****************************************************************************/
+using namespace wfe;
+
+s32 PostProEffect::sRenderWidth = 0;
+s32 PostProEffect::sRenderHeight = 0;
+f32 PostProEffect::sUVScale[2] = { 1.f, 1.f };
+u32 PostProEffect::sStructureVersion = 0;
+b8 PostProEffect::sHDR = true;
+std::map<GLuint, GLint> PostProEffect::sUVScaleHandles;
+
+void TW_CALL SetCombineModeCB(const void *value, void *clientData)
+{ 
+  static_cast<PostProEffect*>(clientData)->SetCombineMode(*static_cast<const PostProcessingCombineModes*>(value));
+}
+
+void TW_CALL GetCombineModeCB(void *value, void *clientData)
+{ 
+  *static_cast<s32*>(value) = static_cast<PostProEffect*>(clientData)->GetCombineMode();
+}
+
+void TW_CALL SetStructureBoolCB(const void *value, void *clientData)
+{ 
+  *static_cast<b8*>(clientData) = *static_cast<const b8*>(value);
+  PostProEffect::InvalidateRecording();
+}
+
+void TW_CALL GetStructureBoolCB(void *value, void *clientData)
+{ 
+  *static_cast<b8*>(value) = *static_cast<b8*>(clientData);
+}
+
+void TW_CALL SetStructureIntCB(const void *value, void *clientData)
+{ 
+  *static_cast<s32*>(clientData) = *static_cast<const s32*>(value);
+  PostProEffect::InvalidateRecording();
+}
+
+void TW_CALL GetStructureIntCB(void *value, void *clientData)
+{ 
+  *static_cast<s32*>(value) = *static_cast<s32*>(clientData);
+}
+
+void TW_CALL GetTargetMemoryCB(void *value, void *clientData)
+{ 
+  *static_cast<f32*>(value) = PostProcessingManager::sRenderTargetPool->GetBytesHeldBy(static_cast<PostProEffect*>(clientData)) / 1024.f;
+}
+
+//Blurs up to this half size get a variant with the loop unrolled, wider ones
+//loop over uHalfSize in the generic program
+static const s32 sMaxUnrolledHalfSize = 8;
+
+static PostProShaderDefines GetBlurDefines(s32 halfSize)
+{
+  PostProShaderDefines defines;
+  defines["HALF_SIZE"] = halfSize;
+  //Pixels outside the cutoff are masked out in the stencil buffer, the branch compiles away
+  defines["NAIVE_DOF"] = 0;
+  defines["INVERT"] = 0;
+  return defines;
+}
+
+PostProEffect::BlurHandles::BlurHandles() : mProgram(0), mMapSize(-1), mHalfSize(-1), mBlurCutoff(-1), mInvert(-1), mNaiveDOF(-1), mUVScale(-1), mCombineMode(-1), mOpacity(-1)
+{
+}
+
+void PostProEffect::BlurHandles::Update(GLuint program)
+{
+  if(mProgram == program)
+  {
+    return;
+  }
+
+  //The options only exist in the generic program, variants have them compiled in
+  mProgram = program;
+  mMapSize = glGetUniformLocation(program, "uMapSize");
+  mHalfSize = glGetUniformLocation(program, "uHalfSize");
+  mBlurCutoff = glGetUniformLocation(program, "uBlurCutoff");
+  mInvert = glGetUniformLocation(program, "uInvert");
+  mNaiveDOF = glGetUniformLocation(program, "uNaiveDOF");
+  mUVScale = GetUVScaleHandle(program);
+  mCombineMode = glGetUniformLocation(program, "uCombineMode");
+  mOpacity = glGetUniformLocation(program, "uOpacity");
+}
+
+PostProEffect::PostProEffect(s32 type)
+  :  mType(type), mShader(0), mProgram(0), mCombineMode(POSTPRO_CM_REPLACE), mOpacity(1.f), mCombineHandlesProgram(0),
+     mCombineModeHandle(-1), mOpacityHandle(-1), mCombineShader(0), mCombinePassModeHandle(-1), mCombinePassOpacityHandle(-1), mSourceName("previous"), mCombineBase(0), mOutputsLDR(false), mOutputsAlpha(false), mUsesDepthPyramid(false), mSupportsRenderScale(false), mShadersLoaded(false), mPrepared(false)
+{  
+  //The combine mode can change at any time, so every effect loads the pass up front
+  AddShader(&mCombineShader, "Combine.xml");
+}
+
+PostProEffect::~PostProEffect()
+{
+  ReleaseTransientTargets();
+
+  while(!mSubEffects.empty())
+  {
+    FactoryFree(PostProcessingManager::mPostProEffectFactoryContainer, mSubEffects.back()->GetType(), mSubEffects.back());
+    mSubEffects.pop_back();
+  }
+}
+
+/*****************************************************************************/
+/*!
+Applies the effect using the shader and combine mode
+*/
+/*****************************************************************************/
+void PostProEffect::Apply(RenderBuffer* source, RenderBuffer* dest)
+{
+  PostProStateCache* state = PostProcessingManager::sStateCache;
+
+  //Effects pushed synchronously are prepared on first use
+  if(!mPrepared)
+  {
+    Prepare();
+  }
+
+  //Sub effects were already run by the graph, which also resolved the inputs
+  PreBindUpdate(source);
+  //Extra passes done in there do not go through the state cache
+  state->Invalidate();
+
+  //Shaders that know the combine modes blend with their input in the same pass,
+  //as long as that is the source they read. Everything else renders into a
+  //scratch target that Combine.xml blends over the input afterwards
+  RenderBuffer* base = mCombineBase ? mCombineBase : source;
+  b8 combineInShader = POSTPRO_CM_REPLACE == mCombineMode || (base == source && HasCombineSupport());
+  RenderBuffer* target = combineInShader ? dest : AcquireTransientTarget(dest->GetWidth(), dest->GetHeight(), GetColorFormat(true));
+
+  PostProDepthMaskRange maskRange;
+  b8 masked = GetDepthMask(maskRange);
+
+  //Dest buffer is not guaranteed to be cleared so we bind and clear it first.
+  //In REPLACE the quad covers everything and the state cache drops the clear.
+  //The depth mask fills the pixels it masks out itself, without one everything is drawn
+  state->SetCombineBlending(POSTPRO_CM_REPLACE);
+  masked = masked && PostProcessingManager::sDepthMask->Begin(target, source, maskRange);
+  if(!masked)
+  {
+    state->ClearTarget(target);
+  }
+  // if null ptr, most likely u forgot to give ur post pro effect the name of the shader file
+  ASSERT(mShader);
+
+  //Use the shader for this effect
+  state->SwitchShader(mShader, mProgram);
+
+  //Enable the color texture for the shader
+  //You can enable other types of textures by changing the enum provided in the second argument
+  //In your shaders, your samplers are expected to be named one of the following:
+  // uColorMap
+  // uEmissiveMap
+  // uSpecularMap
+  // uNormalMap 
+  // uDissolveMap
+  // uShadowMap
+  //If you want to use a texture that is named something else you are going to have
+  //to bind the texture unit and uniform manually. The enable texture function will
+  //NOT work if you try to enable a texture that the shader does not have a
+  //corresponding sampler for (with the expected name).
+
+  EnableViewportUniforms(GetProgramHandle());
+  EnableCombineUniforms();
+  EnableInputTextures();
+  EnableUniforms(source);
+  state->InvalidateTextures();
+
+  //This is how you would pass in a custom uniform
+  //glUniform1f(glGetUniformLocation(mShader->GetHandle(), "uMyUniformName"), 1.0f);
+
+  //Draw a fullscreen quad over the screen (assumes that view proj mtx has been set to identity)
+  //The view proj mtx should have been set in the PostProcessing class before this
+  state->DrawOverScreen();
+
+  if(masked)
+  {
+    PostProcessingManager::sDepthMask->End(target);
+  }
+
+  //Any additional steps to apply the effect would go here.
+  //For example, for 2 pass blur, you would draw to an intermediate buffer for the 
+  //vertical pass, draw to another buffer for the horizontal pass and finally
+  //use the code below to draw the results back into the source.
+
+  //////////////////////////////////////////////////////////////////////////
+  //Combine the result with the input image of the effect, which is not the
+  //source for effects that read the result of their sub effects.
+  //Combine Modes Available:
+  // REPLACE: What the shader draws is what the effect outputs
+  // NORMAL: What the shader draws is alpha blended over the source image
+  // ADD: What the shader draws is added to the source image
+  // SUB: What the shader draws is subtracted from the source image
+  // MULTIPLY: What the shader draws is multiplied with the source image
+  // SCREEN: Inverse multiply, brightens the source image
+  // LERP: Blends between the source image and what the shader draws by the opacity
+  //Every mode except REPLACE is faded against the source image by the opacity
+  if (!combineInShader)
+  {
+    ApplyCombinePass(target, base, dest);
+  }
+
+  ReleaseTransientTargets();
+}
+
+void PostProEffect::EnableUniforms(RenderBuffer* source)
+{
+  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+}
+
+b8 PostProEffect::Record(PostProCommandList& list, RenderBuffer* source, RenderBuffer* dest)
+{
+  //The separate combine pass and the depth mask still go through Apply
+  PostProDepthMaskRange maskRange;
+  if(!mShader || GetDepthMask(maskRange))
+  {
+    return false;
+  }
+
+  if(POSTPRO_CM_REPLACE != mCombineMode && (mCombineBase != source || !HasCombineSupport()))
+  {
+    return false;
+  }
+
+  return RecordPass(list, source, dest);
+}
+
+b8 PostProEffect::RecordPass(PostProCommandList& list, RenderBuffer* source, RenderBuffer* dest)
+{
+  UpdateCombineHandles();
+
+  list.BeginPass(mShader, dest, mProgram);
+  list.AddUniform2(GetUVScaleHandle(GetProgramHandle()), sUVScale);
+  list.AddUniformInt(mCombineModeHandle, mCombineMode);
+  list.AddUniform(mOpacityHandle, &mOpacity);
+
+  for(u32 i = 0; i < mInputs.size(); ++i)
+  {
+    list.AddTexture(mInputTargets[i]->GetColorTextureHandle(), mInputs[i].mMapType);
+  }
+
+  if(!RecordUniforms(list, source))
+  {
+    list.AbortPass();
+    return false;
+  }
+
+  return true;
+}
+
+void PostProEffect::UpdateCombineHandles()
+{
+  GLuint program = mShader ? GetProgramHandle() : 0;
+  if(mCombineHandlesProgram == program)
+  {
+    return;
+  }
+
+  mCombineHandlesProgram = program;
+  mCombineModeHandle = program ? glGetUniformLocation(program, "uCombineMode") : -1;
+  mOpacityHandle = program ? glGetUniformLocation(program, "uOpacity") : -1;
+}
+
+b8 PostProEffect::HasCombineSupport()
+{
+  UpdateCombineHandles();
+  return mCombineModeHandle != -1;
+}
+
+void PostProEffect::EnableCombineUniforms()
+{
+  UpdateCombineHandles();
+  glUniform1i(mCombineModeHandle, mCombineMode);
+  glUniform1f(mOpacityHandle, mOpacity);
+}
+
+/*****************************************************************************/
+/*!
+Blends result over base, the effect's input, into dest with the combine mode,
+for effect shaders that cannot do it themselves
+*/
+/*****************************************************************************/
+void PostProEffect::ApplyCombinePass(RenderBuffer* result, RenderBuffer* base, RenderBuffer* dest)
+{
+  PostProStateCache* state = PostProcessingManager::sStateCache;
+  Shader* shader = mCombineShader;
+
+  state->ClearTarget(dest);
+  state->SwitchShader(shader);
+  state->EnableTexture(result->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  state->EnableTexture(base->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_ORIGINAL);
+  EnableViewportUniforms(shader);
+  glUniform1i(mCombinePassModeHandle, mCombineMode);
+  glUniform1f(mCombinePassOpacityHandle, mOpacity);
+  state->DrawOverScreen();
+}
+
+void PostProEffect::SwitchBlending(PostProcessingCombineModes mode)
+{
+  switch(mode)
+  {
+  case POSTPRO_CM_REPLACE:
+    break;
+  case POSTPRO_CM_NORMAL:
+    WFE_GRAPHICS->SwitchBlendingMode(WFE_BM_NORMAL);
+    break;
+  case POSTPRO_CM_ADD:
+    WFE_GRAPHICS->SwitchBlendingMode(WFE_BM_ADD);
+    break;
+  case POSTPRO_CM_SUB:
+    WFE_GRAPHICS->SwitchBlendingMode(WFE_BM_SUB);
+    break;
+  default:
+    ASSERT(false);
+  }
+}
+
+void PostProEffect::CreateATBMain(u32 index)
+{
+  std::stringstream ss;
+
+  ss << "Post Processing Effect #" << index;
+  mName = ss.str();
+
+  mNameFormatted = " group='" + mName + "' ";
+
+  StringContainer stringContainer;
+
+  stringContainer.push_back("REPLACE");
+  stringContainer.push_back("NORMAL");
+  stringContainer.push_back("ADD");
+  stringContainer.push_back("SUB");
+  stringContainer.push_back("MULTIPLY");
+  stringContainer.push_back("SCREEN");
+  stringContainer.push_back("LERP");
+
+  TwAddSeparator(PostProcessingManager::sStackBar, "", mNameFormatted.c_str());
+  AddDropDownVarCB(PostProcessingManager::sStackBar, 
+    EDITOR_MODE_PAUSE, 
+    "", 
+    SetCombineModeCB, 
+    GetCombineModeCB, 
+    this, 
+    ("label='Combine Mode'" + mNameFormatted).c_str(),
+    "CombineModeEnum",
+    stringContainer,
+    false);
+  AddVarRW("", TW_TYPE_FLOAT, &mOpacity, ("label='Opacity' min=0.0 max=1.0 step=0.01" + mNameFormatted).c_str());
+
+  TwAddVarCB(PostProcessingManager::sStackBar, "", TW_TYPE_FLOAT, 0, GetTargetMemoryCB, this, ("label='Target Memory (KB)'" + mNameFormatted).c_str());
+
+  CreateATB();
+}
+
+void PostProEffect::AddVarRW( cstr const name, TwType type, void* var, cstr const def )
+{
+  TwAddVarRW(PostProcessingManager::sStackBar, name, type, var, def);
+}
+
+void PostProEffect::AddStructureVarRW( cstr const name, b8* var, cstr const def )
+{
+  TwAddVarCB(PostProcessingManager::sStackBar, name, TW_TYPE_BOOLCPP, SetStructureBoolCB, GetStructureBoolCB, var, def);
+}
+
+void PostProEffect::AddStructureVarRW( cstr const name, s32* var, cstr const def )
+{
+  TwAddVarCB(PostProcessingManager::sStackBar, name, TW_TYPE_INT32, SetStructureIntCB, GetStructureIntCB, var, def);
+}
+
+PostProEffect* PostProEffect::AddSubEffect( s32 type, const std::string& sourceName, const std::string& outputName )
+{
+  PostProEffect* effect = FactoryCreate(PostProcessingManager::mPostProEffectFactoryContainer, type);
+  effect->SetSourceName(sourceName);
+  effect->SetOutputName(outputName);
+
+  mSubEffects.push_back(effect);
+  return effect;
+}
+
+void PostProEffect::AddInput( const std::string& name, s32 mapType )
+{
+  PostProEffectInput input = { name, mapType };
+  mInputs.push_back(input);
+  ++sStructureVersion;
+}
+
+void PostProEffect::EnableInputTextures()
+{
+  //Through the state cache, it knows how to bind for variants
+  for(u32 i = 0; i < mInputs.size(); ++i)
+  {
+    PostProcessingManager::sStateCache->EnableTexture(mInputTargets[i]->GetColorTextureHandle(), mInputs[i].mMapType);
+  }
+}
+
+/*****************************************************************************/
+/*!
+Allocates host side memory. No GL calls allowed in here, this may be called
+from a worker thread
+*/
+/*****************************************************************************/
+void PostProEffect::PrepareHost()
+{
+  PostProEffectContainerIt ite = mSubEffects.begin();
+  while (ite != mSubEffects.end())
+  {
+    (*ite)->PrepareHost();
+    ++ite;
+  }
+}
+
+void PostProEffect::PrepareDevice()
+{
+  if(mCombineShader)
+  {
+    mCombinePassModeHandle = glGetUniformLocation(mCombineShader->GetHandle(), "uCombineMode");
+    mCombinePassOpacityHandle = glGetUniformLocation(mCombineShader->GetHandle(), "uOpacity");
+  }
+
+  PostProEffectContainerIt ite = mSubEffects.begin();
+  while (ite != mSubEffects.end())
+  {
+    (*ite)->FinishPrepare();
+    ++ite;
+  }
+}
+
+void PostProEffect::Prepare()
+{
+  if(!mPrepared)
+  {
+    LoadShaders();
+    PrepareHost();
+    FinishPrepare();
+  }
+}
+
+/*****************************************************************************/
+/*!
+Gets the shaders registered with AddShader from the shader manager. The shader
+manager compiles, links and queries the program right here, so this blocks on
+the link. Only the effect's own lookups wait for PrepareDevice. Call it on the
+render thread
+*/
+/*****************************************************************************/
+void PostProEffect::LoadShaders()
+{
+  if(!mShadersLoaded)
+  {
+    for(u32 i = 0; i < mShaderFiles.size(); ++i)
+    {
+      *mShaderFiles[i].first = &WFE_SHADER_MANAGER->GetResource(mShaderFiles[i].second.c_str());
+      if(!*mShaderFiles[i].first)
+      {
+        WFE_LOGGER_POPUP << "Shader file can't be created for post processing effect" << std::endl;
+      }
+    }
+    for(u32 i = 0; i < mShaderVariants.size(); ++i)
+    {
+      PostProcessingManager::sShaderLibrary->RequestVariant(mShader, mShaderVariants[i].first, mShaderVariants[i].second);
+    }
+    mShadersLoaded = true;
+  }
+
+  PostProEffectContainerIt ite = mSubEffects.begin();
+  while (ite != mSubEffects.end())
+  {
+    (*ite)->LoadShaders();
+    ++ite;
+  }
+}
+
+void PostProEffect::AddShader(Shader** shader, cstr const file)
+{
+  *shader = 0;
+  mShaderFiles.push_back(std::make_pair(shader, std::string(file)));
+}
+
+void PostProEffect::AddShaderVariant(cstr const fragmentFile, const PostProShaderDefines& defines)
+{
+  mShaderVariants.push_back(std::make_pair(std::string(fragmentFile), defines));
+}
+
+void PostProEffect::FinishPrepare()
+{
+  if(!mPrepared)
+  {
+    PrepareDevice();
+    mPrepared = true;
+  }
+}
+
+RenderBuffer* PostProEffect::AcquireTarget(s32 width, s32 height, RenderTargetFormat format)
+{
+  return PostProcessingManager::sRenderTargetPool->Acquire(width, height, format, this);
+}
+
+RenderBuffer* PostProEffect::AcquireTransientTarget(s32 width, s32 height, RenderTargetFormat format)
+{
+  RenderBuffer* target = AcquireTarget(width, height, format);
+  mTransientTargets.push_back(target);
+  return target;
+}
+
+void PostProEffect::ReleaseTarget(RenderBuffer*& target)
+{
+  PostProcessingManager::sRenderTargetPool->Release(target);
+  target = 0;
+}
+
+void PostProEffect::ReleaseTransientTargets()
+{
+  while(!mTransientTargets.empty())
+  {
+    ReleaseTarget(mTransientTargets.back());
+    mTransientTargets.pop_back();
+  }
+}
+
+void PostProEffect::BindTarget(RenderBuffer* target)
+{
+  PostProcessingManager::sStateCache->BindTarget(target);
+}
+
+void PostProEffect::EnableViewportUniforms(Shader* shader)
+{
+  EnableViewportUniforms(shader->GetHandle());
+}
+
+void PostProEffect::EnableViewportUniforms(GLuint program)
+{
+  //Shaders without the uniform get -1 and glUniform ignores it
+  glUniform2fv(GetUVScaleHandle(program), 1, sUVScale);
+}
+
+GLint PostProEffect::GetUVScaleHandle(GLuint program)
+{
+  std::map<GLuint, GLint>::iterator ite = sUVScaleHandles.find(program);
+  if(ite == sUVScaleHandles.end())
+  {
+    ite = sUVScaleHandles.insert(std::make_pair(program, glGetUniformLocation(program, "uUVScale"))).first;
+  }
+  return ite->second;
+}
+
+b8 PostProEffect::SupportsRenderScale() const
+{
+  if(!mSupportsRenderScale)
+  {
+    return false;
+  }
+
+  std::vector<PostProEffect*>::const_iterator ite = mSubEffects.begin();
+  while (ite != mSubEffects.end())
+  {
+    if(!(*ite)->SupportsRenderScale())
+    {
+      return false;
+    }
+    ++ite;
+  }
+
+  return true;
+}
+
+s32 PostProEffect::GetSampleReach(s32 width, s32 height) const
+{
+  //Most effects read the pixel and its direct neighbours. Sub effects run one
+  //after the other, so their reaches add up
+  s32 reach = 1;
+
+  std::vector<PostProEffect*>::const_iterator ite = mSubEffects.begin();
+  while (ite != mSubEffects.end())
+  {
+    reach += (*ite)->GetSampleReach(width, height);
+    ++ite;
+  }
+
+  return reach;
+}
+
+GLuint PostProEffect::GetShaderVariant(const std::string& fragmentFile, const PostProShaderDefines& defines)
+{
+  return PostProcessingManager::sShaderLibrary->GetVariant(mShader, fragmentFile, defines);
+}
+
+RenderTargetFormat PostProEffect::GetColorFormat(b8 alpha)
+{
+  if(!sHDR)
+  {
+    return RT_FORMAT_RGBA8;
+  }
+
+  return alpha ? RT_FORMAT_RGBA16F : RT_FORMAT_R11G11B10F;
+}
+
+void PostProEffect::SetRenderRect(s32 width, s32 height, s32 targetWidth, s32 targetHeight)
+{
+  sRenderWidth = width;
+  sRenderHeight = height;
+  sUVScale[0] = static_cast<f32>(width) / targetWidth;
+  sUVScale[1] = static_cast<f32>(height) / targetHeight;
+}
+
+b8 PostProEffect::IsReady() const
+{
+  if(!mShadersLoaded)
+  {
+    return false;
+  }
+
+  for(u32 i = 0; i < mShaderFiles.size(); ++i)
+  {
+    if(!IsShaderReady(*mShaderFiles[i].first))
+    {
+      return false;
+    }
+  }
+
+  for(u32 i = 0; i < mShaderVariants.size(); ++i)
+  {
+    if(!PostProcessingManager::sShaderLibrary->IsVariantReady(mShader, mShaderVariants[i].first, mShaderVariants[i].second))
+    {
+      return false;
+    }
+  }
+
+  std::vector<PostProEffect*>::const_iterator ite = mSubEffects.begin();
+  while (ite != mSubEffects.end())
+  {
+    if(!(*ite)->IsReady())
+    {
+      return false;
+    }
+    ++ite;
+  }
+
+  return true;
+}
+
+b8 PostProEffect::IsShaderReady(const wfe::Shader* shader)
+{
+  if(!shader)
+  {
+    return true;
+  }
+
+#ifdef GL_KHR_parallel_shader_compile
+  // Without the extension the link is synchronous and the program is always ready
+  if(glMaxShaderCompilerThreadsKHR)
+  {
+    GLint completed = GL_TRUE;
+    glGetProgramiv(shader->GetHandle(), GL_COMPLETION_STATUS_KHR, &completed);
+    return completed == GL_TRUE;
+  }
+#endif
+
+  return true;
+}
+
+Desaturation::Desaturation() : PostProEffect(sType), mSaturation(.5f)
+{  
+  AddShader(&mShader, "Desaturation.xml");
+}
+
+void Desaturation::CreateATB()
+{
+  AddVarRW("", TW_TYPE_FLOAT, &mSaturation, ("label='Saturation' min=0.0 max=1.0 step=0.01" + GetNameFormatted()).c_str());
+}
+
+void Desaturation::EnableUniforms(RenderBuffer* source)
+{
+  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  //Pass a saturation value into the shader
+  glUniform1f(mShader->GetSaturationHandle(), mSaturation);
+}
+
+b8 Desaturation::RecordUniforms(PostProCommandList& list, RenderBuffer* source)
+{
+  list.AddTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  list.AddUniform(mShader->GetSaturationHandle(), &mSaturation);
+  return true;
+}
+
+SepiaTone::SepiaTone() : PostProEffect(sType)
+{  
+  AddShader(&mShader, "SepiaTone.xml");
+}
+
+b8 SepiaTone::RecordUniforms(PostProCommandList& list, RenderBuffer* source)
+{
+  list.AddTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  return true;
+}
+
+BlurHorizontal::BlurHorizontal() : PostProEffect(sType), mHalfSize(7), mApplyNaiveDOF(false), mInvert(false), mBlurCutoff(0.3f)
+{  
+  AddShader(&mShader, "BlurHorizontal.xml");
+  mSupportsRenderScale = true;
+
+  //The half size can be changed at any time, have every unrolled one ready
+  for(s32 i = 1; i <= sMaxUnrolledHalfSize; ++i)
+  {
+    AddShaderVariant("BlurHorizontal.fs", GetBlurDefines(i));
+  }
+}
+
+void BlurHorizontal::CreateATB()
+{
+  //The half size picks the variant, so changing it records the stack again
+  AddStructureVarRW("", &mHalfSize, ("label='Kernel Half Size' min=1" + GetNameFormatted()).c_str());
+  AddStructureVarRW("", &mApplyNaiveDOF, ("label='Naive DOF'" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_FLOAT, &mBlurCutoff, ("label='Blur Cutoff' min=0.0 max=1.0 step=0.01" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_BOOLCPP, &mInvert, ("label='Invert'" + GetNameFormatted()).c_str());
+}
+
+b8 BlurHorizontal::Record(PostProCommandList& list, RenderBuffer* source, RenderBuffer* dest)
+{
+  UpdateProgram();
+  return PostProEffect::Record(list, source, dest);
+}
+
+void BlurHorizontal::PreBindUpdate( wfe::RenderBuffer* )
+{
+  UpdateProgram();
+}
+
+void BlurHorizontal::EnableUniforms( wfe::RenderBuffer* source )
+{
+  PostProStateCache* state = PostProcessingManager::sStateCache;
+
+  state->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  state->EnableTexture(WFE_GRAPHICS->GetDepthAndNormalBuffer()->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_SHADOW);
+
+  glUniform1f(mHandles.mMapSize, 1.0f / (source->GetWidth()));
+  glUniform1i(mHandles.mHalfSize, mHalfSize);
+  glUniform1f(mHandles.mBlurCutoff, mBlurCutoff);
+  glUniform1i(mHandles.mInvert, mInvert);
+  //Pixels outside the cutoff are masked out in the stencil buffer, no need to branch
+  glUniform1i(mHandles.mNaiveDOF, false);
+}
+
+b8 BlurHorizontal::RecordUniforms(PostProCommandList& list, RenderBuffer* source)
+{
+  list.AddTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  list.AddTexture(WFE_GRAPHICS->GetDepthAndNormalBuffer()->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_SHADOW);
+
+  list.AddUniform(mHandles.mMapSize, 1.0f / (source->GetWidth()));
+  list.AddUniform(mHandles.mHalfSize, &mHalfSize);
+  list.AddUniform(mHandles.mBlurCutoff, &mBlurCutoff);
+  list.AddUniform(mHandles.mInvert, &mInvert);
+  list.AddUniformInt(mHandles.mNaiveDOF, false);
+  return true;
+}
+
+void BlurHorizontal::UpdateProgram()
+{
+  mProgram = mHalfSize <= sMaxUnrolledHalfSize ? GetShaderVariant("BlurHorizontal.fs", GetBlurDefines(mHalfSize)) : 0;
+  mHandles.Update(GetProgramHandle());
+}
+
+b8 BlurHorizontal::GetDepthMask(PostProDepthMaskRange& range) const
+{
+  if(!mApplyNaiveDOF)
+  {
+    return false;
+  }
+
+  //Only blur what lies past the cutoff, the rest keeps the source image
+  range.mMinDepth = mInvert ? 0.f : mBlurCutoff;
+  range.mMaxDepth = mInvert ? mBlurCutoff : 1.f;
+  range.mKeepSource = true;
+  return true;
+}
+
+BlurVertical::BlurVertical() : PostProEffect(sType), mHalfSize(7), mApplyNaiveDOF(false), mInvert(false), mBlurCutoff(0.3f)
+{  
+  AddShader(&mShader, "BlurVertical.xml");
+  mSupportsRenderScale = true;
+
+  //The half size can be changed at any time, have every unrolled one ready
+  for(s32 i = 1; i <= sMaxUnrolledHalfSize; ++i)
+  {
+    AddShaderVariant("BlurVertical.fs", GetBlurDefines(i));
+  }
+}
+
+void BlurVertical::CreateATB()
+{
+  //The half size picks the variant, so changing it records the stack again
+  AddStructureVarRW("", &mHalfSize, ("label='Kernel Half Size' min=1" + GetNameFormatted()).c_str());
+  AddStructureVarRW("", &mApplyNaiveDOF, ("label='Naive DOF'" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_FLOAT, &mBlurCutoff, ("label='Blur Cutoff' min=0.0 max=1.0 step=0.01" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_BOOLCPP, &mInvert, ("label='Invert'" + GetNameFormatted()).c_str());
+}
+
+b8 BlurVertical::Record(PostProCommandList& list, RenderBuffer* source, RenderBuffer* dest)
+{
+  UpdateProgram();
+  return PostProEffect::Record(list, source, dest);
+}
+
+void BlurVertical::PreBindUpdate( wfe::RenderBuffer* )
+{
+  UpdateProgram();
+}
+
+void BlurVertical::EnableUniforms( wfe::RenderBuffer* source )
+{
+  PostProStateCache* state = PostProcessingManager::sStateCache;
+
+  state->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  state->EnableTexture(WFE_GRAPHICS->GetDepthAndNormalBuffer()->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_SHADOW);
+
+  glUniform1f(mHandles.mMapSize, 1.0f / (source->GetHeight()));
+  glUniform1i(mHandles.mHalfSize, mHalfSize);
+  glUniform1f(mHandles.mBlurCutoff, mBlurCutoff);
+  glUniform1i(mHandles.mInvert, mInvert);
+  //Pixels outside the cutoff are masked out in the stencil buffer, no need to branch
+  glUniform1i(mHandles.mNaiveDOF, false);
+}
+
+b8 BlurVertical::RecordUniforms(PostProCommandList& list, RenderBuffer* source)
+{
+  list.AddTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  list.AddTexture(WFE_GRAPHICS->GetDepthAndNormalBuffer()->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_SHADOW);
+
+  list.AddUniform(mHandles.mMapSize, 1.0f / (source->GetHeight()));
+  list.AddUniform(mHandles.mHalfSize, &mHalfSize);
+  list.AddUniform(mHandles.mBlurCutoff, &mBlurCutoff);
+  list.AddUniform(mHandles.mInvert, &mInvert);
+  list.AddUniformInt(mHandles.mNaiveDOF, false);
+  return true;
+}
+
+void BlurVertical::UpdateProgram()
+{
+  mProgram = mHalfSize <= sMaxUnrolledHalfSize ? GetShaderVariant("BlurVertical.fs", GetBlurDefines(mHalfSize)) : 0;
+  mHandles.Update(GetProgramHandle());
+}
+
+b8 BlurVertical::GetDepthMask(PostProDepthMaskRange& range) const
+{
+  if(!mApplyNaiveDOF)
+  {
+    return false;
+  }
+
+  //Only blur what lies past the cutoff, the rest keeps the source image
+  range.mMinDepth = mInvert ? 0.f : mBlurCutoff;
+  range.mMaxDepth = mInvert ? mBlurCutoff : 1.f;
+  range.mKeepSource = true;
+  return true;
+}
+
+BlackWhite::BlackWhite() : PostProEffect(sType), mTolerance(.4f)
+{  
+  AddShader(&mShader, "BlackWhite.xml");
+}
+
+void BlackWhite::CreateATB()
+{
+  AddVarRW("", TW_TYPE_FLOAT, &mTolerance, ("label='Tolerance' min=0.0 step=0.001" + GetNameFormatted()).c_str());
+}
+
+void BlackWhite::EnableUniforms( wfe::RenderBuffer* source )
+{
+  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+
+  glUniform1f(mShader->GetToleranceHandle(), mTolerance);
+}
+
+b8 BlackWhite::RecordUniforms(PostProCommandList& list, RenderBuffer* source)
+{
+  list.AddTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  list.AddUniform(mShader->GetToleranceHandle(), &mTolerance);
+  return true;
+}
+
+UnsharpMaskingDepth::UnsharpMaskingDepth() : PostProEffect(sType), mLambda(.1f), mLambdaHandle(-1), mHalfSize(9)
+{  
+  AddShader(&mShader, "UnsharpMaskingDepth.xml");
+
+  //The blurred depth is a level of the depth pyramid, the unblurred image and depth come in as extra inputs
+  mUsesDepthPyramid = true;
+  AddInput("depth", Shader::WFE_SHADER_MAPTYPE_SHADOW);
+  AddInput("input", Shader::WFE_SHADER_MAPTYPE_ORIGINAL);
+}
+
+void UnsharpMaskingDepth::PrepareDevice()
+{
+  PostProEffect::PrepareDevice();
+
+  mLambdaHandle = glGetUniformLocation(mShader->GetHandle(), "uLambda");
+}
+
+void UnsharpMaskingDepth::CreateATB()
+{
+  AddVarRW("", TW_TYPE_FLOAT, &mLambda, ("label='Lambda' step=0.01" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_INT32, &mHalfSize, ("label='Kernel Half Size' min=1" + GetNameFormatted()).c_str());
+}
+
+void UnsharpMaskingDepth::EnableUniforms( wfe::RenderBuffer* )
+{
+  //Level whose texels are about as wide as the box blur that used to run here
+  PostProDepthPyramid* pyramid = PostProcessingManager::sDepthPyramid;
+  RenderBuffer* blurredDepth = pyramid->GetLevel(pyramid->GetLevelForSize(2.f * mHalfSize + 1.f));
+
+  mShader->EnableTexture(blurredDepth->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+
+  glUniform1f(mLambdaHandle, mLambda);
+}
+
+
+GaussianBlur::GaussianBlur() : PostProEffect(sType), mRadius(1.f), mRadiusHandle(-1)
+{  
+  AddShader(&mShader, "GaussianBlur.xml");
+  mSupportsRenderScale = true;
+}
+
+void GaussianBlur::PrepareDevice()
+{
+  PostProEffect::PrepareDevice();
+
+  mRadiusHandle = glGetUniformLocation(mShader->GetHandle(), "uRadius");
+}
+
+void GaussianBlur::CreateATB()
+{
+  AddVarRW("", TW_TYPE_FLOAT, &mRadius, ("label='Radius' min=0.0 step=1.0" + GetNameFormatted()).c_str());
+}
+
+void GaussianBlur::EnableUniforms( wfe::RenderBuffer* source )
+{
+  // Enable current texture map
+  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+
+  // Send uniforms for buffer height and width
+  glUniform1f(mShader->GetMapHeightHandle(), static_cast<GLfloat>(source->GetHeight()));
+  glUniform1f(mShader->GetMapWidthHandle(), static_cast<GLfloat>(source->GetWidth()));
+  glUniform1f(mRadiusHandle, mRadius);
+  //mShader->EnableTexture(WFE_GRAPHICS->GetDepthAndNormalBuffer()->GetDepthTextureHandle(), Shader::WFE_SHADER_MAPTYPE_DEPTH);
+}
+
+b8 GaussianBlur::RecordUniforms(PostProCommandList& list, RenderBuffer* source)
+{
+  list.AddTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  list.AddUniform(mShader->GetMapHeightHandle(), static_cast<GLfloat>(source->GetHeight()));
+  list.AddUniform(mShader->GetMapWidthHandle(), static_cast<GLfloat>(source->GetWidth()));
+  list.AddUniform(mRadiusHandle, &mRadius);
+  return true;
+}
+
+Laplacian::Laplacian() : PostProEffect(sType)
+{  
+  AddShader(&mShader, "Laplacian.xml");
+  mSupportsRenderScale = true;
+}
+
+void Laplacian::CreateATB()
+{
+
+}
+
+void Laplacian::EnableUniforms( wfe::RenderBuffer* source )
+{
+  // Enable current texture map
+  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+
+  // Send uniforms for buffer height and width
+  glUniform1f(mShader->GetMapHeightHandle(), static_cast<GLfloat>(source->GetHeight()));
+  glUniform1f(mShader->GetMapWidthHandle(), static_cast<GLfloat>(source->GetWidth()));
+}
+
+b8 Laplacian::RecordUniforms(PostProCommandList& list, RenderBuffer* source)
+{
+  list.AddTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  list.AddUniform(mShader->GetMapHeightHandle(), static_cast<GLfloat>(source->GetHeight()));
+  list.AddUniform(mShader->GetMapWidthHandle(), static_cast<GLfloat>(source->GetWidth()));
+  return true;
+}
+
+Sobel::Sobel() : PostProEffect(sType)
+{  
+  AddShader(&mShader, "Sobel.xml");
+  mSupportsRenderScale = true;
+}
+
+void Sobel::CreateATB()
+{
+}
+
+void Sobel::EnableUniforms( wfe::RenderBuffer* source )
+{
+  // Enable current texture map
+  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+
+  // Send uniforms for buffer height and width
+  glUniform1f(mShader->GetMapHeightHandle(), static_cast<GLfloat>(source->GetHeight()));
+  glUniform1f(mShader->GetMapWidthHandle(), static_cast<GLfloat>(source->GetWidth()));
+}
+
+b8 Sobel::RecordUniforms(PostProCommandList& list, RenderBuffer* source)
+{
+  list.AddTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  list.AddUniform(mShader->GetMapHeightHandle(), static_cast<GLfloat>(source->GetHeight()));
+  list.AddUniform(mShader->GetMapWidthHandle(), static_cast<GLfloat>(source->GetWidth()));
+  return true;
+}
+
+UnsharpMasking::UnsharpMasking() : PostProEffect(sType), mWeightage(1.f), mWeightageHandle(-1)
+{  
+  AddShader(&mShader, "UnsharpMasking.xml");
+
+  AddSubEffect(BlurHorizontal::sType, "input", "blurredH");
+  AddSubEffect(BlurVertical::sType, "blurredH", "blurred");
+
+  // Blurred image as the source, default original clean image as an extra input
+  SetSourceName("blurred");
+  AddInput("input", Shader::WFE_SHADER_MAPTYPE_ORIGINAL);
+}
+
+void UnsharpMasking::PrepareDevice()
+{
+  PostProEffect::PrepareDevice();
+
+  mWeightageHandle = glGetUniformLocation(mShader->GetHandle(), "uWeightage");
+}
+
+void UnsharpMasking::CreateATB()
+{
+  AddVarRW("", TW_TYPE_FLOAT, &mWeightage, ("label='Weightage' min=0.0 step=0.001" + GetNameFormatted()).c_str());
+}
+
+void UnsharpMasking::EnableUniforms( wfe::RenderBuffer* source )
+{
+  // Enable current texture map
+  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+
+  // Send uniforms for buffer height and width
+  glUniform1f(mShader->GetMapHeightHandle(), static_cast<GLfloat>(source->GetHeight()));
+  glUniform1f(mShader->GetMapWidthHandle(), static_cast<GLfloat>(source->GetWidth()));
+  glUniform1f(mWeightageHandle, mWeightage);
+}
+
+Negative::Negative() : PostProEffect(sType)
+{  
+  AddShader(&mShader, "Negative.xml");
+  mSupportsRenderScale = true;
+}
+
+b8 Negative::RecordUniforms(PostProCommandList& list, RenderBuffer* source)
+{
+  list.AddTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  return true;
+}
+
+HueChange::HueChange() : PostProEffect(sType), mHue(.0f), mSaturation(.0f), mValue(.0f), mHueHandle(-1), mSaturationHandle(-1), mValueHandle(-1)
+{  
+  AddShader(&mShader, "HueChange.xml");
+}
+
+void HueChange::PrepareDevice()
+{
+  PostProEffect::PrepareDevice();
+
+  mHueHandle = glGetUniformLocation(mShader->GetHandle(), "uHue");
+  mSaturationHandle = glGetUniformLocation(mShader->GetHandle(), "uSaturation");
+  mValueHandle = glGetUniformLocation(mShader->GetHandle(), "uValue");
+}
+
+void HueChange::CreateATB()
+{
+  AddVarRW("", TW_TYPE_FLOAT, &mHue, ("label='Hue' min=-1.0 max=1.0 step=0.001" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_FLOAT, &mSaturation, ("label='Saturation' min=-1.0 max=1.0 step=0.001" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_FLOAT, &mValue, ("label='Value' min=-1.0 max=1.0 step=0.001" + GetNameFormatted()).c_str());
+}
+
+void HueChange::EnableUniforms( wfe::RenderBuffer* source )
+{
+  // Enable current texture map
+  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+
+  // Send uniforms for buffer height and width
+  glUniform1f(mHueHandle, mHue);
+  glUniform1f(mSaturationHandle, mSaturation);
+  glUniform1f(mValueHandle, mValue);
+}
+
+b8 HueChange::RecordUniforms(PostProCommandList& list, RenderBuffer* source)
+{
+  list.AddTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  list.AddUniform(mHueHandle, &mHue);
+  list.AddUniform(mSaturationHandle, &mSaturation);
+  list.AddUniform(mValueHandle, &mValue);
+  return true;
+}
+
+RealisticDOF::RealisticDOF() : PostProEffect(sType), mBias(2.5), mInvert(false)
+{
+  AddShader(&mShader, "RealisticDOF.xml");
+
+  AddSubEffect(BlurHorizontal::sType, "input", "blurredH");
+  AddSubEffect(BlurVertical::sType, "blurredH", "blurred");
+
+  SetSourceName("blurred");
+  AddInput("input", Shader::WFE_SHADER_MAPTYPE_ORIGINAL);
+  AddInput("depth", Shader::WFE_SHADER_MAPTYPE_SHADOW);
+}
+
+void RealisticDOF::PrepareDevice()
+{
+  PostProEffect::PrepareDevice();
+
+  mInvertHandle = glGetUniformLocation(mShader->GetHandle(), "uInvert");
+  mBiasHandle = glGetUniformLocation(mShader->GetHandle(), "uBias");
+}
+
+void RealisticDOF::CreateATB()
+{
+  AddVarRW("", TW_TYPE_FLOAT, &mBias, ("label='Bias' min=-0.0 step=0.1" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_BOOLCPP, &mInvert, ("label='Invert'" + GetNameFormatted()).c_str());
+}
+
+void RealisticDOF::EnableUniforms( wfe::RenderBuffer* source )
+{
+  // Enable current texture map
+  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+
+  glUniform1f(mBiasHandle, mBias);
+  glUniform1i(mInvertHandle, mInvert);
+}
+
+BlurHorizontalDepth::BlurHorizontalDepth() : PostProEffect(sType), mHalfSize(5)
+{  
+  AddShader(&mShader, "BlurHorizontal.xml");
+  AddShaderVariant("BlurHorizontal.fs", GetBlurDefines(mHalfSize));
+  mSupportsRenderScale = true;
+
+  //The depth buffer is what gets blurred, bound where the blur reads its color
+  AddInput("depth", Shader::WFE_SHADER_MAPTYPE_COLOR);
+}
+
+void BlurHorizontalDepth::PreBindUpdate( wfe::RenderBuffer* )
+{
+  mProgram = mHalfSize <= sMaxUnrolledHalfSize ? GetShaderVariant("BlurHorizontal.fs", GetBlurDefines(mHalfSize)) : 0;
+  mHandles.Update(GetProgramHandle());
+}
+
+void BlurHorizontalDepth::EnableUniforms( wfe::RenderBuffer* )
+{
+  glUniform1f(mHandles.mMapSize, 1.0f / (WFE_GRAPHICS->GetDepthAndNormalBuffer()->GetWidth()));
+  glUniform1i(mHandles.mHalfSize, mHalfSize);
+  glUniform1i(mHandles.mNaiveDOF, false);
+
+  //The depth buffer always covers the whole view, the result lands in the
+  //render rect like every other one
+  glUniform2f(mHandles.mUVScale, 1.f, 1.f);
+}
+
+BlurVerticalDepth::BlurVerticalDepth() : PostProEffect(sType), mHalfSize(5)
+{  
+  AddShader(&mShader, "BlurVertical.xml");
+  AddShaderVariant("BlurVertical.fs", GetBlurDefines(mHalfSize));
+  mSupportsRenderScale = true;
+
+  //The depth buffer is what gets blurred, bound where the blur reads its color
+  AddInput("depth", Shader::WFE_SHADER_MAPTYPE_COLOR);
+}
+
+void BlurVerticalDepth::PreBindUpdate( wfe::RenderBuffer* )
+{
+  mProgram = mHalfSize <= sMaxUnrolledHalfSize ? GetShaderVariant("BlurVertical.fs", GetBlurDefines(mHalfSize)) : 0;
+  mHandles.Update(GetProgramHandle());
+}
+
+void BlurVerticalDepth::EnableUniforms( wfe::RenderBuffer* )
+{
+  glUniform1f(mHandles.mMapSize, 1.0f / (WFE_GRAPHICS->GetDepthAndNormalBuffer()->GetHeight()));
+  glUniform1i(mHandles.mHalfSize, mHalfSize);
+  glUniform1i(mHandles.mNaiveDOF, false);
+
+  //The depth buffer always covers the whole view, the result lands in the
+  //render rect like every other one
+  glUniform2f(mHandles.mUVScale, 1.f, 1.f);
+}
+
+AdditiveNoise::AdditiveNoise() : PostProEffect(sType), mNoisyTarget(0), mNoiseData(0), mNoiseWidth(0), mNoiseHeight(0), mOffsetYHandle(-1), mOffsetXHandle(-1), mBias(0.4f)
+{  
+  AddShader(&mShader, "AdditiveNoise.xml");
+
+  //PrepareHost may run on a worker, read the window size here on the render thread
+  mNoiseWidth = WFE_WINDOW->GetResoWidth();
+  mNoiseHeight = WFE_WINDOW->GetResoHeight();
+}
+
+AdditiveNoise::~AdditiveNoise()
+{
+  delete [] mNoiseData;
+
+  if(mNoisyTarget)
+  {
+    //Hand the texture back with the params every pooled target expects
+    glBindTexture(GL_TEXTURE_2D, mNoisyTarget->GetColorTextureHandle());
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    ReleaseTarget(mNoisyTarget);
+  }
+}
+
+void AdditiveNoise::PrepareHost()
+{
+  PostProEffect::PrepareHost();
+
+  if(mNoiseData)
+  {
+    return;
+  }
+
+  s32 size = 4 * mNoiseWidth * mNoiseHeight;
+  mNoiseData = new u8[size]();
+
+  f32 standardDeviation = 5.f;
+  //Own generator, this runs on a worker thread next to everything else using the global one
+  std::random_device seed;
+  std::mt19937 generator(seed());
+  std::normal_distribution<f32> distribution(0.1f, standardDeviation);
+  // Perform the noisiness
+  for(s32 i = 0; i < size; ++i)
+  {
+    //Generate amount to be added
+    f32 ran = distribution(generator);
+    mNoiseData[i] += (u8)ran;
+
+    mNoiseData[i] = Clamp<u8>(mNoiseData[i], 0, 255);
+  }
+}
+
+void AdditiveNoise::PrepareDevice()
+{
+  PostProEffect::PrepareDevice();
+
+  mOffsetXHandle = glGetUniformLocation(mShader->GetHandle(), "uOffsetX");
+  mOffsetYHandle = glGetUniformLocation(mShader->GetHandle(), "uOffsetY");
+  mBiasHandle = glGetUniformLocation(mShader->GetHandle(), "uBias");
+
+  // The noisy texture lives in a pooled target so it shows up in the memory report
+  mNoisyTarget = AcquireTarget(mNoiseWidth, mNoiseHeight);
+  //Setup texture params
+  glBindTexture(GL_TEXTURE_2D, mNoisyTarget->GetColorTextureHandle());
+  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+  // Upload to GPU
+  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, mNoiseWidth, mNoiseHeight, GL_RGBA, GL_UNSIGNED_BYTE, mNoiseData);
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  delete [] mNoiseData;
+  mNoiseData = 0;
+}
+
+void AdditiveNoise::CreateATB()
+{
+  AddVarRW("", TW_TYPE_FLOAT, &mBias, ("label='Value' min=-0.0 max=1.0 step=0.001" + GetNameFormatted()).c_str());
+}
+
+void AdditiveNoise::EnableUniforms( wfe::RenderBuffer* source )
+{
+  // Enable current texture map
+  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+
+  // Enable noisy texture map
+  mShader->EnableTexture(mNoisyTarget->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_OTHER);
+
+  // Send uniforms
+  glUniform1f(mOffsetXHandle, glm::compRand1(0.f, 1.f));
+  glUniform1f(mOffsetYHandle, glm::compRand1(0.f, 1.f));
+  glUniform1f(mBiasHandle, mBias);
+}
+
+
+
+
+BloomCombine::BloomCombine():PostProEffect(sType),
+                             m_coefP1(.15f),
+                             m_coefP1x(1.0f),
+                             m_coefP1y(1.0f),
+                             m_coefP1z(1.0f),
+                             m_coefP2(1.f)
+{
+	AddShader(&mShader, "Bloom_combine.xml");
+  AddShader(&mBlurVerticalShader, "BlurVertical.xml");
+  AddShader(&mBlurHorizontalShader, "BlurHorizontal.xml");
+  mSupportsRenderScale = true;
+
+  mThreshold = static_cast<LuminanceThreshold*>(AddSubEffect(LuminanceThreshold::sType, "input", "bright"));
+	static_cast<BlurHorizontal*>(AddSubEffect(BlurHorizontal::sType, "bright", "brightH"))->mHalfSize = 3;
+	static_cast<BlurVertical*>(AddSubEffect(BlurVertical::sType, "brightH", "bloom"))->mHalfSize = 3;
+
+  SetSourceName("bloom");
+  AddInput("input", Shader::WFE_SHADER_MAPTYPE_COLOR);
+
+  for(u32 i = 0; i < 6; ++i)
+  {
+    mRenderBuffer[i] = 0;
+  }
+}
+
+void BloomCombine::PrepareDevice()
+{
+  PostProEffect::PrepareDevice();
+
+	locC1 = glGetUniformLocation(mShader->GetHandle(),"uCoeft1") ;
+	locC2 =	glGetUniformLocation(mShader->GetHandle(),"uCoeft1x");
+	locC3 =	glGetUniformLocation(mShader->GetHandle(),"uCoeft1y");
+	locC4 =	glGetUniformLocation(mShader->GetHandle(),"uCoeft1z");
+	locC5 =	glGetUniformLocation(mShader->GetHandle(),"uCoeft2") ;
+
+  mVerticalHandles.Update(mBlurVerticalShader->GetHandle());
+  mHorizontalHandles.Update(mBlurHorizontalShader->GetHandle());
+}
+
+void BloomCombine::CreateATB()
+{
+	AddVarRW("", TW_TYPE_FLOAT, &m_coefP1, ("label='t1 Coefficient' step=0.01" + GetNameFormatted()).c_str());
+	AddVarRW("", TW_TYPE_FLOAT, &m_coefP1x, ("label='t1x Coefficient' step=0.01" + GetNameFormatted()).c_str());
+	AddVarRW("", TW_TYPE_FLOAT, &m_coefP1y, ("label='t1y Coefficient' step=0.01" + GetNameFormatted()).c_str());
+	AddVarRW("", TW_TYPE_FLOAT, &m_coefP1z, ("label='t1z Coefficient' step=0.01" + GetNameFormatted()).c_str());
+	AddVarRW("", TW_TYPE_FLOAT, &m_coefP2, ("label='t2 Coefficient' step=0.01" + GetNameFormatted()).c_str());	
+  AddStructureVarRW("", &mThreshold->mAdaptive, ("label='Auto Threshold'" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_FLOAT, &mThreshold->mThreshold, ("label='Threshold' min=0.0 step=0.01" + GetNameFormatted()).c_str());
+}
+
+s32 BloomCombine::GetSampleReach(s32 width, s32 height) const
+{
+  //The smallest bloom buffer is 256 texels over the render rect, blurred three
+  //texels each way and filtered once more when combined
+  return PostProEffect::GetSampleReach(width, height) + static_cast<s32>(ceil(4.f * std::max(width, height) / 256.f));
+}
+
+void BloomCombine::PreBindUpdate(wfe::RenderBuffer* source )
+{
+  s32 size = 1024;
+
+  for(u32 i = 0; i < 6; i += 2)
+  {
+    //Only needed until the combine pass is done, other effects reuse them afterwards
+    mRenderBuffer[i] = AcquireTransientTarget(size, size, GetColorFormat(false));
+    mRenderBuffer[i + 1] = AcquireTransientTarget(size, size, GetColorFormat(false));
+    size /= 2;
+
+    //The blur programs are shared with the blur effects, so every option is set,
+    //whatever they left behind. The source only covers the render rect, the
+    //bloom buffers are filled completely
+    WFE_GRAPHICS->SwitchShader(mBlurVerticalShader);
+    glUniform1f(mVerticalHandles.mMapSize, 1.0f / mRenderBuffer[i]->GetWidth());
+    glUniform1i(mVerticalHandles.mHalfSize, 3);
+    glUniform1i(mVerticalHandles.mNaiveDOF, false);
+    glUniform1i(mVerticalHandles.mInvert, false);
+    glUniform1i(mVerticalHandles.mCombineMode, POSTPRO_CM_REPLACE);
+    glUniform1f(mVerticalHandles.mOpacity, 1.f);
+    EnableViewportUniforms(mBlurVerticalShader);
+    mRenderBuffer[i]->Bind();
+    glBindTexture(GL_TEXTURE_2D, source->GetColorTextureHandle());
+    WFE_GRAPHICS->DrawOverScreen();
+
+    WFE_GRAPHICS->SwitchShader(mBlurHorizontalShader);
+    glUniform1f(mHorizontalHandles.mMapSize, 1.0f / (mRenderBuffer[i]->GetWidth()));
+    glUniform1i(mHorizontalHandles.mHalfSize, 3);
+    glUniform1i(mHorizontalHandles.mNaiveDOF, false);
+    glUniform1i(mHorizontalHandles.mInvert, false);
+    glUniform1i(mHorizontalHandles.mCombineMode, POSTPRO_CM_REPLACE);
+    glUniform1f(mHorizontalHandles.mOpacity, 1.f);
+    glUniform2f(mHorizontalHandles.mUVScale, 1.f, 1.f);
+    mRenderBuffer[i + 1]->Bind();
+    glBindTexture(GL_TEXTURE_2D, mRenderBuffer[i]->GetColorTextureHandle());
+    WFE_GRAPHICS->DrawOverScreen();
+  }
+}
+
+void BloomCombine::EnableUniforms( wfe::RenderBuffer* source)
+{
+  //The unbloomed input is bound to the color map by the graph
+  mShader->EnableTexture(source->GetColorTextureHandle(),Shader::WFE_SHADER_MAPTYPE_BLOOMZERO);
+  mShader->EnableTexture(mRenderBuffer[1]->GetColorTextureHandle(),Shader::WFE_SHADER_MAPTYPE_BLOOMONE);
+  mShader->EnableTexture(mRenderBuffer[3]->GetColorTextureHandle(),Shader::WFE_SHADER_MAPTYPE_BLOOMTWO);
+  mShader->EnableTexture(mRenderBuffer[5]->GetColorTextureHandle(),Shader::WFE_SHADER_MAPTYPE_BLOOMTHREE);
+
+  glUniform1f(locC1 , m_coefP1);
+  glUniform1f(locC2 , m_coefP1x);
+  glUniform1f(locC3 , m_coefP1y);
+  glUniform1f(locC4 , m_coefP1z);
+  glUniform1f(locC5 , m_coefP2);
+}
+
+LuminanceThreshold::LuminanceThreshold() : PostProEffect(sType), mAdaptive(false), mThreshold(1.f)
+{
+  AddShader(&mFixedShader, "Luminance.xml");
+  AddShader(&mAdaptiveShader, "LuminanceAdaptive.xml");
+}
+
+void LuminanceThreshold::PrepareDevice()
+{
+  PostProEffect::PrepareDevice();
+
+  UpdateShader();
+}
+
+b8 LuminanceThreshold::Record(PostProCommandList& list, RenderBuffer* source, RenderBuffer* dest)
+{
+  UpdateShader();
+  return PostProEffect::Record(list, source, dest);
+}
+
+void LuminanceThreshold::PreBindUpdate( wfe::RenderBuffer* )
+{
+  UpdateShader();
+}
+
+void LuminanceThreshold::EnableUniforms( wfe::RenderBuffer* source )
+{
+  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+
+  if(mAdaptive)
+  {
+    mShader->EnableTexture(PostProcessingManager::sExposure->GetExposure()->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_BLOOMTHREE);
+    glUniform1f(glGetUniformLocation(mShader->GetHandle(), "uThreshold"), mThreshold);
+  }
+}
+
+b8 LuminanceThreshold::RecordUniforms(PostProCommandList& list, RenderBuffer* source)
+{
+  list.AddTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+
+  if(mAdaptive)
+  {
+    //The exposure target never changes, only its contents
+    list.AddTexture(PostProcessingManager::sExposure->GetExposure()->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_BLOOMTHREE);
+    list.AddUniform(glGetUniformLocation(mShader->GetHandle(), "uThreshold"), &mThreshold);
+  }
+  return true;
+}
+
+void LuminanceThreshold::UpdateShader()
+{
+  mShader = mAdaptive ? mAdaptiveShader : mFixedShader;
+}
+
+
+OldFilm::OldFilm() : PostProEffect(sType), mSepiaVaue(1.0f), mNoiseValue(1.0f),mScratchValue(1.0f)
+										 , mInnerVignetting(0.5f), mOuterVignetting(0.9f)
+										 , mRandomValue(0.5f), mTimeLapse(1.f),m_multiplier(0.f)	
+{  
+	AddShader(&mShader, "OldFilm.xml");
+}
+
+void OldFilm::PrepareDevice()
+{
+  PostProEffect::PrepareDevice();
+
+	mSepiaHandle = glGetUniformLocation(mShader->GetHandle(),"uSpeiaValue");
+	mNoiseHandle = glGetUniformLocation(mShader->GetHandle(),"uNoiseValue");
+	mScratchHandle = glGetUniformLocation(mShader->GetHandle(),"uScratchValue");
+	mInnerVignettingHandle = glGetUniformLocation(mShader->GetHandle(),"uInnerVignetting");
+	mOuterVignettingHandle = glGetUniformLocation(mShader->GetHandle(),"uOuterVignetting");
+	mRandomValueHandle = glGetUniformLocation(mShader->GetHandle(),"uRandomValue");
+	mTimeLapseHandle = glGetUniformLocation(mShader->GetHandle(),"uTimeLapse");
+}
+
+void OldFilm::CreateATB()
+{
+	AddVarRW("", TW_TYPE_FLOAT, &mSepiaVaue, ("label='Sepia Value' step=0.01" + GetNameFormatted()).c_str());
+	AddVarRW("", TW_TYPE_FLOAT, &mNoiseValue, ("label='Noise Value' step=0.01" + GetNameFormatted()).c_str());
+	AddVarRW("", TW_TYPE_FLOAT, &mScratchValue, ("label='Scratch Value' step=0.01" + GetNameFormatted()).c_str());
+	AddVarRW("", TW_TYPE_FLOAT, &mInnerVignetting, ("label='Inner Vignetting ' step=0.01" + GetNameFormatted()).c_str());
+	AddVarRW("", TW_TYPE_FLOAT, &mOuterVignetting, ("label='Outer Vignetting' step=0.01" + GetNameFormatted()).c_str());
+	AddVarRW("", TW_TYPE_FLOAT, &mRandomValue, ("label='Random Value' step=0.01" + GetNameFormatted()).c_str());
+	AddVarRW("", TW_TYPE_FLOAT, &mTimeLapse, ("label='Time Lapse' step=0.01" + GetNameFormatted()).c_str());
+}
+
+void OldFilm::EnableUniforms( wfe::RenderBuffer* source )
+{
+	// Enable current texture map
+	mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+
+	//0.1-1.1
+	m_multiplier =  cos(WFE_FRC->GetLevelTime() / 3.f + 7.f);
+	
+	// Send uniforms
+	glUniform1f(mSepiaHandle,			mSepiaVaue);
+	glUniform1f(mNoiseHandle,			.5f + cos(WFE_FRC->GetLevelTime() / 2.f + 3.f ) * mNoiseValue) ;
+	glUniform1f(mScratchHandle,		.5f + 	cos(WFE_FRC->GetLevelTime() * 10.f  + 11.f) * mScratchValue);
+	glUniform1f(mInnerVignettingHandle, cos(WFE_FRC->GetLevelTime()) * mInnerVignetting + .1f);
+	glUniform1f(mOuterVignettingHandle, mOuterVignetting);
+	glUniform1f(mRandomValueHandle,		m_multiplier * mRandomValue / 2.f) ;
+	glUniform1f(mTimeLapseHandle,	.5f + 	cos(WFE_FRC->GetLevelTime() * 10.f + 13.f) * mTimeLapse);
+}
+
+PPSSAO::PPSSAO(): PostProEffect(sType), 
+  mAO(0),
+  mBlurSharpness(16.f),
+  mAOStrength(0.33f), 
+  mAOSampleDistance(8.f),
+  mAOScale(20.0f),
+  mAOSamples(6), 
+  mAOSamples2(2)
+{  
+  AddShader(&mShader, "SSAOComposite.xml");
+  AddShader(&mDeinterleaveShader, "SSAODeinterleave.xml");
+  AddShader(&mLayerShader, "SSAO.xml");
+  AddShader(&mReinterleaveShader, "SSAOReinterleave.xml");
+  AddShader(&mBlurShader, "SSAOBlur.xml");
+  mSupportsRenderScale = true;
+
+  //Neighbouring layers get rotations far apart, like a 4x4 dither matrix
+  static const s32 order[sLayers * sLayers] = { 0, 8, 2, 10, 12, 4, 14, 6, 3, 11, 1, 9, 15, 7, 13, 5 };
+  for(s32 i = 0; i < sLayers * sLayers; ++i)
+  {
+    f32 angle = 6.2831853f * order[i] / (sLayers * sLayers);
+    mLayerPattern[i * 4 + 0] = cos(angle);
+    mLayerPattern[i * 4 + 1] = sin(angle);
+    mLayerPattern[i * 4 + 2] = (order[i] + .5f) / (sLayers * sLayers);
+    mLayerPattern[i * 4 + 3] = 0.f;
+  }
+
+  //The effect does the occlusion itself, the engine's full resolution pass stays off
+  WFE_GRAPHICS->SetAOActive(false);
+  mUsesDepthPyramid = true;
+}
+
+PPSSAO::~PPSSAO()
+{
+  WFE_GRAPHICS->SetAOActive(false);
+}
+
+void PPSSAO::CreateATB()
+{
+  AddVarRW("", TW_TYPE_FLOAT, &WFE_GRAPHICS->mAOStrength, ("label='AO Strength' step=0.01" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_FLOAT, &WFE_GRAPHICS->mAOSampleDistance, ("label='Sample Distance' step=0.01" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_FLOAT, &WFE_GRAPHICS->mAOScale, ("label='AO Scale' step=0.01" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_INT32, &WFE_GRAPHICS->mAOSamples, ("label='AO Samples' min=1 max=16" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_INT32, &WFE_GRAPHICS->mAOSamples2, ("label='AO Samples2' min=1 max=8" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_FLOAT, &mBlurSharpness, ("label='Blur Sharpness' min=0.0 step=0.5" + GetNameFormatted()).c_str());
+}
+
+/*****************************************************************************/
+/*!
+Occlusion at half resolution. The half resolution depth is split into 4x4
+layers, each a sixteenth of the pixels, laid out side by side in one
+target. Every layer uses a single sample pattern, so neighbouring fragments
+read neighbouring texels and the texture cache holds up at large sample
+distances. The layers are put back together and blurred along each axis,
+with weights falling off across depth edges
+*/
+/*****************************************************************************/
+s32 PPSSAO::GetSampleReach(s32, s32) const
+{
+  //Samples out to the sample distance, the blur adds four pixels
+  return static_cast<s32>(ceil(WFE_GRAPHICS->mAOSampleDistance)) + 5;
+}
+
+void PPSSAO::PreBindUpdate( wfe::RenderBuffer* source )
+{
+  s32 halfWidth = std::max(1, source->GetWidth() / 2);
+  s32 halfHeight = std::max(1, source->GetHeight() / 2);
+  s32 halfRectWidth = std::max(1, sRenderWidth / 2);
+  s32 halfRectHeight = std::max(1, sRenderHeight / 2);
+  s32 layerWidth = (halfRectWidth + sLayers - 1) / sLayers;
+  s32 layerHeight = (halfRectHeight + sLayers - 1) / sLayers;
+
+  //Linear depth in the layers, occlusion and depth after that
+  RenderBuffer* layers = AcquireTransientTarget(layerWidth * sLayers, layerHeight * sLayers, RT_FORMAT_RGBA16F);
+  RenderBuffer* layersAO = AcquireTransientTarget(layerWidth * sLayers, layerHeight * sLayers, RT_FORMAT_RGBA16F);
+  RenderBuffer* blurred = AcquireTransientTarget(halfWidth, halfHeight, RT_FORMAT_RGBA16F);
+  mAO = AcquireTransientTarget(halfWidth, halfHeight, RT_FORMAT_RGBA16F);
+
+  Camera * camera = WFE_CAMERA->GetActiveCamera();
+
+  //Split the half resolution level of the depth pyramid into the layers
+  WFE_GRAPHICS->SwitchShader(mDeinterleaveShader);
+  mDeinterleaveShader->EnableTexture(PostProcessingManager::sDepthPyramid->GetLevel(0)->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_SHADOW);
+  glUniform2f(glGetUniformLocation(mDeinterleaveShader->GetHandle(), "uLayerSize"), static_cast<f32>(layerWidth), static_cast<f32>(layerHeight));
+  glUniform2f(glGetUniformLocation(mDeinterleaveShader->GetHandle(), "uHalfRect"), static_cast<f32>(halfRectWidth), static_cast<f32>(halfRectHeight));
+  glUniform1f(glGetUniformLocation(mDeinterleaveShader->GetHandle(), "uCameraNear"), camera->GetNearPlaneDistance());
+  glUniform1f(glGetUniformLocation(mDeinterleaveShader->GetHandle(), "uCameraFar"), camera->GetFarPlaneDistance());
+  layers->Bind();
+  glViewport(0, 0, layerWidth * sLayers, layerHeight * sLayers);
+  WFE_GRAPHICS->DrawOverScreen();
+
+  //Occlusion per layer, sampling only inside the layer
+  WFE_GRAPHICS->SwitchShader(mLayerShader);
+  mLayerShader->EnableTexture(layers->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  glUniform2f(glGetUniformLocation(mLayerShader->GetHandle(), "uLayerSize"), static_cast<f32>(layerWidth), static_cast<f32>(layerHeight));
+  glUniform4fv(glGetUniformLocation(mLayerShader->GetHandle(), "uLayerPattern"), sLayers * sLayers, mLayerPattern);
+  glUniform1f(glGetUniformLocation(mLayerShader->GetHandle(), "uSampleDistance"), WFE_GRAPHICS->mAOSampleDistance);
+  glUniform1f(glGetUniformLocation(mLayerShader->GetHandle(), "uAOScale"), WFE_GRAPHICS->mAOScale);
+  glUniform1i(glGetUniformLocation(mLayerShader->GetHandle(), "uDirections"), Clamp<s32>(WFE_GRAPHICS->mAOSamples, 1, 16));
+  glUniform1i(glGetUniformLocation(mLayerShader->GetHandle(), "uSteps"), Clamp<s32>(WFE_GRAPHICS->mAOSamples2, 1, 8));
+  layersAO->Bind();
+  glViewport(0, 0, layerWidth * sLayers, layerHeight * sLayers);
+  WFE_GRAPHICS->DrawOverScreen();
+
+  //Back to half resolution
+  WFE_GRAPHICS->SwitchShader(mReinterleaveShader);
+  mReinterleaveShader->EnableTexture(layersAO->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  glUniform2f(glGetUniformLocation(mReinterleaveShader->GetHandle(), "uLayerSize"), static_cast<f32>(layerWidth), static_cast<f32>(layerHeight));
+  mAO->Bind();
+  glViewport(0, 0, halfRectWidth, halfRectHeight);
+  WFE_GRAPHICS->DrawOverScreen();
+
+  DrawBlurPass(mAO, blurred, 1.f, 0.f, halfWidth, halfHeight, halfRectWidth, halfRectHeight);
+  DrawBlurPass(blurred, mAO, 0.f, 1.f, halfWidth, halfHeight, halfRectWidth, halfRectHeight);
+}
+
+void PPSSAO::DrawBlurPass(wfe::RenderBuffer* source, wfe::RenderBuffer* dest, f32 dirX, f32 dirY, s32 halfWidth, s32 halfHeight, s32 halfRectWidth, s32 halfRectHeight)
+{
+  WFE_GRAPHICS->SwitchShader(mBlurShader);
+  mBlurShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  glUniform2f(glGetUniformLocation(mBlurShader->GetHandle(), "uDirection"), dirX / halfWidth, dirY / halfHeight);
+  glUniform2f(GetUVScaleHandle(mBlurShader->GetHandle()), static_cast<f32>(halfRectWidth) / halfWidth, static_cast<f32>(halfRectHeight) / halfHeight);
+  glUniform2f(glGetUniformLocation(mBlurShader->GetHandle(), "uMaxUV"), (halfRectWidth - .5f) / halfWidth, (halfRectHeight - .5f) / halfHeight);
+  glUniform1f(glGetUniformLocation(mBlurShader->GetHandle(), "uSharpness"), mBlurSharpness);
+  dest->Bind();
+  glViewport(0, 0, halfRectWidth, halfRectHeight);
+  WFE_GRAPHICS->DrawOverScreen();
+}
+
+void PPSSAO::EnableUniforms( wfe::RenderBuffer* source)
+{
+  s32 halfWidth = std::max(1, source->GetWidth() / 2);
+  s32 halfHeight = std::max(1, source->GetHeight() / 2);
+  s32 halfRectWidth = std::max(1, sRenderWidth / 2);
+  s32 halfRectHeight = std::max(1, sRenderHeight / 2);
+
+  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  mShader->EnableTexture(mAO->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_BLOOMONE);
+  glUniform2f(glGetUniformLocation(mShader->GetHandle(), "uAOUVScale"), static_cast<f32>(halfRectWidth) / halfWidth, static_cast<f32>(halfRectHeight) / halfHeight);
+  glUniform1f(glGetUniformLocation(mShader->GetHandle(), "uAOStrength"), WFE_GRAPHICS->mAOStrength);
+}
+
+
+Fog::Fog() : PostProEffect(sType), mFogTarget(0), mQuadBuffer(0), mAttribsValid(false), mRaysValid(false), mFov(0.f), mAspect(0.f), mNear(0.f), mFar(0.f), mResolutionDivisor(2)
+{  
+    AddShader(&mShader, "FogUpsample.xml");
+    AddShader(&mFogShader, "Fog.xml");
+    mSupportsRenderScale = true;
+    mUsesDepthPyramid = true;
+
+    AddInput("depth", Shader::WFE_SHADER_MAPTYPE_SHADOW);
+}
+
+Fog::~Fog()
+{
+    if(mQuadBuffer)
+    {
+        glDeleteBuffers(1, &mQuadBuffer);
+    }
+}
+
+void Fog::PrepareDevice()
+{
+    PostProEffect::PrepareDevice();
+
+    mCameraViewVecHandle = glGetUniformLocation(mFogShader->GetHandle(),"uCameraViewVec");
+    mCameraEyePosHandle = glGetUniformLocation(mFogShader->GetHandle(),"uCameraEyePos");  
+    mCameraNear = glGetUniformLocation(mFogShader->GetHandle(),"uCameraNear");  
+    mCameraFar = glGetUniformLocation(mFogShader->GetHandle(),"uCameraFar");
+    mMaxDepthHandle = glGetUniformLocation(mFogShader->GetHandle(),"uMaxDepth");
+    if(mCameraEyePosHandle == -1)
+    {
+        assert(0);
+    }
+    if(mCameraViewVecHandle == -1)
+    {
+        assert(0);
+    }
+
+    mVertexAttrib = glGetAttribLocation(mFogShader->GetHandle(), "aVertex");
+    mTexCoordAttrib = glGetAttribLocation(mFogShader->GetHandle(), "aTexCoord");
+    mFrustumRayAttrib = glGetAttribLocation(mFogShader->GetHandle(), "aFrustumRay");
+    mAttribsValid = mVertexAttrib != -1 && mTexCoordAttrib != -1 && mFrustumRayAttrib != -1;
+    if(!mAttribsValid)
+    {
+        WFE_LOGGER_POPUP << "Fog shader is missing a vertex attribute, fog is disabled" << std::endl;
+    }
+
+    mLowResSizeHandle = glGetUniformLocation(mShader->GetHandle(), "uLowResSize");
+    mLowResRectHandle = glGetUniformLocation(mShader->GetHandle(), "uLowResRect");
+
+    // Quad with the frustum rays, filled in when the camera changes
+    glGenBuffers(1, &mQuadBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, mQuadBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(f32) * sQuadVertexSize * 4, 0, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Fog::CreateATB()
+{
+    AddVarRW("", TW_TYPE_INT32, &mResolutionDivisor, ("label='Resolution Divisor' min=1 max=4" + GetNameFormatted()).c_str());
+}
+
+const f32 Fog::sSkyDepth = 0.99999f;
+
+b8 Fog::GetDepthMask(PostProDepthMaskRange& range) const
+{
+  //Skip the sky. Those pixels stay cleared, so the fog adds nothing there
+  range.mMinDepth = 0.f;
+  range.mMaxDepth = sSkyDepth;
+  range.mKeepSource = false;
+  return true;
+}
+
+/*****************************************************************************/
+/*!
+Evaluates the fog at a fraction of the resolution. Fog barely changes from
+pixel to pixel, the upsample in the main pass brings the edges back
+*/
+/*****************************************************************************/
+void Fog::PreBindUpdate( wfe::RenderBuffer* source )
+{
+    s32 divisor = Clamp<s32>(mResolutionDivisor, 1, 4);
+    s32 lowWidth = std::max(1, source->GetWidth() / divisor);
+    s32 lowHeight = std::max(1, source->GetHeight() / divisor);
+    s32 lowRectWidth = std::max(1, sRenderWidth / divisor);
+    s32 lowRectHeight = std::max(1, sRenderHeight / divisor);
+
+    UpdateFrustumRays(source);
+
+    // Fog factor and the depth it was computed at, for the upsample
+    mFogTarget = AcquireTransientTarget(lowWidth, lowHeight, RT_FORMAT_RGBA16F);
+
+    //Average depth of the pixels each low resolution texel covers
+    RenderBuffer* depth = WFE_GRAPHICS->GetDepthAndNormalBuffer();
+    if(divisor > 1)
+    {
+        PostProDepthPyramid* pyramid = PostProcessingManager::sDepthPyramid;
+        depth = pyramid->GetLevel(pyramid->GetLevelForSize(static_cast<f32>(divisor)));
+    }
+
+    mFogTarget->Bind();
+    glViewport(0, 0, lowRectWidth, lowRectHeight);
+
+    if(!mAttribsValid)
+    {
+        //No rays to march along, leave the whole target without fog
+        GLfloat clearColor[4];
+        glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+        glClearColor(0.f, 0.f, 0.f, 0.f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+    }
+    else
+    {
+        WFE_GRAPHICS->SwitchShader(mFogShader);
+        mFogShader->EnableTexture(depth->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_SHADOW);
+
+        Camera * camera = WFE_CAMERA->GetActiveCamera();
+        Vec3 camPos = camera->GetEyePos();
+        glUniform3f(mCameraViewVecHandle, mViewVec.x, mViewVec.y, mViewVec.z);
+        glUniform3f(mCameraEyePosHandle, camPos.x, camPos.y, camPos.z);
+        glUniform1f(mCameraNear, mNear);
+        glUniform1f(mCameraFar, mFar);
+        //Same cut as the depth mask of the main pass, the sky stays fog free
+        glUniform1f(mMaxDepthHandle, sSkyDepth);
+
+        DrawFogQuad();
+    }
+
+    mLowResSize[0] = static_cast<f32>(lowWidth);
+    mLowResSize[1] = static_cast<f32>(lowHeight);
+    mLowResRect[0] = static_cast<f32>(lowRectWidth);
+    mLowResRect[1] = static_cast<f32>(lowRectHeight);
+}
+
+void Fog::EnableUniforms( wfe::RenderBuffer* )
+{
+    // Depth comes from the graph
+    mShader->EnableTexture(mFogTarget->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_BLOOMONE);
+
+    glUniform2fv(mLowResSizeHandle, 1, mLowResSize);
+    glUniform2fv(mLowResRectHandle, 1, mLowResRect);
+}
+
+/*****************************************************************************/
+/*!
+Recomputes the rays through the corners of the near plane, only when the
+camera or the aspect ratio changed since last frame
+*/
+/*****************************************************************************/
+void Fog::UpdateFrustumRays( wfe::RenderBuffer* source )
+{
+    Camera * camera = WFE_CAMERA->GetActiveCamera();
+
+    f32 w = static_cast<f32>(source->GetWidth());
+    f32 h = static_cast<f32>(source->GetHeight()); 
+    f32 aspect = w / h;
+
+    if(mRaysValid &&
+       mWorldToView == camera->GetWorldToViewMtx() &&
+       mFov == camera->GetFov() &&
+       mAspect == aspect &&
+       mNear == camera->GetNearPlaneDistance() &&
+       mFar == camera->GetFarPlaneDistance())
+    {
+        return;
+    }
+
+    mWorldToView = camera->GetWorldToViewMtx();
+    mFov = camera->GetFov();
+    mAspect = aspect;
+    mNear = camera->GetNearPlaneDistance();
+    mFar = camera->GetFarPlaneDistance();
+    mRaysValid = true;
+
+    Matrix4 viewToWorld = glm::inverse(mWorldToView);
+
+    Vec3 nearCenter = camera->GetViewVec() * mNear * 1.2f;
+    nearCenter = Vec3(viewToWorld * Vec4(nearCenter, 0));
+    mViewVec = -nearCenter;
+
+    float distEyeToNearPlane = glm::length(nearCenter - camera->GetEyePos());
+    float nearHalfHeight = tan(mFov * 0.5f/180.f) * distEyeToNearPlane;
+    float nearHalfWidth = nearHalfHeight * mAspect;
+
+    Vec3 up = camera->GetUpVec() * nearHalfHeight;
+    Vec3 side = camera->GetSideVec() * nearHalfWidth;
+    Vec3 bottomLeft = Vec3(viewToWorld * Vec4(nearCenter - up - side, 0));
+    Vec3 bottomRight = Vec3(viewToWorld * Vec4(nearCenter - up + side, 0));
+    Vec3 topLeft = Vec3(viewToWorld * Vec4(nearCenter + up - side, 0));
+    Vec3 topRight = Vec3(viewToWorld * Vec4(nearCenter + up + side, 0));
+
+    // Triangle strip, position xyz, tex coord uv, frustum ray xyz
+    f32 quad[sQuadVertexSize * 4] =
+    {
+      -1.f, -1.f, 0.f,  0.f, 0.f,  bottomLeft.x, bottomLeft.y, bottomLeft.z,
+       1.f, -1.f, 0.f,  1.f, 0.f,  bottomRight.x, bottomRight.y, bottomRight.z,
+      -1.f,  1.f, 0.f,  0.f, 1.f,  topLeft.x, topLeft.y, topLeft.z,
+       1.f,  1.f, 0.f,  1.f, 1.f,  topRight.x, topRight.y, topRight.z
+    };
+
+    glBindBuffer(GL_ARRAY_BUFFER, mQuadBuffer);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(quad), quad);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Fog::DrawFogQuad()
+{
+    GLsizei stride = sizeof(f32) * sQuadVertexSize;
+
+    glBindBuffer(GL_ARRAY_BUFFER, mQuadBuffer);
+    glEnableVertexAttribArray(mVertexAttrib);
+    glEnableVertexAttribArray(mTexCoordAttrib);
+    glEnableVertexAttribArray(mFrustumRayAttrib);
+    glVertexAttribPointer(mVertexAttrib, 3, GL_FLOAT, GL_FALSE, stride, 0);
+    glVertexAttribPointer(mTexCoordAttrib, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(sizeof(f32) * 3));
+    glVertexAttribPointer(mFrustumRayAttrib, 3, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(sizeof(f32) * 5));
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    glDisableVertexAttribArray(mVertexAttrib);
+    glDisableVertexAttribArray(mTexCoordAttrib);
+    glDisableVertexAttribArray(mFrustumRayAttrib);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+Tonemap::Tonemap() : PostProEffect(sType), mExposure(1.f), mFilmic(true), mAutoExposure(false), mExposureHandle(-1), mFilmicHandle(-1), mAutoExposureHandle(-1)
+{
+  AddShader(&mShader, "Tonemap.xml");
+  mSupportsRenderScale = true;
+
+  mOutputsLDR = true;
+}
+
+void Tonemap::PrepareDevice()
+{
+  PostProEffect::PrepareDevice();
+
+  mExposureHandle = glGetUniformLocation(mShader->GetHandle(), "uExposure");
+  mFilmicHandle = glGetUniformLocation(mShader->GetHandle(), "uFilmic");
+  mAutoExposureHandle = glGetUniformLocation(mShader->GetHandle(), "uAutoExposure");
+}
+
+void Tonemap::CreateATB()
+{
+  PostProExposureSettings& settings = PostProcessingManager::sExposure->GetSettings();
+
+  AddVarRW("", TW_TYPE_FLOAT, &mExposure, ("label='Exposure' min=0.0 step=0.01" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_BOOLCPP, &mFilmic, ("label='Filmic'" + GetNameFormatted()).c_str());
+  AddStructureVarRW("", &mAutoExposure, ("label='Auto Exposure'" + GetNameFormatted()).c_str());
+  //Shared by every effect using the automatic exposure
+  AddVarRW("", TW_TYPE_FLOAT, &settings.mKey, ("label='Exposure Key' min=0.01 step=0.01" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_FLOAT, &settings.mAdaptationSpeed, ("label='Adaptation Speed' min=0.0 step=0.1" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_FLOAT, &settings.mMinExposure, ("label='Min Exposure' min=0.0 step=0.01" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_FLOAT, &settings.mMaxExposure, ("label='Max Exposure' min=0.0 step=0.1" + GetNameFormatted()).c_str());
+}
+
+void Tonemap::EnableUniforms( wfe::RenderBuffer* source )
+{
+  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  mShader->EnableTexture(PostProcessingManager::sExposure->GetExposure()->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_BLOOMTHREE);
+
+  glUniform1f(mExposureHandle, mExposure);
+  glUniform1i(mFilmicHandle, mFilmic);
+  glUniform1i(mAutoExposureHandle, mAutoExposure);
+}
+
+b8 Tonemap::RecordUniforms(PostProCommandList& list, RenderBuffer* source)
+{
+  list.AddTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  //The exposure target never changes, only its contents
+  list.AddTexture(PostProcessingManager::sExposure->GetExposure()->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_BLOOMTHREE);
+  list.AddUniform(mExposureHandle, &mExposure);
+  list.AddUniform(mFilmicHandle, &mFilmic);
+  list.AddUniform(mAutoExposureHandle, &mAutoExposure);
+  return true;
+}
+
+BokehDOF::BokehDOF() : PostProEffect(sType), mBokeh(0), mFocusDepth(0.3f), mFocusRange(0.1f), mMaxCoC(8.f), mSamples(24)
+{
+  AddShader(&mShader, "BokehDOF.xml");
+  AddShader(&mCoCShader, "BokehCoC.xml");
+  AddShader(&mTileShader, "BokehTiles.xml");
+  AddShader(&mGatherShader, "BokehGather.xml");
+  mSupportsRenderScale = true;
+
+  AddInput("depth", Shader::WFE_SHADER_MAPTYPE_SHADOW);
+}
+
+void BokehDOF::CreateATB()
+{
+  AddVarRW("", TW_TYPE_FLOAT, &mFocusDepth, ("label='Focus Depth' min=0.0 max=1.0 step=0.01" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_FLOAT, &mFocusRange, ("label='Focus Range' min=0.001 step=0.01" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_FLOAT, &mMaxCoC, ("label='Max CoC' min=0.0 max=16.0 step=0.5" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_INT32, &mSamples, ("label='Samples' min=1 max=64" + GetNameFormatted()).c_str());
+}
+
+/*****************************************************************************/
+/*!
+CoC pass, tile classification and the gather blur, all below full resolution.
+The targets are half the size of the source, only the part matching the
+render rect is drawn
+*/
+/*****************************************************************************/
+s32 BokehDOF::GetSampleReach(s32, s32) const
+{
+  //Tiles look at their neighbours, then the gather reaches out by the CoC. Both
+  //are in half resolution pixels
+  f32 coc = std::min(mMaxCoC, static_cast<f32>(sTileSize));
+  return 2 * (sTileSize + static_cast<s32>(ceil(coc))) + 2;
+}
+
+void BokehDOF::PreBindUpdate( wfe::RenderBuffer* source )
+{
+  s32 halfWidth = std::max(1, source->GetWidth() / 2);
+  s32 halfHeight = std::max(1, source->GetHeight() / 2);
+  s32 halfRectWidth = std::max(1, sRenderWidth / 2);
+  s32 halfRectHeight = std::max(1, sRenderHeight / 2);
+  s32 tilesWidth = (halfWidth + sTileSize - 1) / sTileSize;
+  s32 tilesHeight = (halfHeight + sTileSize - 1) / sTileSize;
+  s32 tileRectWidth = (halfRectWidth + sTileSize - 1) / sTileSize;
+  s32 tileRectHeight = (halfRectHeight + sTileSize - 1) / sTileSize;
+
+  //CoC needs more than 8 bits, color may be HDR
+  RenderBuffer* coc = AcquireTransientTarget(halfWidth, halfHeight, RT_FORMAT_RGBA16F);
+  RenderBuffer* tiles = AcquireTransientTarget(tilesWidth, tilesHeight, RT_FORMAT_RGBA16F);
+  mBokeh = AcquireTransientTarget(halfWidth, halfHeight, GetColorFormat(false));
+
+  //Half resolution color and CoC
+  WFE_GRAPHICS->SwitchShader(mCoCShader);
+  mCoCShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  mCoCShader->EnableTexture(WFE_GRAPHICS->GetDepthAndNormalBuffer()->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_SHADOW);
+  EnableViewportUniforms(mCoCShader);
+  EnableFocusUniforms(mCoCShader);
+  coc->Bind();
+  glViewport(0, 0, halfRectWidth, halfRectHeight);
+  WFE_GRAPHICS->DrawOverScreen();
+
+  //Min/max CoC per tile
+  WFE_GRAPHICS->SwitchShader(mTileShader);
+  mTileShader->EnableTexture(coc->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  glUniform1i(glGetUniformLocation(mTileShader->GetHandle(), "uTileSize"), sTileSize);
+  glUniform2f(glGetUniformLocation(mTileShader->GetHandle(), "uCoCTexelSize"), 1.f / halfWidth, 1.f / halfHeight);
+  glUniform2f(glGetUniformLocation(mTileShader->GetHandle(), "uCoCMaxUV"), (halfRectWidth - .5f) / halfWidth, (halfRectHeight - .5f) / halfHeight);
+  tiles->Bind();
+  glViewport(0, 0, tileRectWidth, tileRectHeight);
+  WFE_GRAPHICS->DrawOverScreen();
+
+  //Gather, in focus tiles return early
+  WFE_GRAPHICS->SwitchShader(mGatherShader);
+  mGatherShader->EnableTexture(coc->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  mGatherShader->EnableTexture(tiles->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_BLOOMONE);
+  glUniform1i(glGetUniformLocation(mGatherShader->GetHandle(), "uTileSize"), sTileSize);
+  glUniform1i(glGetUniformLocation(mGatherShader->GetHandle(), "uSamples"), mSamples);
+  glUniform2f(glGetUniformLocation(mGatherShader->GetHandle(), "uCoCTexelSize"), 1.f / halfWidth, 1.f / halfHeight);
+  glUniform2f(glGetUniformLocation(mGatherShader->GetHandle(), "uCoCMaxUV"), (halfRectWidth - .5f) / halfWidth, (halfRectHeight - .5f) / halfHeight);
+  glUniform2f(glGetUniformLocation(mGatherShader->GetHandle(), "uTileTexelSize"), 1.f / tilesWidth, 1.f / tilesHeight);
+  glUniform2f(glGetUniformLocation(mGatherShader->GetHandle(), "uTileMaxUV"), (tileRectWidth - .5f) / tilesWidth, (tileRectHeight - .5f) / tilesHeight);
+  mBokeh->Bind();
+  glViewport(0, 0, halfRectWidth, halfRectHeight);
+  WFE_GRAPHICS->DrawOverScreen();
+}
+
+void BokehDOF::EnableUniforms( wfe::RenderBuffer* source )
+{
+  // Sharp image, the depth comes from the graph
+  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  mShader->EnableTexture(mBokeh->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_BLOOMONE);
+
+  EnableFocusUniforms(mShader);
+}
+
+void BokehDOF::EnableFocusUniforms(wfe::Shader* shader)
+{
+  glUniform1f(glGetUniformLocation(shader->GetHandle(), "uFocusDepth"), mFocusDepth);
+  glUniform1f(glGetUniformLocation(shader->GetHandle(), "uFocusRange"), mFocusRange);
+  //The CoC shaders work in half resolution pixels
+  glUniform1f(glGetUniformLocation(shader->GetHandle(), "uMaxCoC"), std::min(mMaxCoC, static_cast<f32>(sTileSize)));
+}
+
+SATBlur::SATBlur() : PostProEffect(sType), mTable(0), mMean(0), mTableWidth(0), mTableHeight(0), mRadius(8.f), mDepthRadius(false), mFocusDepth(0.3f), mFocusRange(0.1f)
+{
+  AddShader(&mShader, "SATBlur.xml");
+  AddShader(&mPrefixShader, "SATPrefix.xml");
+  AddShader(&mMeanShader, "SATMean.xml");
+  mSupportsRenderScale = true;
+
+  AddInput("depth", Shader::WFE_SHADER_MAPTYPE_SHADOW);
+}
+
+void SATBlur::CreateATB()
+{
+  AddVarRW("", TW_TYPE_FLOAT, &mRadius, ("label='Radius' min=0.0 step=0.5" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_BOOLCPP, &mDepthRadius, ("label='Radius From Depth'" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_FLOAT, &mFocusDepth, ("label='Focus Depth' min=0.0 max=1.0 step=0.01" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_FLOAT, &mFocusRange, ("label='Focus Range' min=0.001 step=0.01" + GetNameFormatted()).c_str());
+}
+
+/*****************************************************************************/
+/*!
+Builds the table by recursive doubling, every pass adds sRadix texels that are
+sRadix times further apart than in the pass before. Horizontal passes first,
+then vertical ones over their result. The table is one texel larger than the
+render rect, its first row and column hold the empty sums. The image's mean is
+taken off first, sums of values around 0 keep more of the float precision than
+sums of colors, whatever the scene's brightness
+*/
+/*****************************************************************************/
+void SATBlur::PreBindUpdate( wfe::RenderBuffer* source )
+{
+  mTableWidth = source->GetWidth() + 1;
+  mTableHeight = source->GetHeight() + 1;
+  s32 rectWidth = sRenderWidth + 1;
+  s32 rectHeight = sRenderHeight + 1;
+
+  //RGBA16F runs out of precision after a few hundred texels
+  RenderBuffer* targets[2] =
+  {
+    AcquireTransientTarget(mTableWidth, mTableHeight, RT_FORMAT_RGBA32F),
+    AcquireTransientTarget(mTableWidth, mTableHeight, RT_FORMAT_RGBA32F)
+  };
+
+  mMean = AcquireTransientTarget(1, 1, RT_FORMAT_RGBA32F);
+  WFE_GRAPHICS->SwitchShader(mMeanShader);
+  mMeanShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  glUniform2f(glGetUniformLocation(mMeanShader->GetHandle(), "uImageSize"), static_cast<f32>(sRenderWidth), static_cast<f32>(sRenderHeight));
+  mMean->Bind();
+  glViewport(0, 0, 1, 1);
+  WFE_GRAPHICS->DrawOverScreen();
+
+  RenderBuffer* read = source;
+  u32 write = 0;
+
+  WFE_GRAPHICS->SwitchShader(mPrefixShader);
+  mPrefixShader->EnableTexture(mMean->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_BLOOMONE);
+
+  for(s32 step = 1; step < rectWidth; step *= sRadix)
+  {
+    DrawPrefixPass(read, targets[write], step, 0, read == source);
+    read = targets[write];
+    write ^= 1;
+  }
+
+  for(s32 step = 1; step < rectHeight; step *= sRadix)
+  {
+    DrawPrefixPass(read, targets[write], 0, step, false);
+    read = targets[write];
+    write ^= 1;
+  }
+
+  mTable = read;
+}
+
+void SATBlur::DrawPrefixPass(wfe::RenderBuffer* source, wfe::RenderBuffer* dest, s32 stepX, s32 stepY, b8 firstPass)
+{
+  GLuint program = mPrefixShader->GetHandle();
+
+  mPrefixShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  glUniform2f(glGetUniformLocation(program, "uStep"), static_cast<f32>(stepX), static_cast<f32>(stepY));
+  glUniform2f(glGetUniformLocation(program, "uSourceSize"), static_cast<f32>(source->GetWidth()), static_cast<f32>(source->GetHeight()));
+  glUniform1i(glGetUniformLocation(program, "uFirstPass"), firstPass);
+
+  dest->Bind();
+  glViewport(0, 0, sRenderWidth + 1, sRenderHeight + 1);
+  WFE_GRAPHICS->DrawOverScreen();
+}
+
+void SATBlur::EnableUniforms( wfe::RenderBuffer* source )
+{
+  PostProStateCache* state = PostProcessingManager::sStateCache;
+  GLuint program = GetProgramHandle();
+
+  // The table instead of the source, the depth comes from the graph. The source
+  // is still read for radii below a pixel
+  state->EnableTexture(mTable->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  state->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_BLOOMZERO);
+  state->EnableTexture(mMean->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_BLOOMONE);
+
+  glUniform2f(glGetUniformLocation(program, "uImageSize"), static_cast<f32>(sRenderWidth), static_cast<f32>(sRenderHeight));
+  glUniform1f(glGetUniformLocation(program, "uRadius"), mRadius);
+  glUniform1i(glGetUniformLocation(program, "uDepthRadius"), mDepthRadius);
+  glUniform1f(glGetUniformLocation(program, "uFocusDepth"), mFocusDepth);
+  glUniform1f(glGetUniformLocation(program, "uFocusRange"), mFocusRange);
+}
+
+void TW_CALL SetConvolutionPresetCB(const void *value, void *clientData)
+{ 
+  static_cast<Convolution*>(clientData)->LoadPreset(*static_cast<const s32*>(value));
+}
+
+void TW_CALL GetConvolutionPresetCB(void *value, void *clientData)
+{ 
+  *static_cast<s32*>(value) = static_cast<Convolution*>(clientData)->GetPreset();
+}
+
+void TW_CALL SetConvolutionKernelCB(const void *value, void *clientData)
+{ 
+  static_cast<Convolution*>(clientData)->SetKernelText(static_cast<cstr>(value));
+}
+
+void TW_CALL GetConvolutionKernelCB(void *value, void *clientData)
+{ 
+  strncpy(static_cast<char*>(value), static_cast<Convolution*>(clientData)->GetKernelText(), Convolution::sTextSize);
+}
+
+void TW_CALL GetConvolutionRankCB(void *value, void *clientData)
+{ 
+  *static_cast<s32*>(value) = static_cast<Convolution*>(clientData)->GetRank();
+}
+
+void TW_CALL GetConvolutionTapsCB(void *value, void *clientData)
+{ 
+  *static_cast<u32*>(value) = static_cast<Convolution*>(clientData)->GetTapCount();
+}
+
+//Tap layout of Convolution.fs, x and y offset in texels and the weight
+static void AddConvolutionTap(std::vector<f32>& taps, s32 x, s32 y, f64 weight)
+{
+  taps.push_back(static_cast<f32>(x));
+  taps.push_back(static_cast<f32>(y));
+  taps.push_back(static_cast<f32>(weight));
+  taps.push_back(0.f);
+}
+
+/*****************************************************************************/
+/*!
+One sided Jacobi SVD. Columns of a are rotated in pairs until they are
+orthogonal, the rotations pile up in v. Afterwards a = U * S and
+kernel = U * S * V^T, the column norms are the singular values
+*/
+/*****************************************************************************/
+static void FactorKernel(const std::vector<f32>& kernel, s32 size, std::vector<f64>& a, std::vector<f64>& v)
+{
+  a.assign(kernel.begin(), kernel.end());
+  v.assign(size * size, 0.0);
+  for(s32 i = 0; i < size; ++i)
+  {
+    v[i * size + i] = 1.0;
+  }
+
+  for(s32 sweep = 0; sweep < 32; ++sweep)
+  {
+    b8 rotated = false;
+
+    for(s32 p = 0; p < size - 1; ++p)
+    {
+      for(s32 q = p + 1; q < size; ++q)
+      {
+        f64 alpha = 0.0;
+        f64 beta = 0.0;
+        f64 gamma = 0.0;
+        for(s32 i = 0; i < size; ++i)
+        {
+          alpha += a[i * size + p] * a[i * size + p];
+          beta += a[i * size + q] * a[i * size + q];
+          gamma += a[i * size + p] * a[i * size + q];
+        }
+
+        if(std::abs(gamma) <= 1e-12 * std::sqrt(alpha * beta) || gamma == 0.0)
+        {
+          continue;
+        }
+        rotated = true;
+
+        f64 zeta = (beta - alpha) / (2.0 * gamma);
+        f64 t = (zeta < 0.0 ? -1.0 : 1.0) / (std::abs(zeta) + std::sqrt(1.0 + zeta * zeta));
+        f64 c = 1.0 / std::sqrt(1.0 + t * t);
+        f64 s = c * t;
+
+        for(s32 i = 0; i < size; ++i)
+        {
+          f64 ap = a[i * size + p];
+          f64 aq = a[i * size + q];
+          a[i * size + p] = c * ap - s * aq;
+          a[i * size + q] = s * ap + c * aq;
+
+          f64 vp = v[i * size + p];
+          f64 vq = v[i * size + q];
+          v[i * size + p] = c * vp - s * vq;
+          v[i * size + q] = s * vp + c * vq;
+        }
+      }
+    }
+
+    if(!rotated)
+    {
+      break;
+    }
+  }
+}
+
+Convolution::Convolution() : PostProEffect(sType), mSize(0), mPreset(PRESET_IDENTITY), mBias(0.f), mTolerance(0.01f), mPlanTolerance(0.f),
+  mRank(0), mTapCount(0), mHorizontal(0), mAccumulated(0)
+{
+  AddShader(&mShader, "Convolution.xml");
+  mSupportsRenderScale = true;
+
+  mKernelText[0] = 0;
+  LoadPreset(PRESET_SHARPEN);
+}
+
+void Convolution::CreateATB()
+{
+  StringContainer stringContainer;
+
+  stringContainer.push_back("IDENTITY");
+  stringContainer.push_back("SHARPEN");
+  stringContainer.push_back("EMBOSS");
+  stringContainer.push_back("BOX 5x5");
+  stringContainer.push_back("GAUSSIAN 7x7");
+  stringContainer.push_back("DIRECTIONAL 9x9");
+  stringContainer.push_back("LENS 11x11");
+
+  AddDropDownVarCB(PostProcessingManager::sStackBar, 
+    EDITOR_MODE_PAUSE, 
+    "", 
+    SetConvolutionPresetCB, 
+    GetConvolutionPresetCB, 
+    this, 
+    ("label='Preset'" + GetNameFormatted()).c_str(),
+    "ConvolutionPresetEnum",
+    stringContainer,
+    false);
+
+  TwAddVarCB(PostProcessingManager::sStackBar, "", TW_TYPE_CSSTRING(sTextSize), SetConvolutionKernelCB, GetConvolutionKernelCB, this, ("label='Kernel'" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_FLOAT, &mBias, ("label='Bias' step=0.01" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_FLOAT, &mTolerance, ("label='Tolerance' min=0.0 max=1.0 step=0.001" + GetNameFormatted()).c_str());
+
+  //The plan, read only
+  TwAddVarCB(PostProcessingManager::sStackBar, "", TW_TYPE_INT32, 0, GetConvolutionRankCB, this, ("label='Rank (0 = direct)'" + GetNameFormatted()).c_str());
+  TwAddVarCB(PostProcessingManager::sStackBar, "", TW_TYPE_UINT32, 0, GetConvolutionTapsCB, this, ("label='Taps'" + GetNameFormatted()).c_str());
+}
+
+b8 Convolution::SetKernel(const std::vector<f32>& weights, s32 size)
+{
+  if(size <= 0 || size > sMaxSize || !(size & 1) || weights.size() != static_cast<u32>(size * size))
+  {
+    return false;
+  }
+
+  mKernel = weights;
+  mSize = size;
+
+  UpdateKernelText();
+  UpdatePlan();
+  return true;
+}
+
+b8 Convolution::SetKernelText(cstr text)
+{
+  std::string numbers(text);
+  std::replace(numbers.begin(), numbers.end(), ';', ' ');
+  std::replace(numbers.begin(), numbers.end(), ',', ' ');
+
+  std::stringstream stream(numbers);
+  std::vector<f32> weights;
+  f32 weight;
+  while(stream >> weight)
+  {
+    weights.push_back(weight);
+  }
+
+  s32 size = 1;
+  while(size * size < static_cast<s32>(weights.size()))
+  {
+    ++size;
+  }
+
+  if(!stream.eof() || !SetKernel(weights, size))
+  {
+    WFE_LOGGER_POPUP << "Convolution kernel needs an odd square number of weights, up to " << sMaxSize << "x" << sMaxSize << std::endl;
+    UpdateKernelText();
+    return false;
+  }
+
+  return true;
+}
+
+void Convolution::LoadPreset(s32 preset)
+{
+  s32 size = 3;
+  std::vector<f32> weights;
+
+  switch(preset)
+  {
+  case PRESET_SHARPEN:
+    {
+      const f32 sharpen[] = { 0.f, -1.f, 0.f, -1.f, 5.f, -1.f, 0.f, -1.f, 0.f };
+      weights.assign(sharpen, sharpen + 9);
+    }
+    break;
+  case PRESET_EMBOSS:
+    {
+      const f32 emboss[] = { -2.f, -1.f, 0.f, -1.f, 1.f, 1.f, 0.f, 1.f, 2.f };
+      weights.assign(emboss, emboss + 9);
+    }
+    break;
+  case PRESET_BOX:
+    size = 5;
+    weights.assign(size * size, 1.f / (size * size));
+    break;
+  case PRESET_GAUSSIAN:
+    {
+      //Binomial, separable by construction
+      const f32 row[] = { 1.f, 6.f, 15.f, 20.f, 15.f, 6.f, 1.f };
+      size = 7;
+      for(s32 y = 0; y < size; ++y)
+      {
+        for(s32 x = 0; x < size; ++x)
+        {
+          weights.push_back(row[y] * row[x] / 4096.f);
+        }
+      }
+    }
+    break;
+  case PRESET_DIRECTIONAL:
+    //Diagonal streak, full rank
+    size = 9;
+    weights.assign(size * size, 0.f);
+    for(s32 i = 0; i < size; ++i)
+    {
+      weights[i * size + i] = 1.f / size;
+    }
+    break;
+  case PRESET_LENS:
+    {
+      //Flat disc, the shape of an out of focus highlight
+      size = 11;
+      s32 half = size / 2;
+      u32 count = 0;
+      for(s32 y = -half; y <= half; ++y)
+      {
+        for(s32 x = -half; x <= half; ++x)
+        {
+          b8 inside = x * x + y * y <= half * half + half;
+          weights.push_back(inside ? 1.f : 0.f);
+          count += inside;
+        }
+      }
+      for(u32 i = 0; i < weights.size(); ++i)
+      {
+        weights[i] /= count;
+      }
+    }
+    break;
+  default:
+    preset = PRESET_IDENTITY;
+    weights.assign(9, 0.f);
+    weights[4] = 1.f;
+  }
+
+  mPreset = preset;
+  SetKernel(weights, size);
+}
+
+void Convolution::UpdateKernelText()
+{
+  std::stringstream text;
+  for(s32 y = 0; y < mSize; ++y)
+  {
+    for(s32 x = 0; x < mSize; ++x)
+    {
+      text << mKernel[y * mSize + x] << (x + 1 < mSize ? " " : "");
+    }
+    text << (y + 1 < mSize ? "; " : "");
+  }
+
+  strncpy(mKernelText, text.str().c_str(), sTextSize - 1);
+  mKernelText[sTextSize - 1] = 0;
+}
+
+/*****************************************************************************/
+/*!
+Runs as many rank-1 terms as it takes for the dropped ones to hold no more
+than the tolerance of the kernel (Frobenius norm). Every term costs the taps
+of its row and its column, the kernel is run directly instead when that needs
+fewer taps. Rows are top to bottom, so row r is r texels below the top one
+*/
+/*****************************************************************************/
+void Convolution::UpdatePlan()
+{
+  mPlanTolerance = mTolerance;
+
+  s32 half = mSize / 2;
+  f32 largest = 0.f;
+  for(u32 i = 0; i < mKernel.size(); ++i)
+  {
+    largest = std::max(largest, std::abs(mKernel[i]));
+  }
+
+  mDirectTaps.clear();
+  for(s32 y = 0; y < mSize; ++y)
+  {
+    for(s32 x = 0; x < mSize; ++x)
+    {
+      f32 weight = mKernel[y * mSize + x];
+      if(std::abs(weight) > largest * 1e-4f)
+      {
+        AddConvolutionTap(mDirectTaps, x - half, half - y, weight);
+      }
+    }
+  }
+  u32 directTaps = mDirectTaps.size() / 4;
+
+  std::vector<f64> a;
+  std::vector<f64> v;
+  FactorKernel(mKernel, mSize, a, v);
+
+  //Singular values, largest first
+  std::vector<std::pair<f64, s32> > terms;
+  f64 total = 0.0;
+  for(s32 j = 0; j < mSize; ++j)
+  {
+    f64 sigmaSquared = 0.0;
+    for(s32 i = 0; i < mSize; ++i)
+    {
+      sigmaSquared += a[i * mSize + j] * a[i * mSize + j];
+    }
+    terms.push_back(std::make_pair(std::sqrt(sigmaSquared), j));
+    total += sigmaSquared;
+  }
+  std::sort(terms.rbegin(), terms.rend());
+
+  //Fewest terms whose leftovers are within the tolerance
+  s32 rank = 0;
+  f64 dropped = total;
+  f64 allowed = static_cast<f64>(mTolerance) * mTolerance * total;
+  while(rank < mSize && dropped > allowed && terms[rank].first > 0.0)
+  {
+    dropped -= terms[rank].first * terms[rank].first;
+    ++rank;
+  }
+
+  //The direct form only holds sMaxTaps, past that at least one term has to run
+  if(!rank && directTaps > sMaxTaps)
+  {
+    rank = 1;
+  }
+
+  mHorizontalTaps.assign(rank, std::vector<f32>());
+  mVerticalTaps.assign(rank, std::vector<f32>());
+  u32 separableTaps = 0;
+  for(s32 k = 0; k < rank; ++k)
+  {
+    //The singular value is split evenly between the two passes
+    f64 sigma = terms[k].first;
+    s32 j = terms[k].second;
+    f64 scale = std::sqrt(sigma);
+
+    f64 largestU = 0.0;
+    f64 largestV = 0.0;
+    for(s32 i = 0; i < mSize; ++i)
+    {
+      largestU = std::max(largestU, std::abs(a[i * mSize + j] / sigma));
+      largestV = std::max(largestV, std::abs(v[i * mSize + j]));
+    }
+
+    for(s32 i = 0; i < mSize; ++i)
+    {
+      f64 column = a[i * mSize + j] / sigma;
+      if(std::abs(column) > largestU * 1e-4)
+      {
+        AddConvolutionTap(mVerticalTaps[k], 0, half - i, column * scale);
+      }
+
+      f64 row = v[i * mSize + j];
+      if(std::abs(row) > largestV * 1e-4)
+      {
+        AddConvolutionTap(mHorizontalTaps[k], i - half, 0, row * scale);
+      }
+    }
+
+    separableTaps += (mHorizontalTaps[k].size() + mVerticalTaps[k].size()) / 4;
+  }
+
+  //Direct wins ties, it is a single pass. With no terms left it is the only plan
+  b8 direct = directTaps <= sMaxTaps && (!rank || directTaps <= separableTaps);
+  mRank = direct ? 0 : rank;
+  mTapCount = direct ? directTaps : separableTaps;
+}
+
+/*****************************************************************************/
+/*!
+Every term but the last runs both passes here, the vertical ones are added up
+in mAccumulated. The horizontal pass of the last term is left in mHorizontal,
+its vertical pass is the effect's own draw and adds mAccumulated in
+*/
+/*****************************************************************************/
+void Convolution::PreBindUpdate( wfe::RenderBuffer* source )
+{
+  mHorizontal = 0;
+  mAccumulated = 0;
+
+  if(mTolerance != mPlanTolerance)
+  {
+    UpdatePlan();
+  }
+
+  if(!mRank)
+  {
+    return;
+  }
+
+  //Negative weights give negative sums in between, only float targets keep them
+  mHorizontal = AcquireTransientTarget(source->GetWidth(), source->GetHeight(), RT_FORMAT_RGBA16F);
+  if(mRank > 1)
+  {
+    mAccumulated = AcquireTransientTarget(source->GetWidth(), source->GetHeight(), RT_FORMAT_RGBA16F);
+  }
+
+  GLboolean blend = glIsEnabled(GL_BLEND);
+  glBlendFunc(GL_ONE, GL_ONE);
+
+  WFE_GRAPHICS->SwitchShader(mShader);
+  glUniform4f(glGetUniformLocation(mShader->GetHandle(), "uBias"), 0.f, 0.f, 0.f, 0.f);
+  glUniform1i(glGetUniformLocation(mShader->GetHandle(), "uAccumulate"), false);
+
+  for(s32 i = 0; i + 1 < mRank; ++i)
+  {
+    glDisable(GL_BLEND);
+    DrawPass(source, mHorizontal, mHorizontalTaps[i]);
+
+    //Terms after the first add to the ones before
+    if(i)
+    {
+      glEnable(GL_BLEND);
+    }
+    DrawPass(mHorizontal, mAccumulated, mVerticalTaps[i]);
+  }
+
+  glDisable(GL_BLEND);
+  DrawPass(source, mHorizontal, mHorizontalTaps[mRank - 1]);
+
+  if(blend)
+  {
+    glEnable(GL_BLEND);
+  }
+}
+
+void Convolution::DrawPass(wfe::RenderBuffer* source, wfe::RenderBuffer* dest, const std::vector<f32>& taps)
+{
+  GLuint program = mShader->GetHandle();
+
+  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  EnableViewportUniforms(mShader);
+  glUniform2f(glGetUniformLocation(program, "uTexelSize"), 1.f / source->GetWidth(), 1.f / source->GetHeight());
+  glUniform1i(glGetUniformLocation(program, "uTapCount"), taps.size() / 4);
+  if(!taps.empty())
+  {
+    glUniform4fv(glGetUniformLocation(program, "uTaps"), taps.size() / 4, &taps[0]);
+  }
+
+  dest->Bind();
+  glViewport(0, 0, sRenderWidth, sRenderHeight);
+  WFE_GRAPHICS->DrawOverScreen();
+}
+
+void Convolution::EnableUniforms( wfe::RenderBuffer* source )
+{
+  GLuint program = mShader->GetHandle();
+  RenderBuffer* input = mRank ? mHorizontal : source;
+  const std::vector<f32>& taps = mRank ? mVerticalTaps[mRank - 1] : mDirectTaps;
+
+  mShader->EnableTexture(input->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  if(mAccumulated)
+  {
+    mShader->EnableTexture(mAccumulated->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_BLOOMZERO);
+  }
+
+  glUniform2f(glGetUniformLocation(program, "uTexelSize"), 1.f / input->GetWidth(), 1.f / input->GetHeight());
+  glUniform1i(glGetUniformLocation(program, "uTapCount"), taps.size() / 4);
+  if(!taps.empty())
+  {
+    glUniform4fv(glGetUniformLocation(program, "uTaps"), taps.size() / 4, &taps[0]);
+  }
+  glUniform1i(glGetUniformLocation(program, "uAccumulate"), mAccumulated != 0);
+  glUniform4f(glGetUniformLocation(program, "uBias"), mBias, mBias, mBias, 0.f);
+}
+
+BilateralGrid::BilateralGrid() : PostProEffect(sType), mGrid(0), mRowBuffer(0), mRowBufferWidth(0), mSpatial(16.f), mRange(0.1f),
+  mSliceWidth(0), mGridHeight(0), mSlices(0)
+{
+  AddShader(&mShader, "BilateralSlice.xml");
+  AddShader(&mSplatShader, "BilateralSplat.xml");
+  AddShader(&mBlurShader, "BilateralBlur.xml");
+  mSupportsRenderScale = true;
+
+  mGridScale[0] = mGridScale[1] = mGridScale[2] = 1.f;
+}
+
+void BilateralGrid::PrepareDevice()
+{
+  PostProEffect::PrepareDevice();
+
+  mPixelAttrib = glGetAttribLocation(mSplatShader->GetHandle(), "aPixelX");
+}
+
+BilateralGrid::~BilateralGrid()
+{
+  glDeleteBuffers(1, &mRowBuffer);
+}
+
+void BilateralGrid::CreateATB()
+{
+  AddVarRW("", TW_TYPE_FLOAT, &mSpatial, ("label='Spatial Radius' min=2.0 max=64.0 step=1.0" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_FLOAT, &mRange, ("label='Range' min=0.02 max=1.0 step=0.01" + GetNameFormatted()).c_str());
+}
+
+/*****************************************************************************/
+/*!
+Splat, blur and the slice in EnableUniforms. Every pixel of the render rect
+is a point that adds its color and a weight of 1 to its nearest grid cell.
+The blur is 1 2 1 along x, y and then the intensity, the empty border cells
+keep it from reaching into the next slice
+*/
+/*****************************************************************************/
+void BilateralGrid::PreBindUpdate( wfe::RenderBuffer* source )
+{
+  f32 spatial = std::max(mSpatial, 1.f);
+  f32 range = Clamp<f32>(mRange, 0.01f, 1.f);
+
+  mSliceWidth = static_cast<s32>(std::ceil(sRenderWidth / spatial)) + 3;
+  mGridHeight = static_cast<s32>(std::ceil(sRenderHeight / spatial)) + 3;
+  mSlices = static_cast<s32>(std::ceil(1.f / range)) + 3;
+
+  //Fewer slices when they do not fit side by side
+  GLint maxSize = 0;
+  glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+  if(mSliceWidth * mSlices > maxSize)
+  {
+    mSlices = std::max(4, maxSize / mSliceWidth);
+    range = 1.f / (mSlices - 3);
+  }
+
+  mGridScale[0] = 1.f / spatial;
+  mGridScale[1] = 1.f / spatial;
+  mGridScale[2] = 1.f / range;
+
+  s32 atlasWidth = mSliceWidth * mSlices;
+
+  //Sums of thousands of pixels per cell
+  RenderBuffer* grids[2] =
+  {
+    AcquireTransientTarget(atlasWidth, mGridHeight, RT_FORMAT_RGBA32F),
+    AcquireTransientTarget(atlasWidth, mGridHeight, RT_FORMAT_RGBA32F)
+  };
+
+  if(mRowBufferWidth != sRenderWidth)
+  {
+    std::vector<f32> columns(sRenderWidth);
+    for(s32 x = 0; x < sRenderWidth; ++x)
+    {
+      columns[x] = static_cast<f32>(x);
+    }
+
+    if(!mRowBuffer)
+    {
+      glGenBuffers(1, &mRowBuffer);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, mRowBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(f32) * columns.size(), &columns[0], GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    mRowBufferWidth = sRenderWidth;
+  }
+
+  GLfloat clearColor[4];
+  glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+  glClearColor(0.f, 0.f, 0.f, 0.f);
+  grids[0]->Bind();
+  glViewport(0, 0, atlasWidth, mGridHeight);
+  glClear(GL_COLOR_BUFFER_BIT);
+  glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+
+  //Splat
+  WFE_GRAPHICS->SwitchShader(mSplatShader);
+  mSplatShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  glUniform2f(glGetUniformLocation(mSplatShader->GetHandle(), "uSourceSize"), static_cast<f32>(source->GetWidth()), static_cast<f32>(source->GetHeight()));
+  EnableGridUniforms(mSplatShader);
+
+  GLboolean blend = glIsEnabled(GL_BLEND);
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_ONE, GL_ONE);
+  glBindBuffer(GL_ARRAY_BUFFER, mRowBuffer);
+  glEnableVertexAttribArray(mPixelAttrib);
+  glVertexAttribPointer(mPixelAttrib, 1, GL_FLOAT, GL_FALSE, 0, 0);
+  glDrawArraysInstanced(GL_POINTS, 0, sRenderWidth, sRenderHeight);
+  glDisableVertexAttribArray(mPixelAttrib);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glDisable(GL_BLEND);
+
+  //Blur, a slice further along the intensity is a slice width to the right
+  WFE_GRAPHICS->SwitchShader(mBlurShader);
+  DrawBlurPass(grids[0], grids[1], 1.f, 0.f);
+  DrawBlurPass(grids[1], grids[0], 0.f, 1.f);
+  DrawBlurPass(grids[0], grids[1], static_cast<f32>(mSliceWidth), 0.f);
+  mGrid = grids[1];
+
+  if(blend)
+  {
+    glEnable(GL_BLEND);
+  }
+}
+
+void BilateralGrid::DrawBlurPass(wfe::RenderBuffer* source, wfe::RenderBuffer* dest, f32 stepX, f32 stepY)
+{
+  mBlurShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  glUniform2f(glGetUniformLocation(mBlurShader->GetHandle(), "uStep"), stepX, stepY);
+  glUniform2f(glGetUniformLocation(mBlurShader->GetHandle(), "uAtlasSize"), static_cast<f32>(source->GetWidth()), static_cast<f32>(source->GetHeight()));
+
+  dest->Bind();
+  glViewport(0, 0, dest->GetWidth(), dest->GetHeight());
+  WFE_GRAPHICS->DrawOverScreen();
+}
+
+void BilateralGrid::EnableUniforms( wfe::RenderBuffer* source )
+{
+  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  mShader->EnableTexture(mGrid->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_BLOOMZERO);
+
+  EnableGridUniforms(mShader);
+}
+
+void BilateralGrid::EnableGridUniforms(wfe::Shader* shader)
+{
+  glUniform3fv(glGetUniformLocation(shader->GetHandle(), "uGridScale"), 1, mGridScale);
+  glUniform2f(glGetUniformLocation(shader->GetHandle(), "uAtlasSize"), static_cast<f32>(mSliceWidth * mSlices), static_cast<f32>(mGridHeight));
+  glUniform1f(glGetUniformLocation(shader->GetHandle(), "uSliceWidth"), static_cast<f32>(mSliceWidth));
+}
+
+PPFXAA::PPFXAA() : PostProEffect(sType), mSubpixel(0.75f), mEdgeThreshold(0.166f), mEdgeThresholdMin(0.0833f),
+  mSubpixelHandle(-1), mEdgeThresholdHandle(-1), mEdgeThresholdMinHandle(-1)
+{
+  AddShader(&mShader, "FXAA.xml");
+  mSupportsRenderScale = true;
+}
+
+void PPFXAA::PrepareDevice()
+{
+  PostProEffect::PrepareDevice();
+
+  mSubpixelHandle = glGetUniformLocation(mShader->GetHandle(), "uSubpixel");
+  mEdgeThresholdHandle = glGetUniformLocation(mShader->GetHandle(), "uEdgeThreshold");
+  mEdgeThresholdMinHandle = glGetUniformLocation(mShader->GetHandle(), "uEdgeThresholdMin");
+}
+
+void PPFXAA::CreateATB()
+{
+  AddVarRW("", TW_TYPE_FLOAT, &mSubpixel, ("label='Subpixel' min=0.0 max=1.0 step=0.05" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_FLOAT, &mEdgeThreshold, ("label='Edge Threshold' min=0.063 max=0.333 step=0.01" + GetNameFormatted()).c_str());
+  AddVarRW("", TW_TYPE_FLOAT, &mEdgeThresholdMin, ("label='Edge Threshold Min' min=0.0 max=0.1 step=0.005" + GetNameFormatted()).c_str());
+}
+
+void PPFXAA::EnableUniforms( wfe::RenderBuffer* source )
+{
+  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+
+  glUniform1f(mShader->GetMapHeightHandle(), static_cast<GLfloat>(source->GetHeight()));
+  glUniform1f(mShader->GetMapWidthHandle(), static_cast<GLfloat>(source->GetWidth()));
+  glUniform1f(mSubpixelHandle, mSubpixel);
+  glUniform1f(mEdgeThresholdHandle, mEdgeThreshold);
+  glUniform1f(mEdgeThresholdMinHandle, mEdgeThresholdMin);
+}
+
+b8 PPFXAA::RecordUniforms(PostProCommandList& list, RenderBuffer* source)
+{
+  list.AddTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  list.AddUniform(mShader->GetMapHeightHandle(), static_cast<GLfloat>(source->GetHeight()));
+  list.AddUniform(mShader->GetMapWidthHandle(), static_cast<GLfloat>(source->GetWidth()));
+  list.AddUniform(mSubpixelHandle, &mSubpixel);
+  list.AddUniform(mEdgeThresholdHandle, &mEdgeThreshold);
+  list.AddUniform(mEdgeThresholdMinHandle, &mEdgeThresholdMin);
+  return true;
+}
+
+//Adds the area between the line (x1, y1) - (x2, y2) and the edge at y = 0
+//inside the pixel [x, x + 1]. above is the part on the pixel's side
+static void AddLineArea(f32 x1, f32 y1, f32 x2, f32 y2, f32 x, f32& above, f32& below)
+{
+  f32 from = std::max(x, x1);
+  f32 to = std::min(x + 1.f, x2);
+  if(to <= from)
+  {
+    return;
+  }
+
+  f32 slope = (y2 - y1) / (x2 - x1);
+  f32 yFrom = y1 + slope * (from - x1);
+  f32 yTo = y1 + slope * (to - x1);
+
+  //Crosses the edge inside the pixel, a triangle on either side
+  if(yFrom * yTo < 0.f)
+  {
+    f32 cross = from + yFrom / (yFrom - yTo) * (to - from);
+    f32 first = yFrom * (cross - from) * .5f;
+    f32 second = yTo * (to - cross) * .5f;
+    (first > 0.f ? above : below) += std::abs(first);
+    (second > 0.f ? above : below) += std::abs(second);
+    return;
+  }
+
+  f32 trapezoid = (yFrom + yTo) * .5f * (to - from);
+  (trapezoid > 0.f ? above : below) += std::abs(trapezoid);
+}
+
+//Height of the silhouette at an end of the edge. A crossing edge on the
+//pixel's side means it steps up there, on the other side down
+static f32 GetEndHeight(s32 crossing)
+{
+  if(1 == crossing)
+  {
+    return .5f;
+  }
+  if(2 == crossing)
+  {
+    return -.5f;
+  }
+  return 0.f;
+}
+
+/*****************************************************************************/
+/*!
+The area texture is a 4x4 grid of crossing edge patterns (left end, right end),
+each sMaxDistance x sMaxDistance by the distances to the ends. Crossings are
+0 for none, 1 on the pixel's side, 2 on the other side and 3 for both, which
+is as flat as none. The silhouette line runs through the middle of the edge
+and half a pixel up or down at ends that step, as in MLAA. The search texture
+decodes two edge pixels filtered with 3/4 on the nearer one into how many of
+them continue the edge
+*/
+/*****************************************************************************/
+void PPSMAA::PrepareHost()
+{
+  PostProEffect::PrepareHost();
+
+  mAreaData.assign(sAreaSize * sAreaSize * 2, 0);
+
+  for(s32 crossing1 = 0; crossing1 < 4; ++crossing1)
+  {
+    for(s32 crossing2 = 0; crossing2 < 4; ++crossing2)
+    {
+      f32 height1 = GetEndHeight(crossing1);
+      f32 height2 = GetEndHeight(crossing2);
+
+      for(s32 left = 0; left < sMaxDistance; ++left)
+      {
+        for(s32 right = 0; right < sMaxDistance; ++right)
+        {
+          f32 length = static_cast<f32>(left + right + 1);
+          f32 x = static_cast<f32>(left);
+          f32 above = 0.f;
+          f32 below = 0.f;
+
+          if(height1 != 0.f && height2 != 0.f)
+          {
+            if(height1 != height2)
+            {
+              //Z shape, one line end to end
+              AddLineArea(0.f, height1, length, height2, x, above, below);
+            }
+            else
+            {
+              //U shape, down to the middle and back
+              AddLineArea(0.f, height1, length * .5f, 0.f, x, above, below);
+              AddLineArea(length * .5f, 0.f, length, height2, x, above, below);
+            }
+          }
+          else if(height1 != 0.f && left <= right)
+          {
+            //L shape, only the half next to the stepping end
+            AddLineArea(0.f, height1, length * .5f, 0.f, x, above, below);
+          }
+          else if(height2 != 0.f && left >= right)
+          {
+            AddLineArea(length * .5f, 0.f, length, height2, x, above, below);
+          }
+
+          s32 index = ((crossing2 * sMaxDistance + right) * sAreaSize + crossing1 * sMaxDistance + left) * 2;
+          mAreaData[index + 0] = static_cast<u8>(Clamp<f32>(above, 0.f, 1.f) * 255.f + .5f);
+          mAreaData[index + 1] = static_cast<u8>(Clamp<f32>(below, 0.f, 1.f) * 255.f + .5f);
+        }
+      }
+    }
+  }
+
+  //Filtered value * 4 is 0 for none, 1 for only the further, 3 for only the
+  //nearer and 4 for both. Stored as count / 2
+  mSearchData.assign(sSearchSize, 0);
+  mSearchData[3] = 128;
+  mSearchData[4] = 255;
+}
+
+void PPSMAA::PrepareDevice()
+{
+  PostProEffect::PrepareDevice();
+
+  glGenTextures(1, &mAreaTexture);
+  glBindTexture(GL_TEXTURE_2D, mAreaTexture);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RG8, sAreaSize, sAreaSize, 0, GL_RG, GL_UNSIGNED_BYTE, &mAreaData[0]);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+  glGenTextures(1, &mSearchTexture);
+  glBindTexture(GL_TEXTURE_2D, mSearchTexture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, sSearchSize, 1, 0, GL_RED, GL_UNSIGNED_BYTE, &mSearchData[0]);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  //Only the textures are needed from now on
+  std::vector<u8>().swap(mAreaData);
+  std::vector<u8>().swap(mSearchData);
+}
+
+PPSMAA::PPSMAA() : PostProEffect(sType), mWeights(0), mAreaTexture(0), mSearchTexture(0), mThreshold(0.1f)
+{
+  AddShader(&mShader, "SMAABlend.xml");
+  AddShader(&mEdgeShader, "SMAAEdges.xml");
+  AddShader(&mWeightShader, "SMAAWeights.xml");
+  mSupportsRenderScale = true;
+}
+
+PPSMAA::~PPSMAA()
+{
+  if(mAreaTexture)
+  {
+    glDeleteTextures(1, &mAreaTexture);
+  }
+  if(mSearchTexture)
+  {
+    glDeleteTextures(1, &mSearchTexture);
+  }
+}
+
+void PPSMAA::CreateATB()
+{
+  AddVarRW("", TW_TYPE_FLOAT, &mThreshold, ("label='Threshold' min=0.05 max=0.5 step=0.01" + GetNameFormatted()).c_str());
+}
+
+/*****************************************************************************/
+/*!
+Edge detection and blend weights. Both targets are drawn over the whole
+render rect, so neither has to be cleared
+*/
+/*****************************************************************************/
+void PPSMAA::PreBindUpdate( wfe::RenderBuffer* source )
+{
+  RenderBuffer* edges = AcquireTransientTarget(source->GetWidth(), source->GetHeight());
+  mWeights = AcquireTransientTarget(source->GetWidth(), source->GetHeight());
+
+  WFE_GRAPHICS->SwitchShader(mEdgeShader);
+  mEdgeShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  EnableViewportUniforms(mEdgeShader);
+  glUniform1f(mEdgeShader->GetMapWidthHandle(), static_cast<GLfloat>(source->GetWidth()));
+  glUniform1f(mEdgeShader->GetMapHeightHandle(), static_cast<GLfloat>(source->GetHeight()));
+  glUniform1f(glGetUniformLocation(mEdgeShader->GetHandle(), "uThreshold"), mThreshold);
+  edges->Bind();
+  glViewport(0, 0, sRenderWidth, sRenderHeight);
+  WFE_GRAPHICS->DrawOverScreen();
+
+  WFE_GRAPHICS->SwitchShader(mWeightShader);
+  mWeightShader->EnableTexture(edges->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  mWeightShader->EnableTexture(mAreaTexture, Shader::WFE_SHADER_MAPTYPE_BLOOMZERO);
+  mWeightShader->EnableTexture(mSearchTexture, Shader::WFE_SHADER_MAPTYPE_BLOOMONE);
+  glUniform1f(mWeightShader->GetMapWidthHandle(), static_cast<GLfloat>(edges->GetWidth()));
+  glUniform1f(mWeightShader->GetMapHeightHandle(), static_cast<GLfloat>(edges->GetHeight()));
+  glUniform2f(glGetUniformLocation(mWeightShader->GetHandle(), "uRectSize"), static_cast<f32>(sRenderWidth), static_cast<f32>(sRenderHeight));
+  mWeights->Bind();
+  glViewport(0, 0, sRenderWidth, sRenderHeight);
+  WFE_GRAPHICS->DrawOverScreen();
+}
+
+void PPSMAA::EnableUniforms( wfe::RenderBuffer* source )
+{
+  mShader->EnableTexture(source->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  mShader->EnableTexture(mWeights->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_BLOOMZERO);
+
+  glUniform1f(mShader->GetMapHeightHandle(), static_cast<GLfloat>(source->GetHeight()));
+  glUniform1f(mShader->GetMapWidthHandle(), static_cast<GLfloat>(source->GetWidth()));
+}
@@ -1,551 +1,1151 @@
-/******************************************************************************/
-/*!
-\file   PostProEffect.h
-\par    email: y.li\@digipen.edu
-\par    name:  Sebastian Li Ye Wei
-\par    Project: CS370 
-\date   02/08/2013
-\brief  
-Class that performs post processing effects for the game
-
-All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
-*/
-/******************************************************************************/
-#ifndef PostProH
-#define PostProH
-
-#include "AntTweakBar\AntTweakBar.h"
-#include "PostProEffectTypeEnum.h"
-
-/*****************************************************************************/
-/*!
-  Includes (Only include if required! Forward declare if you can!)
-*/
-/*****************************************************************************/
-namespace wfe
-{
-  class RenderBuffer;
-}
-
-
-/*****************************************************************************/
-/*!
-  Forward Declarations
-*/
-/*****************************************************************************/
-namespace wfe
-{
-  class RenderBuffer;
-}
-
-
-/*****************************************************************************/
-/*!
-  Type Declarations (Types that are associated with this class declared here)
-*/
-/*****************************************************************************/
-enum PostProcessingCombineModes
-{
-  POSTPRO_CM_REPLACE,
-  POSTPRO_CM_NORMAL,
-  POSTPRO_CM_ADD,
-  POSTPRO_CM_SUB,
-  POSTPRO_CM_NUM
-};
-
-class PostProEffect
-{
-public:
-  //////////////////////////////////////////////////////////////////////////
-  //Ctors
-  PostProEffect(s32 type);
-  virtual ~PostProEffect();
-
-  //////////////////////////////////////////////////////////////////////////
-  //Member functions
-  virtual void Apply(wfe::RenderBuffer*& source, wfe::RenderBuffer*& dest); //Default apply function. uses the post pro effect's shader to draw over the screen
-
-  //////////////////////////////////////////////////////////////////////////
-  //Getters (Implement simple ones here)
-  PostProcessingCombineModes GetCombineMode() const { return mCombineMode; }
-
-  //////////////////////////////////////////////////////////////////////////
-  //Setters (Implement simple ones here)
-  void SetCombineMode(PostProcessingCombineModes mode) { mCombineMode = mode; }
-  void SetShader(wfe::Shader* shader) { mShader = shader; }
-
-  void CreateATBMain(u32 index);
-  virtual void CreateATB() = 0;
-
-  virtual void EnableUniforms(wfe::RenderBuffer* source);
-  virtual void PreBindUpdate(wfe::RenderBuffer*) {}
-
-  const std::string& GetName() const { return mName; }
-  const std::string& GetNameFormatted() const { return mNameFormatted; }
-
-  static const u32 mObjPerPage = 8;
-
-  s32 GetType() const { return mType; }
-  void PushbackPreEffects(s32 type);
-protected:
-  void AddVarRW(cstr const name, TwType type, void* var, cstr const def);
-  
-  wfe::Shader* mShader;
-  std::vector<PostProEffect*> mPrePostProEffect;
-  u32 mInputTextureHandle;
-  b8 mKeepInputImage;
-private:
-  //////////////////////////////////////////////////////////////////////////
-  //Private member functions (functions for internal class use only)
-
-  //////////////////////////////////////////////////////////////////////////
-  //Private member data
-  PostProcessingCombineModes mCombineMode;
-
-  std::string mName;
-  std::string mNameFormatted;
-
-  u8* mData;
-  s32 mType;
-}; // class PostProEffect
-
-class Desaturation : public PostProEffect
-{
-public:
-  Desaturation();
-
-  virtual void CreateATB();
-  virtual void EnableUniforms(wfe::RenderBuffer* source);
-
-  //////////////////////////////////////////////////////////////////////////
-  static const s32 sType = DESATURATION;
-  //Static page size variable. This determines how many objects the object
-  //allocator places on one page
-  //Note: Components MUST have this!
-  static const u32 mObjPerPage = 8;
-
-  f32 mSaturation;
-};
-
-class SepiaTone : public PostProEffect
-{
-public:
-  SepiaTone();
-
-  virtual void CreateATB() {}
-  //virtual void EnableUniforms(wfe::RenderBuffer* source);
-
-  //////////////////////////////////////////////////////////////////////////
-  static const s32 sType = SEPIA_TONE;
-  //Static page size variable. This determines how many objects the object
-  //allocator places on one page
-  //Note: Components MUST have this!
-  static const u32 mObjPerPage = 8;
-};
-
-class BlurHorizontal : public PostProEffect
-{
-public:
-  BlurHorizontal();
-
-  virtual void CreateATB();
-  virtual void EnableUniforms(wfe::RenderBuffer* source);
-
-  //////////////////////////////////////////////////////////////////////////
-  static const s32 sType = BLUR_HORIZONTAL;
-  //Static page size variable. This determines how many objects the object
-  //allocator places on one page
-  //Note: Components MUST have this!
-  static const u32 mObjPerPage = 8;
-   s32 mHalfSize;
-private:
- 
-  f32 mBlurCutoff;
-  b8 mInvert;
-  b8 mApplyNaiveDOF;
-  u32 mBlurCutoffHandle;
-  u32 mInvertHandle;
-  u32 mApplyNaiveDOFHandle;
-};
-
-class BlurVertical : public PostProEffect
-{
-public:
-  BlurVertical();
-
-  virtual void CreateATB();
-  virtual void EnableUniforms(wfe::RenderBuffer* source);
-
-  //////////////////////////////////////////////////////////////////////////
-  static const s32 sType = BLUR_VERTICAL;
-  //Static page size variable. This determines how many objects the object
-  //allocator places on one page
-  //Note: Components MUST have this!
-  static const u32 mObjPerPage = 8;
-  s32 mHalfSize;
-private:
-  
-  f32 mBlurCutoff;
-  b8 mInvert;
-  b8 mApplyNaiveDOF;
-  u32 mBlurCutoffHandle;
-  u32 mInvertHandle;
-  u32 mApplyNaiveDOFHandle;
-};
-
-class BlackWhite : public PostProEffect
-{
-public:
-  BlackWhite();
-
-  virtual void CreateATB();
-  virtual void EnableUniforms(wfe::RenderBuffer* source);
-
-  //////////////////////////////////////////////////////////////////////////
-  static const s32 sType = BLACK_WHITE;
-  //Static page size variable. This determines how many objects the object
-  //allocator places on one page
-  //Note: Components MUST have this!
-  static const u32 mObjPerPage = 8;
-
-private:
-  f32 mTolerance;
-};
-
-class UnsharpMaskingDepth : public PostProEffect
-{
-public:
-    UnsharpMaskingDepth();
-
-    virtual void CreateATB();
-    virtual void EnableUniforms(wfe::RenderBuffer* source);
-
-    //////////////////////////////////////////////////////////////////////////
-    static const s32 sType = UNSHARP_MASKING_DEPTH;
-    //Static page size variable. This determines how many objects the object
-    //allocator places on one page
-    //Note: Components MUST have this!
-    static const u32 mObjPerPage = 8;
-
-private:
-    float mLambda;
-    GLint mLambdaHandle;
-    s32 mHalfSize;
-};
-
-
-class GaussianBlur : public PostProEffect
-{
-public:
-    GaussianBlur();
-
-    virtual void CreateATB();
-    virtual void EnableUniforms(wfe::RenderBuffer* source);
-
-    //////////////////////////////////////////////////////////////////////////
-    static const s32 sType = GAUSSIAN_BLUR;
-    //Static page size variable. This determines how many objects the object
-    //allocator places on one page
-    //Note: Components MUST have this!
-    static const u32 mObjPerPage = 8;
-
-    f32 mRadius;
-};
-
-class Laplacian : public PostProEffect
-{
-public:
-    Laplacian();
-
-    virtual void CreateATB();
-    virtual void EnableUniforms(wfe::RenderBuffer* source);
-
-    //////////////////////////////////////////////////////////////////////////
-    static const s32 sType = LAPLACIAN;
-    //Static page size variable. This determines how many objects the object
-    //allocator places on one page
-    //Note: Components MUST have this!
-    static const u32 mObjPerPage = 8;
-
-private:
-};
-
-class Sobel : public PostProEffect
-{
-public:
-    Sobel();
-
-    virtual void CreateATB();
-    virtual void EnableUniforms(wfe::RenderBuffer* source);
-
-    //////////////////////////////////////////////////////////////////////////
-    static const s32 sType = SOBEL;
-    //Static page size variable. This determines how many objects the object
-    //allocator places on one page
-    //Note: Components MUST have this!
-    static const u32 mObjPerPage = 8;
-
-private:
-};
-
-class UnsharpMasking : public PostProEffect
-{
-public:
-  UnsharpMasking();
-
-  virtual void CreateATB();
-  virtual void EnableUniforms(wfe::RenderBuffer* source);
-
-  //////////////////////////////////////////////////////////////////////////
-  static const s32 sType = UNSHARP_MASKING;
-  //Static page size variable. This determines how many objects the object
-  //allocator places on one page
-  //Note: Components MUST have this!
-  static const u32 mObjPerPage = 8;
-
-private:
-  float mWeightage;
-  GLint mWeightageHandle;
-};
-
-class Negative : public PostProEffect
-{
-public:
-  Negative();
-
-  virtual void CreateATB() {}
-
-  //////////////////////////////////////////////////////////////////////////
-  static const s32 sType = NEGATIVE;
-  //Static page size variable. This determines how many objects the object
-  //allocator places on one page
-  //Note: Components MUST have this!
-  static const u32 mObjPerPage = 8;
-};
-
-class HueChange : public PostProEffect
-{
-public:
-  HueChange();
-
-  virtual void CreateATB();
-  virtual void EnableUniforms(wfe::RenderBuffer* source);
-
-  //////////////////////////////////////////////////////////////////////////
-  static const s32 sType = HUE_CHANGE;
-  //Static page size variable. This determines how many objects the object
-  //allocator places on one page
-  //Note: Components MUST have this!
-  static const u32 mObjPerPage = 8;
-private:
-  f32 mHue;
-  f32 mSaturation;
-  f32 mValue;
-  GLint mHueHandle;
-  GLint mSaturationHandle;
-  GLint mValueHandle;
-};
-
-class RealisticDOF : public PostProEffect
-{
-public:
-  RealisticDOF();
-
-  virtual void CreateATB();
-  virtual void EnableUniforms(wfe::RenderBuffer* source);
-
-  //////////////////////////////////////////////////////////////////////////
-  static const s32 sType = REALISTIC_DOF;
-  //Static page size variable. This determines how many objects the object
-  //allocator places on one page
-  //Note: Components MUST have this!
-  static const u32 mObjPerPage = 8;
-private:
-  f32 mBias;
-  b8 mInvert;
-  u32 mInvertHandle;
-  u32 mBiasHandle;
-};
-
-class BlurHorizontalDepth : public PostProEffect
-{
-public:
-  BlurHorizontalDepth();
-
-  virtual void CreateATB() {}
-  virtual void EnableUniforms(wfe::RenderBuffer* source);
-
-  friend class UnsharpMaskingDepth;
-
-  //////////////////////////////////////////////////////////////////////////
-  static const s32 sType = BLUR_HORIZONTAL_DEPTH;
-  //Static page size variable. This determines how many objects the object
-  //allocator places on one page
-  //Note: Components MUST have this!
-  static const u32 mObjPerPage = 8;
-
-private:
-  s32 mHalfSize;
-  u32 mApplyNaiveDOFHandle;
-};
-
-class BlurVerticalDepth : public PostProEffect
-{
-public:
-  BlurVerticalDepth();
-
-  virtual void CreateATB() {}
-  virtual void EnableUniforms(wfe::RenderBuffer* source);
-
-  friend class UnsharpMaskingDepth;
-  //////////////////////////////////////////////////////////////////////////
-  static const s32 sType = BLUR_VERTICAL_DEPTH;
-  //Static page size variable. This determines how many objects the object
-  //allocator places on one page
-  //Note: Components MUST have this!
-  static const u32 mObjPerPage = 8;
-
-private:
-  s32 mHalfSize;
-  u32 mApplyNaiveDOFHandle;
-};
-
-class AdditiveNoise : public PostProEffect
-{
-public:
-    AdditiveNoise();
-
-    virtual void CreateATB();
-    virtual void EnableUniforms(wfe::RenderBuffer* source);
-
-    //////////////////////////////////////////////////////////////////////////
-    static const s32 sType = ADDITIVE_NOISE;
-    //Static page size variable. This determines how many objects the object
-    //allocator places on one page
-    //Note: Components MUST have this!
-    static const u32 mObjPerPage = 8;
-
-private:
-    u32 mNoisyTextureHandle;
-
-    GLint mOffsetXHandle;
-    GLint mOffsetYHandle;
-    GLint mBiasHandle;
-
-    f32 mBias;
-};
-
-
-
-class BloomCombine : public PostProEffect
-{
-public:
-	BloomCombine();
-
-	virtual void CreateATB();
-	virtual void EnableUniforms(wfe::RenderBuffer* source);
-	virtual void PreBindUpdate(wfe::RenderBuffer* source  );
-	//////////////////////////////////////////////////////////////////////////
-	static const s32 sType = BLOOM;
-	//Static page size variable. This determines how many objects the object
-	//allocator places on one page
-	//Note: Components MUST have this!
-	static const u32 mObjPerPage = 8;
-
-private:
-   wfe::RenderBuffer* mRenderBuffer[6];
-
-	 GLint locC1, locC2, locC3, locC4,locC5;
-	 float m_coefP1, m_coefP1x, m_coefP1y, m_coefP1z, m_coefP2;
-
-};
-
-class LuminanceThreshold : public PostProEffect
-{
-public:
-  LuminanceThreshold();
-
-  virtual void CreateATB() {}
-
-  //////////////////////////////////////////////////////////////////////////
-  static const s32 sType = LUMINANCE_THRESHOLD;
-  //Static page size variable. This determines how many objects the object
-  //allocator places on one page
-  //Note: Components MUST have this!
-  static const u32 mObjPerPage = 8;
-};
-
-class OldFilm : public PostProEffect
-{
-public:
-	OldFilm();
-
-	virtual void CreateATB();
-	virtual void EnableUniforms(wfe::RenderBuffer* source);
-
-	//////////////////////////////////////////////////////////////////////////
-	static const s32 sType = OLD_FILM;
-	//Static page size variable. This determines how many objects the object
-	//allocator places on one page
-	//Note: Components MUST have this!
-	static const u32 mObjPerPage = 8;
-
-private:
-	GLint mSepiaHandle, mNoiseHandle, mScratchHandle,
-		  mInnerVignettingHandle, mOuterVignettingHandle,
-		  mRandomValueHandle, mTimeLapseHandle;
-	float mSepiaVaue, mNoiseValue, mScratchValue,
-		  mInnerVignetting, mOuterVignetting, 
-		  mRandomValue, mTimeLapse, m_multiplier;
-
-
-};
-
-class PPSSAO : public PostProEffect
-{
-public:
-  PPSSAO();
-  ~PPSSAO();
-
-  virtual void CreateATB();
-  virtual void EnableUniforms(wfe::RenderBuffer* source);
-
-  //////////////////////////////////////////////////////////////////////////
-  static const s32 sType = SSAO;
-  //Static page size variable. This determines how many objects the object
-  //allocator places on one page
-  //Note: Components MUST have this!
-  static const u32 mObjPerPage = 8;
-
-private:
-  f32 mAOStrength;
-  f32 mAOSampleDistance;
-  f32 mAOScale;
-  s32 mAOSamples;
-  s32 mAOSamples2;
-};
-
-class Fog : public PostProEffect
-{
-public:
-    Fog();
-
-    virtual void CreateATB();
-    virtual void EnableUniforms(wfe::RenderBuffer* source);
-
-    //////////////////////////////////////////////////////////////////////////
-    static const s32 sType = FOG;
-    //Static page size variable. This determines how many objects the object
-    //allocator places on one page
-    //Note: Components MUST have this!
-    static const u32 mObjPerPage = 8;
-
-private:
-    GLint mCameraViewVecHandle;
-    GLint mCameraEyePosHandle;
-    GLint mCameraNear;
-    GLint mCameraFar;
-};
-
-
+/******************************************************************************/
+/*!
+\file   PostProEffect.h
+\par    email: y.li\@digipen.edu
+\par    name:  Sebastian Li Ye Wei
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Class that performs post processing effects for the game
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+#ifndef PostProH
+#define PostProH
+
+#include "AntTweakBar\AntTweakBar.h"
+#include "PostProEffectTypeEnum.h"
+#include "RenderTargetPool.h"
+#include "PostProDepthMask.h"
+#include "PostProShaderLibrary.h"
+
+/*****************************************************************************/
+/*!
+  Includes (Only include if required! Forward declare if you can!)
+*/
+/*****************************************************************************/
+namespace wfe
+{
+  class RenderBuffer;
+}
+
+
+/*****************************************************************************/
+/*!
+  Forward Declarations
+*/
+/*****************************************************************************/
+namespace wfe
+{
+  class RenderBuffer;
+}
+
+class PostProCommandList;
+class LuminanceThreshold;
+
+
+/*****************************************************************************/
+/*!
+  Type Declarations (Types that are associated with this class declared here)
+*/
+/*****************************************************************************/
+enum PostProcessingCombineModes
+{
+  POSTPRO_CM_REPLACE,
+  POSTPRO_CM_NORMAL,
+  POSTPRO_CM_ADD,
+  POSTPRO_CM_SUB,
+  POSTPRO_CM_MULTIPLY,
+  POSTPRO_CM_SCREEN,
+  POSTPRO_CM_LERP,
+  POSTPRO_CM_NUM
+};
+
+//An extra texture an effect reads, by the name of the result that fills it.
+//Names are resolved by PostProGraph when the stack is recorded
+struct PostProEffectInput
+{
+  std::string mName;
+  s32 mMapType; //wfe::Shader::WFE_SHADER_MAPTYPE_*
+};
+
+class PostProEffect
+{
+public:
+  //////////////////////////////////////////////////////////////////////////
+  //Ctors
+  PostProEffect(s32 type);
+  virtual ~PostProEffect();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Member functions
+  virtual void Apply(wfe::RenderBuffer* source, wfe::RenderBuffer* dest); //Default apply function. uses the post pro effect's shader to draw over the screen
+
+  //Records the passes Apply would run into the list. Returns false if the effect
+  //cannot be recorded, the manager then calls Apply when the list is replayed
+  virtual b8 Record(PostProCommandList& list, wfe::RenderBuffer* source, wfe::RenderBuffer* dest);
+
+  //////////////////////////////////////////////////////////////////////////
+  //Getters (Implement simple ones here)
+  PostProcessingCombineModes GetCombineMode() const { return mCombineMode; }
+  f32 GetOpacity() const { return mOpacity; }
+  const std::string& GetSourceName() const { return mSourceName; }
+  const std::string& GetOutputName() const { return mOutputName; }
+  const std::vector<PostProEffectInput>& GetInputs() const { return mInputs; }
+  const std::vector<PostProEffect*>& GetSubEffects() const { return mSubEffects; }
+  //The result is clamped to 0..1, later results that only depend on it can be RGBA8.
+  //Other combine modes than REPLACE mix the shader's output with an HDR input again
+  b8 OutputsLDR() const { return mOutputsLDR && POSTPRO_CM_REPLACE == mCombineMode; }
+  //Later effects read the alpha of the result, HDR results need RGBA16F then
+  b8 OutputsAlpha() const { return mOutputsAlpha; }
+  //The manager only builds the depth pyramid when an effect on the stack reads it
+  b8 UsesDepthPyramid() const { return mUsesDepthPyramid; }
+  //False when a shader of the effect or its sub effects reads the input without
+  //uUVScale. The manager turns dynamic resolution off while such an effect is on the stack
+  virtual b8 SupportsRenderScale() const;
+  //How many pixels away from a pixel the effect and its sub effects read, for a
+  //render rect of width x height. Batched images keep that much gutter between them
+  virtual s32 GetSampleReach(s32 width, s32 height) const;
+
+  //////////////////////////////////////////////////////////////////////////
+  //Setters (Implement simple ones here)
+  void SetCombineMode(PostProcessingCombineModes mode) { mCombineMode = mode; ++sStructureVersion; }
+  void SetOpacity(f32 opacity) { mOpacity = Clamp<f32>(opacity, 0.f, 1.f); }
+  void SetShader(wfe::Shader* shader) { mShader = shader; }
+
+  //Graph wiring. The source is what arrives as the source buffer in Apply, by
+  //default "previous". See PostProGraph for the names that always exist
+  void SetSourceName(const std::string& name) { mSourceName = name; ++sStructureVersion; }
+  //Publishes the result under a name later effects can read
+  void SetOutputName(const std::string& name) { mOutputName = name; ++sStructureVersion; }
+  //Binds the named result to the given map type whenever the effect draws
+  void AddInput(const std::string& name, s32 mapType);
+  //Targets the graph resolved the inputs to, in the order of GetInputs
+  void SetInputTargets(const std::vector<wfe::RenderBuffer*>& targets) { mInputTargets = targets; }
+  //Image the combine mode blends over, the input of the effect. Set by the graph
+  void SetCombineBase(wfe::RenderBuffer* base) { mCombineBase = base; }
+
+  void CreateATBMain(u32 index);
+  virtual void CreateATB() = 0;
+
+  //Async creation support. PrepareHost only touches CPU memory and may run on a
+  //worker thread, PrepareDevice uploads the results and runs on the render thread
+  virtual void PrepareHost();
+  virtual void PrepareDevice();
+  virtual b8 IsReady() const;
+  b8 IsPrepared() const { return mPrepared; }
+  //Gets the shaders from the shader manager, which links them synchronously
+  void LoadShaders();
+  void Prepare();
+  void FinishPrepare();
+
+  virtual void EnableUniforms(wfe::RenderBuffer* source);
+  //Recorded version of EnableUniforms. Only override it when EnableUniforms sets
+  //nothing that changes from frame to frame other than the effect's own members
+  virtual b8 RecordUniforms(PostProCommandList&, wfe::RenderBuffer*) { return false; }
+  virtual void PreBindUpdate(wfe::RenderBuffer*) {}
+  //Return true to only draw the pixels whose depth is in range. They are masked
+  //in the stencil buffer first, so the effect shader never runs on the others
+  virtual b8 GetDepthMask(PostProDepthMaskRange&) const { return false; }
+  //Return true when the effect reads the automatic exposure. The manager only measures it then
+  virtual b8 UsesExposure() const { return false; }
+
+  const std::string& GetName() const { return mName; }
+  const std::string& GetNameFormatted() const { return mNameFormatted; }
+
+  static const u32 mObjPerPage = 8;
+
+  s32 GetType() const { return mType; }
+
+  //Returns false while the driver is still compiling/linking the program in the background
+  static b8 IsShaderReady(const wfe::Shader* shader);
+
+  //Area of the targets the stack renders into, set by the manager every frame.
+  //It is smaller than the targets when dynamic resolution scaling is on
+  static void SetRenderRect(s32 width, s32 height, s32 targetWidth, s32 targetHeight);
+  static s32 GetRenderWidth() { return sRenderWidth; }
+  static s32 GetRenderHeight() { return sRenderHeight; }
+
+  //Binds the target and restricts drawing to the render rect
+  static void BindTarget(wfe::RenderBuffer* target);
+  //Switches to the fixed function blending used by the combine mode. REPLACE leaves it alone.
+  //Only NORMAL, ADD and SUB have a fixed function equivalent
+  static void SwitchBlending(PostProcessingCombineModes mode);
+
+  //HDR keeps the chain in float formats until a Tonemap effect. Set by the manager
+  static void SetHDR(b8 hdr) { sHDR = hdr; }
+  static b8 IsHDR() { return sHDR; }
+  //Cheapest format for an intermediate color target that may hold HDR values
+  static RenderTargetFormat GetColorFormat(b8 alpha);
+
+  //Bumped whenever an effect changes in a way that needs the stack to be recorded again
+  static u32 GetStructureVersion() { return sStructureVersion; }
+  static void InvalidateRecording() { ++sStructureVersion; }
+protected:
+  void AddVarRW(cstr const name, TwType type, void* var, cstr const def);
+  //For switches that change which passes run. The stack is recorded again when they change
+  void AddStructureVarRW(cstr const name, b8* var, cstr const def);
+  void AddStructureVarRW(cstr const name, s32* var, cstr const def);
+
+  //Targets from the shared pool. Transient targets are handed back at the end of Apply
+  wfe::RenderBuffer* AcquireTarget(s32 width, s32 height, RenderTargetFormat format = RT_FORMAT_RGBA8);
+  wfe::RenderBuffer* AcquireTransientTarget(s32 width, s32 height, RenderTargetFormat format = RT_FORMAT_RGBA8);
+  void ReleaseTarget(wfe::RenderBuffer*& target);
+
+  //Tells the shader which part of its input textures holds the image (uUVScale)
+  void EnableViewportUniforms(wfe::Shader* shader);
+  void EnableViewportUniforms(GLuint program);
+  //Location of uUVScale in the program, looked up once per program
+  static GLint GetUVScaleHandle(GLuint program);
+
+  //Uniform locations of a BlurHorizontal.fs or BlurVertical.fs program. Only
+  //looked up again when the effect switches to another variant
+  struct BlurHandles
+  {
+    BlurHandles();
+    void Update(GLuint program);
+
+    GLuint mProgram;
+    GLint mMapSize;
+    GLint mHalfSize;
+    GLint mBlurCutoff;
+    GLint mInvert;
+    GLint mNaiveDOF;
+    GLint mUVScale;
+    //Effects that draw the blur programs for passes of their own set these,
+    //the blur effects themselves go through EnableCombineUniforms
+    GLint mCombineMode;
+    GLint mOpacity;
+  };
+
+  //The program Apply and the recorded pass draw with, mProgram or mShader's own
+  GLuint GetProgramHandle() const { return mProgram ? mProgram : mShader->GetHandle(); }
+  //Specialized variant of mShader's fragment shader, see PostProShaderLibrary
+  GLuint GetShaderVariant(const std::string& fragmentFile, const PostProShaderDefines& defines);
+  //Sets uCombineMode and uOpacity for shaders that combine with their input themselves
+  void EnableCombineUniforms();
+  //True if mShader declares uCombineMode. Other shaders get an extra Combine.xml pass
+  b8 HasCombineSupport();
+  b8 RecordPass(PostProCommandList& list, wfe::RenderBuffer* source, wfe::RenderBuffer* dest);
+  void EnableInputTextures();
+
+  //Creates an effect that runs right before this one. It reads sourceName and
+  //publishes its result as outputName, both only visible inside this effect
+  PostProEffect* AddSubEffect(s32 type, const std::string& sourceName, const std::string& outputName);
+  //Shader the slot is set to by LoadShaders. Constructors must not touch GL,
+  //look up uniforms in PrepareDevice instead
+  void AddShader(wfe::Shader** shader, cstr const file);
+  //Variant of mShader LoadShaders starts compiling and IsReady waits for, so
+  //that GetShaderVariant does not compile it in the middle of a frame
+  void AddShaderVariant(cstr const fragmentFile, const PostProShaderDefines& defines);
+
+  static s32 sRenderWidth;
+  static s32 sRenderHeight;
+  static f32 sUVScale[2];
+  static u32 sStructureVersion;
+  static b8 sHDR;
+  
+  wfe::Shader* mShader;
+  //Variant of mShader to draw with, 0 draws with mShader's own program
+  GLuint mProgram;
+  std::vector<PostProEffect*> mSubEffects;
+  b8 mOutputsLDR;
+  b8 mOutputsAlpha;
+  b8 mUsesDepthPyramid;
+  //Set by effects whose shaders all apply uUVScale
+  b8 mSupportsRenderScale;
+private:
+  //////////////////////////////////////////////////////////////////////////
+  //Private member functions (functions for internal class use only)
+  void ReleaseTransientTargets();
+  void UpdateCombineHandles();
+  void ApplyCombinePass(wfe::RenderBuffer* result, wfe::RenderBuffer* base, wfe::RenderBuffer* dest);
+
+  //////////////////////////////////////////////////////////////////////////
+  //Private member data
+  PostProcessingCombineModes mCombineMode;
+  f32 mOpacity;
+
+  //Uniform locations in mCombineHandlesProgram, looked up again when the program changes
+  GLuint mCombineHandlesProgram;
+  GLint mCombineModeHandle;
+  GLint mOpacityHandle;
+  //Combine.xml, for effects whose shader does not combine itself
+  wfe::Shader* mCombineShader;
+  GLint mCombinePassModeHandle;
+  GLint mCombinePassOpacityHandle;
+
+  std::string mName;
+  std::string mNameFormatted;
+
+  std::vector<wfe::RenderBuffer*> mTransientTargets;
+
+  std::string mSourceName;
+  std::string mOutputName;
+  std::vector<PostProEffectInput> mInputs;
+  std::vector<wfe::RenderBuffer*> mInputTargets;
+  wfe::RenderBuffer* mCombineBase;
+  s32 mType;
+  std::vector<std::pair<wfe::Shader**, std::string> > mShaderFiles;
+  std::vector<std::pair<std::string, PostProShaderDefines> > mShaderVariants;
+  static std::map<GLuint, GLint> sUVScaleHandles;
+  b8 mShadersLoaded;
+  b8 mPrepared;
+}; // class PostProEffect
+
+class Desaturation : public PostProEffect
+{
+public:
+  Desaturation();
+
+  virtual void CreateATB();
+  virtual void EnableUniforms(wfe::RenderBuffer* source);
+  virtual b8 RecordUniforms(PostProCommandList& list, wfe::RenderBuffer* source);
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sType = DESATURATION;
+  //Static page size variable. This determines how many objects the object
+  //allocator places on one page
+  //Note: Components MUST have this!
+  static const u32 mObjPerPage = 8;
+
+  f32 mSaturation;
+};
+
+class SepiaTone : public PostProEffect
+{
+public:
+  SepiaTone();
+
+  virtual void CreateATB() {}
+  virtual b8 RecordUniforms(PostProCommandList& list, wfe::RenderBuffer* source);
+  //virtual void EnableUniforms(wfe::RenderBuffer* source);
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sType = SEPIA_TONE;
+  //Static page size variable. This determines how many objects the object
+  //allocator places on one page
+  //Note: Components MUST have this!
+  static const u32 mObjPerPage = 8;
+};
+
+class BlurHorizontal : public PostProEffect
+{
+public:
+  BlurHorizontal();
+
+  virtual void CreateATB();
+  virtual void EnableUniforms(wfe::RenderBuffer* source);
+  virtual b8 RecordUniforms(PostProCommandList& list, wfe::RenderBuffer* source);
+  virtual b8 Record(PostProCommandList& list, wfe::RenderBuffer* source, wfe::RenderBuffer* dest);
+  virtual void PreBindUpdate(wfe::RenderBuffer* source);
+  virtual b8 GetDepthMask(PostProDepthMaskRange& range) const;
+  virtual s32 GetSampleReach(s32, s32) const { return mHalfSize; }
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sType = BLUR_HORIZONTAL;
+  //Static page size variable. This determines how many objects the object
+  //allocator places on one page
+  //Note: Components MUST have this!
+  static const u32 mObjPerPage = 8;
+   s32 mHalfSize;
+private:
+ 
+  void UpdateProgram();
+
+  f32 mBlurCutoff;
+  b8 mInvert;
+  b8 mApplyNaiveDOF;
+  BlurHandles mHandles;
+};
+
+class BlurVertical : public PostProEffect
+{
+public:
+  BlurVertical();
+
+  virtual void CreateATB();
+  virtual void EnableUniforms(wfe::RenderBuffer* source);
+  virtual b8 RecordUniforms(PostProCommandList& list, wfe::RenderBuffer* source);
+  virtual b8 Record(PostProCommandList& list, wfe::RenderBuffer* source, wfe::RenderBuffer* dest);
+  virtual void PreBindUpdate(wfe::RenderBuffer* source);
+  virtual b8 GetDepthMask(PostProDepthMaskRange& range) const;
+  virtual s32 GetSampleReach(s32, s32) const { return mHalfSize; }
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sType = BLUR_VERTICAL;
+  //Static page size variable. This determines how many objects the object
+  //allocator places on one page
+  //Note: Components MUST have this!
+  static const u32 mObjPerPage = 8;
+  s32 mHalfSize;
+private:
+  
+  void UpdateProgram();
+
+  f32 mBlurCutoff;
+  b8 mInvert;
+  b8 mApplyNaiveDOF;
+  BlurHandles mHandles;
+};
+
+class BlackWhite : public PostProEffect
+{
+public:
+  BlackWhite();
+
+  virtual void CreateATB();
+  virtual void EnableUniforms(wfe::RenderBuffer* source);
+  virtual b8 RecordUniforms(PostProCommandList& list, wfe::RenderBuffer* source);
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sType = BLACK_WHITE;
+  //Static page size variable. This determines how many objects the object
+  //allocator places on one page
+  //Note: Components MUST have this!
+  static const u32 mObjPerPage = 8;
+
+private:
+  f32 mTolerance;
+};
+
+class UnsharpMaskingDepth : public PostProEffect
+{
+public:
+    UnsharpMaskingDepth();
+
+    virtual void CreateATB();
+    virtual void PrepareDevice();
+    virtual void EnableUniforms(wfe::RenderBuffer* source);
+    virtual s32 GetSampleReach(s32, s32) const { return mHalfSize; }
+
+    //////////////////////////////////////////////////////////////////////////
+    static const s32 sType = UNSHARP_MASKING_DEPTH;
+    //Static page size variable. This determines how many objects the object
+    //allocator places on one page
+    //Note: Components MUST have this!
+    static const u32 mObjPerPage = 8;
+
+private:
+    float mLambda;
+    GLint mLambdaHandle;
+    s32 mHalfSize;
+};
+
+
+class GaussianBlur : public PostProEffect
+{
+public:
+    GaussianBlur();
+
+    virtual void CreateATB();
+    virtual void PrepareDevice();
+    virtual void EnableUniforms(wfe::RenderBuffer* source);
+    virtual b8 RecordUniforms(PostProCommandList& list, wfe::RenderBuffer* source);
+    virtual s32 GetSampleReach(s32, s32) const { return static_cast<s32>(ceil(mRadius)); }
+
+    //////////////////////////////////////////////////////////////////////////
+    static const s32 sType = GAUSSIAN_BLUR;
+    //Static page size variable. This determines how many objects the object
+    //allocator places on one page
+    //Note: Components MUST have this!
+    static const u32 mObjPerPage = 8;
+
+    f32 mRadius;
+
+private:
+    GLint mRadiusHandle;
+};
+
+class Laplacian : public PostProEffect
+{
+public:
+    Laplacian();
+
+    virtual void CreateATB();
+    virtual void EnableUniforms(wfe::RenderBuffer* source);
+    virtual b8 RecordUniforms(PostProCommandList& list, wfe::RenderBuffer* source);
+
+    //////////////////////////////////////////////////////////////////////////
+    static const s32 sType = LAPLACIAN;
+    //Static page size variable. This determines how many objects the object
+    //allocator places on one page
+    //Note: Components MUST have this!
+    static const u32 mObjPerPage = 8;
+
+private:
+};
+
+class Sobel : public PostProEffect
+{
+public:
+    Sobel();
+
+    virtual void CreateATB();
+    virtual void EnableUniforms(wfe::RenderBuffer* source);
+    virtual b8 RecordUniforms(PostProCommandList& list, wfe::RenderBuffer* source);
+
+    //////////////////////////////////////////////////////////////////////////
+    static const s32 sType = SOBEL;
+    //Static page size variable. This determines how many objects the object
+    //allocator places on one page
+    //Note: Components MUST have this!
+    static const u32 mObjPerPage = 8;
+
+private:
+};
+
+class UnsharpMasking : public PostProEffect
+{
+public:
+  UnsharpMasking();
+
+  virtual void CreateATB();
+  virtual void PrepareDevice();
+  virtual void EnableUniforms(wfe::RenderBuffer* source);
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sType = UNSHARP_MASKING;
+  //Static page size variable. This determines how many objects the object
+  //allocator places on one page
+  //Note: Components MUST have this!
+  static const u32 mObjPerPage = 8;
+
+private:
+  float mWeightage;
+  GLint mWeightageHandle;
+};
+
+class Negative : public PostProEffect
+{
+public:
+  Negative();
+
+  virtual void CreateATB() {}
+  virtual b8 RecordUniforms(PostProCommandList& list, wfe::RenderBuffer* source);
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sType = NEGATIVE;
+  //Static page size variable. This determines how many objects the object
+  //allocator places on one page
+  //Note: Components MUST have this!
+  static const u32 mObjPerPage = 8;
+};
+
+class HueChange : public PostProEffect
+{
+public:
+  HueChange();
+
+  virtual void CreateATB();
+  virtual void PrepareDevice();
+  virtual void EnableUniforms(wfe::RenderBuffer* source);
+  virtual b8 RecordUniforms(PostProCommandList& list, wfe::RenderBuffer* source);
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sType = HUE_CHANGE;
+  //Static page size variable. This determines how many objects the object
+  //allocator places on one page
+  //Note: Components MUST have this!
+  static const u32 mObjPerPage = 8;
+private:
+  f32 mHue;
+  f32 mSaturation;
+  f32 mValue;
+  GLint mHueHandle;
+  GLint mSaturationHandle;
+  GLint mValueHandle;
+};
+
+class RealisticDOF : public PostProEffect
+{
+public:
+  RealisticDOF();
+
+  virtual void CreateATB();
+  virtual void PrepareDevice();
+  virtual void EnableUniforms(wfe::RenderBuffer* source);
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sType = REALISTIC_DOF;
+  //Static page size variable. This determines how many objects the object
+  //allocator places on one page
+  //Note: Components MUST have this!
+  static const u32 mObjPerPage = 8;
+private:
+  f32 mBias;
+  b8 mInvert;
+  u32 mInvertHandle;
+  u32 mBiasHandle;
+};
+
+class BlurHorizontalDepth : public PostProEffect
+{
+public:
+  BlurHorizontalDepth();
+
+  virtual void CreateATB() {}
+  virtual void EnableUniforms(wfe::RenderBuffer* source);
+  virtual void PreBindUpdate(wfe::RenderBuffer* source);
+  virtual s32 GetSampleReach(s32, s32) const { return mHalfSize; }
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sType = BLUR_HORIZONTAL_DEPTH;
+  //Static page size variable. This determines how many objects the object
+  //allocator places on one page
+  //Note: Components MUST have this!
+  static const u32 mObjPerPage = 8;
+
+private:
+  s32 mHalfSize;
+  BlurHandles mHandles;
+};
+
+class BlurVerticalDepth : public PostProEffect
+{
+public:
+  BlurVerticalDepth();
+
+  virtual void CreateATB() {}
+  virtual void EnableUniforms(wfe::RenderBuffer* source);
+  virtual void PreBindUpdate(wfe::RenderBuffer* source);
+  virtual s32 GetSampleReach(s32, s32) const { return mHalfSize; }
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sType = BLUR_VERTICAL_DEPTH;
+  //Static page size variable. This determines how many objects the object
+  //allocator places on one page
+  //Note: Components MUST have this!
+  static const u32 mObjPerPage = 8;
+
+private:
+  s32 mHalfSize;
+  BlurHandles mHandles;
+};
+
+class AdditiveNoise : public PostProEffect
+{
+public:
+    AdditiveNoise();
+
+    ~AdditiveNoise();
+
+    virtual void CreateATB();
+    virtual void EnableUniforms(wfe::RenderBuffer* source);
+    virtual void PrepareHost();
+    virtual void PrepareDevice();
+
+    //////////////////////////////////////////////////////////////////////////
+    static const s32 sType = ADDITIVE_NOISE;
+    //Static page size variable. This determines how many objects the object
+    //allocator places on one page
+    //Note: Components MUST have this!
+    static const u32 mObjPerPage = 8;
+
+private:
+    wfe::RenderBuffer* mNoisyTarget;
+    u8* mNoiseData;
+    s32 mNoiseWidth;
+    s32 mNoiseHeight;
+
+    GLint mOffsetXHandle;
+    GLint mOffsetYHandle;
+    GLint mBiasHandle;
+
+    f32 mBias;
+};
+
+
+
+class BloomCombine : public PostProEffect
+{
+public:
+	BloomCombine();
+
+	virtual void CreateATB();
+	virtual void PrepareDevice();
+	virtual void EnableUniforms(wfe::RenderBuffer* source);
+	virtual void PreBindUpdate(wfe::RenderBuffer* source  );
+	virtual s32 GetSampleReach(s32 width, s32 height) const;
+	//////////////////////////////////////////////////////////////////////////
+	static const s32 sType = BLOOM;
+	//Static page size variable. This determines how many objects the object
+	//allocator places on one page
+	//Note: Components MUST have this!
+	static const u32 mObjPerPage = 8;
+
+private:
+   wfe::RenderBuffer* mRenderBuffer[6]; //Transient, only valid during Apply
+   wfe::Shader* mBlurVerticalShader;
+   wfe::Shader* mBlurHorizontalShader;
+   BlurHandles mVerticalHandles;
+   BlurHandles mHorizontalHandles;
+   LuminanceThreshold* mThreshold;
+
+	 GLint locC1, locC2, locC3, locC4,locC5;
+	 float m_coefP1, m_coefP1x, m_coefP1y, m_coefP1z, m_coefP2;
+
+};
+
+class LuminanceThreshold : public PostProEffect
+{
+public:
+  LuminanceThreshold();
+
+  virtual void CreateATB() {}
+  virtual void PrepareDevice();
+  //Only the adaptive shader applies uUVScale
+  virtual b8 SupportsRenderScale() const { return mAdaptive; }
+  virtual void EnableUniforms(wfe::RenderBuffer* source);
+  virtual b8 RecordUniforms(PostProCommandList& list, wfe::RenderBuffer* source);
+  virtual b8 Record(PostProCommandList& list, wfe::RenderBuffer* source, wfe::RenderBuffer* dest);
+  virtual void PreBindUpdate(wfe::RenderBuffer* source);
+  virtual b8 UsesExposure() const { return mAdaptive; }
+
+  friend class BloomCombine;
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sType = LUMINANCE_THRESHOLD;
+  //Static page size variable. This determines how many objects the object
+  //allocator places on one page
+  //Note: Components MUST have this!
+  static const u32 mObjPerPage = 8;
+
+private:
+  void UpdateShader();
+
+  wfe::Shader* mFixedShader;
+  wfe::Shader* mAdaptiveShader;
+  b8 mAdaptive; //Threshold relative to the automatic exposure
+  f32 mThreshold;
+};
+
+class OldFilm : public PostProEffect
+{
+public:
+	OldFilm();
+
+	virtual void CreateATB();
+	virtual void PrepareDevice();
+	virtual void EnableUniforms(wfe::RenderBuffer* source);
+
+	//////////////////////////////////////////////////////////////////////////
+	static const s32 sType = OLD_FILM;
+	//Static page size variable. This determines how many objects the object
+	//allocator places on one page
+	//Note: Components MUST have this!
+	static const u32 mObjPerPage = 8;
+
+private:
+	GLint mSepiaHandle, mNoiseHandle, mScratchHandle,
+		  mInnerVignettingHandle, mOuterVignettingHandle,
+		  mRandomValueHandle, mTimeLapseHandle;
+	float mSepiaVaue, mNoiseValue, mScratchValue,
+		  mInnerVignetting, mOuterVignetting, 
+		  mRandomValue, mTimeLapse, m_multiplier;
+
+
+};
+
+class PPSSAO : public PostProEffect
+{
+public:
+  PPSSAO();
+  ~PPSSAO();
+
+  virtual void CreateATB();
+  virtual void EnableUniforms(wfe::RenderBuffer* source);
+  virtual void PreBindUpdate(wfe::RenderBuffer* source);
+  virtual s32 GetSampleReach(s32 width, s32 height) const;
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sType = SSAO;
+  //Static page size variable. This determines how many objects the object
+  //allocator places on one page
+  //Note: Components MUST have this!
+  static const u32 mObjPerPage = 8;
+  //The half resolution depth is split into sLayers x sLayers interleaved layers
+  static const s32 sLayers = 4;
+
+private:
+  void DrawBlurPass(wfe::RenderBuffer* source, wfe::RenderBuffer* dest, f32 dirX, f32 dirY, s32 halfWidth, s32 halfHeight, s32 halfRectWidth, s32 halfRectHeight);
+
+  wfe::Shader* mDeinterleaveShader;
+  wfe::Shader* mLayerShader;
+  wfe::Shader* mReinterleaveShader;
+  wfe::Shader* mBlurShader;
+  wfe::RenderBuffer* mAO; //Transient, only valid during Apply
+
+  //Rotation (xy) and radius jitter (z) of the single sample pattern each layer uses
+  f32 mLayerPattern[sLayers * sLayers * 4];
+  f32 mBlurSharpness;
+
+  f32 mAOStrength;
+  f32 mAOSampleDistance;
+  f32 mAOScale;
+  s32 mAOSamples;
+  s32 mAOSamples2;
+};
+
+class Fog : public PostProEffect
+{
+public:
+    Fog();
+    ~Fog();
+
+    virtual void CreateATB();
+    virtual void EnableUniforms(wfe::RenderBuffer* source);
+    virtual void PreBindUpdate(wfe::RenderBuffer* source);
+    virtual void PrepareDevice();
+    virtual b8 GetDepthMask(PostProDepthMaskRange& range) const;
+    virtual s32 GetSampleReach(s32, s32) const { return Clamp<s32>(mResolutionDivisor, 1, 4) + 1; }
+
+    //////////////////////////////////////////////////////////////////////////
+    static const s32 sType = FOG;
+    //Static page size variable. This determines how many objects the object
+    //allocator places on one page
+    //Note: Components MUST have this!
+    static const u32 mObjPerPage = 8;
+
+private:
+    void UpdateFrustumRays(wfe::RenderBuffer* source);
+    void DrawFogQuad();
+
+    static const u32 sQuadVertexSize = 8;
+
+    wfe::Shader* mFogShader;
+    wfe::RenderBuffer* mFogTarget; //Transient, only valid during Apply
+    GLuint mQuadBuffer;
+    GLint mVertexAttrib;
+    GLint mTexCoordAttrib;
+    GLint mFrustumRayAttrib;
+
+    GLint mCameraViewVecHandle;
+    GLint mCameraEyePosHandle;
+    GLint mCameraNear;
+    GLint mCameraFar;
+    GLint mMaxDepthHandle;
+    GLint mLowResSizeHandle;
+    GLint mLowResRectHandle;
+    b8 mAttribsValid; //False when the fog shader lost one of its attributes
+
+    //Depth of the far plane, anything at or past it is sky and gets no fog
+    static const f32 sSkyDepth;
+
+    //Camera the rays were computed for
+    b8 mRaysValid;
+    Matrix4 mWorldToView;
+    f32 mFov;
+    f32 mAspect;
+    f32 mNear;
+    f32 mFar;
+    Vec3 mViewVec;
+
+    s32 mResolutionDivisor;
+    f32 mLowResSize[2];
+    f32 mLowResRect[2];
+};
+
+//Maps HDR color to 0..1. Everything after it in the stack runs in RGBA8
+class Tonemap : public PostProEffect
+{
+public:
+  Tonemap();
+
+  virtual void CreateATB();
+  virtual void PrepareDevice();
+  virtual void EnableUniforms(wfe::RenderBuffer* source);
+  virtual b8 RecordUniforms(PostProCommandList& list, wfe::RenderBuffer* source);
+  virtual b8 UsesExposure() const { return mAutoExposure; }
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sType = TONEMAP;
+  //Static page size variable. This determines how many objects the object
+  //allocator places on one page
+  //Note: Components MUST have this!
+  static const u32 mObjPerPage = 8;
+
+private:
+  f32 mExposure; //Scales the automatic exposure when that is on
+  b8 mFilmic; //ACES fit instead of Reinhard
+  b8 mAutoExposure;
+  GLint mExposureHandle;
+  GLint mFilmicHandle;
+  GLint mAutoExposureHandle;
+};
+
+//Depth of field with a gather blur at half resolution. Tiles of the image are
+//classified by their circle of confusion first, so in focus tiles skip the blur
+class BokehDOF : public PostProEffect
+{
+public:
+  BokehDOF();
+
+  virtual void CreateATB();
+  virtual void EnableUniforms(wfe::RenderBuffer* source);
+  virtual void PreBindUpdate(wfe::RenderBuffer* source);
+  virtual s32 GetSampleReach(s32 width, s32 height) const;
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sType = BOKEH_DOF;
+  //Static page size variable. This determines how many objects the object
+  //allocator places on one page
+  //Note: Components MUST have this!
+  static const u32 mObjPerPage = 8;
+  //Tile size in half resolution pixels. Larger CoCs than this get cut off
+  static const s32 sTileSize = 16;
+
+private:
+  void EnableFocusUniforms(wfe::Shader* shader);
+
+  wfe::Shader* mCoCShader;
+  wfe::Shader* mTileShader;
+  wfe::Shader* mGatherShader;
+  wfe::RenderBuffer* mBokeh; //Transient, only valid during Apply
+
+  f32 mFocusDepth;
+  f32 mFocusRange;
+  f32 mMaxCoC;
+  s32 mSamples;
+};
+
+//Box blur out of a summed-area table. The table takes log4(size) passes per
+//axis to build, after that any radius costs four fetches, and the radius can
+//change from pixel to pixel. With the depth radius on it grows with the
+//distance to the focus depth
+class SATBlur : public PostProEffect
+{
+public:
+  SATBlur();
+
+  virtual void CreateATB();
+  virtual void EnableUniforms(wfe::RenderBuffer* source);
+  virtual void PreBindUpdate(wfe::RenderBuffer* source);
+  virtual s32 GetSampleReach(s32, s32) const { return static_cast<s32>(ceil(mRadius)) + 1; }
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sType = SAT_BLUR;
+  //Static page size variable. This determines how many objects the object
+  //allocator places on one page
+  //Note: Components MUST have this!
+  static const u32 mObjPerPage = 8;
+  //Texels every prefix pass adds up, keep in sync with SATPrefix.fs
+  static const s32 sRadix = 4;
+
+private:
+  void DrawPrefixPass(wfe::RenderBuffer* source, wfe::RenderBuffer* dest, s32 stepX, s32 stepY, b8 firstPass);
+
+  wfe::Shader* mPrefixShader;
+  wfe::Shader* mMeanShader;
+  wfe::RenderBuffer* mTable; //Transient, only valid during Apply
+  wfe::RenderBuffer* mMean; //Transient, taken off the image before it is summed
+  s32 mTableWidth;
+  s32 mTableHeight;
+
+  f32 mRadius;
+  b8 mDepthRadius;
+  f32 mFocusDepth;
+  f32 mFocusRange;
+};
+//Convolution with a kernel from the UI or a preset. The kernel is factored by
+//SVD into rank-1 terms, each of them a horizontal and a vertical pass. The
+//effect runs the fewest terms that stay within the tolerance when that needs
+//fewer taps than running the kernel directly
+class Convolution : public PostProEffect
+{
+public:
+  enum Preset
+  {
+    PRESET_IDENTITY,
+    PRESET_SHARPEN,
+    PRESET_EMBOSS,
+    PRESET_BOX,
+    PRESET_GAUSSIAN,
+    PRESET_DIRECTIONAL,
+    PRESET_LENS,
+    PRESET_NUM
+  };
+
+  Convolution();
+
+  virtual void CreateATB();
+  virtual void EnableUniforms(wfe::RenderBuffer* source);
+  virtual void PreBindUpdate(wfe::RenderBuffer* source);
+  //Every rank-1 term reaches as far as the kernel does
+  virtual s32 GetSampleReach(s32, s32) const { return mSize / 2; }
+
+  //size x size weights, row by row from the top. Returns false if size is not
+  //odd or larger than sMaxSize, the kernel stays as it was then
+  b8 SetKernel(const std::vector<f32>& weights, s32 size);
+  //Same as SetKernel with the weights as text, rows split by ';'
+  b8 SetKernelText(cstr text);
+  void LoadPreset(s32 preset);
+
+  s32 GetPreset() const { return mPreset; }
+  s32 GetKernelSize() const { return mSize; }
+  cstr GetKernelText() const { return mKernelText; }
+  //Number of rank-1 terms the kernel runs as, 0 when it runs directly
+  s32 GetRank() const { return mRank; }
+  //Texture fetches per pixel of the plan
+  u32 GetTapCount() const { return mTapCount; }
+  u32 GetPassCount() const { return mRank ? mRank * 2 : 1; }
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sType = CONVOLUTION;
+  //Static page size variable. This determines how many objects the object
+  //allocator places on one page
+  //Note: Components MUST have this!
+  static const u32 mObjPerPage = 8;
+  static const s32 sMaxSize = 15;
+  //Size of the tap array in Convolution.fs
+  static const u32 sMaxTaps = 128;
+  static const u32 sTextSize = 2048;
+
+private:
+  void UpdatePlan();
+  void UpdateKernelText();
+  void DrawPass(wfe::RenderBuffer* source, wfe::RenderBuffer* dest, const std::vector<f32>& taps);
+
+  std::vector<f32> mKernel;
+  s32 mSize;
+  s32 mPreset;
+  f32 mBias;
+  //Largest part of the kernel the dropped terms may hold, relative to the whole
+  f32 mTolerance;
+  char mKernelText[sTextSize];
+
+  //Plan, taps are x and y offset in texels and the weight
+  f32 mPlanTolerance;
+  s32 mRank;
+  u32 mTapCount;
+  std::vector<f32> mDirectTaps;
+  std::vector<std::vector<f32> > mHorizontalTaps;
+  std::vector<std::vector<f32> > mVerticalTaps;
+
+  wfe::RenderBuffer* mHorizontal; //Transient, only valid during Apply
+  wfe::RenderBuffer* mAccumulated; //Transient, only valid during Apply
+};
+//Edge preserving smoothing. The image is splatted into a coarse 3D grid of
+//position and intensity, the grid is blurred along its three axes and every
+//pixel reads its color back out of the grid at its own intensity. Pixels on
+//the other side of an edge land in other slices and do not mix. The grid is
+//mSpatial times smaller than the image, so a larger radius makes it cheaper
+class BilateralGrid : public PostProEffect
+{
+public:
+  BilateralGrid();
+  ~BilateralGrid();
+
+  virtual void CreateATB();
+  virtual void PrepareDevice();
+  virtual void EnableUniforms(wfe::RenderBuffer* source);
+  virtual void PreBindUpdate(wfe::RenderBuffer* source);
+  //The blur reaches one cell each way, the slice interpolates with the next
+  virtual s32 GetSampleReach(s32, s32) const { return static_cast<s32>(ceil(std::max(mSpatial, 1.f) * 3.f)); }
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sType = BILATERAL_GRID;
+  //Static page size variable. This determines how many objects the object
+  //allocator places on one page
+  //Note: Components MUST have this!
+  static const u32 mObjPerPage = 8;
+
+private:
+  void DrawBlurPass(wfe::RenderBuffer* source, wfe::RenderBuffer* dest, f32 stepX, f32 stepY);
+  void EnableGridUniforms(wfe::Shader* shader);
+
+  wfe::Shader* mSplatShader;
+  wfe::Shader* mBlurShader;
+  wfe::RenderBuffer* mGrid; //Transient, only valid during Apply
+
+  //Pixel columns of a row, every instance of the splat draw is a row
+  GLuint mRowBuffer;
+  s32 mRowBufferWidth;
+  GLint mPixelAttrib;
+
+  f32 mSpatial; //Pixels per grid cell
+  f32 mRange; //Intensity per grid slice
+
+  //Layout of the grid this frame. The slices lie side by side in one target,
+  //every axis has an empty cell on both ends
+  s32 mSliceWidth;
+  s32 mGridHeight;
+  s32 mSlices;
+  f32 mGridScale[3];
+};
+//Fast approximate anti-aliasing, one pass over luminance. Put it after the
+//Tonemap effect, the edge thresholds assume 0..1 values
+class PPFXAA : public PostProEffect
+{
+public:
+  PPFXAA();
+
+  virtual void CreateATB();
+  virtual void PrepareDevice();
+  virtual void EnableUniforms(wfe::RenderBuffer* source);
+  virtual b8 RecordUniforms(PostProCommandList& list, wfe::RenderBuffer* source);
+  //The edge end search of FXAA.fs walks up to 21 pixels each way
+  virtual s32 GetSampleReach(s32, s32) const { return 22; }
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sType = FXAA;
+  //Static page size variable. This determines how many objects the object
+  //allocator places on one page
+  //Note: Components MUST have this!
+  static const u32 mObjPerPage = 8;
+
+private:
+  f32 mSubpixel;
+  f32 mEdgeThreshold;
+  f32 mEdgeThresholdMin;
+  GLint mSubpixelHandle;
+  GLint mEdgeThresholdHandle;
+  GLint mEdgeThresholdMinHandle;
+};
+
+//Subpixel morphological anti-aliasing (SMAA 1x without diagonal patterns).
+//Edges are found first, then the blend weights of every edge pixel from the
+//length of the edge and the shape of its ends, then the pixels are blended
+//with their neighbours. The area and search lookup textures are computed when
+//the effect is prepared. Like FXAA it goes after the Tonemap effect
+class PPSMAA : public PostProEffect
+{
+public:
+  PPSMAA();
+  ~PPSMAA();
+
+  virtual void CreateATB();
+  virtual void EnableUniforms(wfe::RenderBuffer* source);
+  virtual void PreBindUpdate(wfe::RenderBuffer* source);
+  virtual void PrepareHost();
+  virtual void PrepareDevice();
+  //Edge search, then the edges and weights of the pixels next to it
+  virtual s32 GetSampleReach(s32, s32) const { return sMaxDistance + 2; }
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sType = SMAA;
+  //Static page size variable. This determines how many objects the object
+  //allocator places on one page
+  //Note: Components MUST have this!
+  static const u32 mObjPerPage = 8;
+  //Longest edge the search follows, keep in sync with SMAAWeights.fs
+  static const s32 sMaxDistance = 16;
+  //4x4 crossing edge patterns of sMaxDistance x sMaxDistance distances
+  static const s32 sAreaSize = sMaxDistance * 4;
+  static const s32 sSearchSize = 8;
+
+private:
+  wfe::Shader* mEdgeShader;
+  wfe::Shader* mWeightShader;
+  wfe::RenderBuffer* mWeights; //Transient, only valid during Apply
+
+  std::vector<u8> mAreaData; //Only until PrepareDevice uploaded it
+  std::vector<u8> mSearchData;
+  GLuint mAreaTexture;
+  GLuint mSearchTexture;
+
+  f32 mThreshold;
+};
+
 #endif // PostProH
\ No newline at end of file
@@ -0,0 +1,176 @@
+/******************************************************************************/
+/*!
+\file   PostProExposure.cpp
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Automatic exposure from a luminance histogram of the scene, built and adapted
+on the GPU once per frame. Effects read the result straight from a 1x1
+target, so nothing ever waits for a readback
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+
+/*****************************************************************************/
+/*!
+Includes
+*/
+/*****************************************************************************/
+#include "Precompiled.h" //Precompiled header
+#include "RenderBuffer.h"
+#include "GraphicsManager.h"
+#include "ShaderManager.h"
+#include "RenderTargetPool.h"
+#include "PostProEffect.h"
+#include "PostProStateCache.h"
+#include "PostProcessingManager.h"
+
+#include "PostProExposure.h" //Own header
+
+/*****************************************************************************/
+/*!
+Use the engine namespace, for convenience
+*/
+/*****************************************************************************/
+using namespace wfe;
+
+PostProExposure::PostProExposure() : mPointBuffer(0), mTexCoordAttrib(-1), mLastTime(-1.f)
+{
+  mSettings.mKey = .18f;
+  mSettings.mAdaptationSpeed = 1.5f;
+  mSettings.mMinExposure = .03f;
+  mSettings.mMaxExposure = 32.f;
+  mSettings.mLowPercent = .5f;
+  mSettings.mHighPercent = .95f;
+
+  mLuminanceShader = &WFE_SHADER_MANAGER->GetResource("ExposureLuminance.xml");
+  mHistogramShader = &WFE_SHADER_MANAGER->GetResource("ExposureHistogram.xml");
+  mAdaptShader = &WFE_SHADER_MANAGER->GetResource("ExposureAdapt.xml");
+
+  //None of these depend on the resolution
+  RenderTargetPool* pool = PostProcessingManager::sRenderTargetPool;
+  mLuminance = pool->Acquire(sLuminanceSize, sLuminanceSize, RT_FORMAT_RGBA16F, 0);
+  //Counts go up to 64*64, past what half floats hold exactly
+  mHistogram = pool->Acquire(sBins, 1, RT_FORMAT_RGBA32F, 0);
+  mPrevious = pool->Acquire(1, 1, RT_FORMAT_RGBA16F, 0);
+  mExposure = pool->Acquire(1, 1, RT_FORMAT_RGBA16F, 0);
+
+  //No exposure yet, the first frame takes the measured one as is
+  GLfloat clearColor[4];
+  glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+  glClearColor(0.f, 0.f, 0.f, 0.f);
+  mExposure->Bind();
+  glClear(GL_COLOR_BUFFER_BIT);
+  glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+
+  std::vector<f32> points;
+  points.reserve(sLuminanceSize * sLuminanceSize * 2);
+  for (s32 y = 0; y < sLuminanceSize; ++y)
+  {
+    for (s32 x = 0; x < sLuminanceSize; ++x)
+    {
+      points.push_back((x + .5f) / sLuminanceSize);
+      points.push_back((y + .5f) / sLuminanceSize);
+    }
+  }
+
+  glGenBuffers(1, &mPointBuffer);
+  glBindBuffer(GL_ARRAY_BUFFER, mPointBuffer);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(f32) * points.size(), &points[0], GL_STATIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  mTexCoordAttrib = glGetAttribLocation(mHistogramShader->GetHandle(), "aTexCoord");
+}
+
+PostProExposure::~PostProExposure()
+{
+  RenderTargetPool* pool = PostProcessingManager::sRenderTargetPool;
+  pool->Release(mLuminance);
+  pool->Release(mHistogram);
+  pool->Release(mPrevious);
+  pool->Release(mExposure);
+
+  glDeleteBuffers(1, &mPointBuffer);
+}
+
+/*****************************************************************************/
+/*!
+The scene is reduced to 64x64 log luminance values, every one of them is
+counted into its bin as a point with additive blending, and a single
+fragment walks the 64 bins to find the average between the percentiles.
+All of it stays on the GPU, the effects sample the 1x1 result
+*/
+/*****************************************************************************/
+void PostProExposure::Build(RenderBuffer* scene)
+{
+  PostProStateCache* state = PostProcessingManager::sStateCache;
+
+  f32 time = WFE_FRC->GetLevelTime();
+  f32 deltaTime = mLastTime < 0.f ? 0.f : Clamp<f32>(time - mLastTime, 0.f, 1.f);
+  mLastTime = time;
+
+  state->SetCombineBlending(POSTPRO_CM_REPLACE);
+
+  //Log luminance of the render rect
+  state->SwitchShader(mLuminanceShader);
+  state->EnableTexture(scene->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  glUniform2f(glGetUniformLocation(mLuminanceShader->GetHandle(), "uUVScale"),
+    static_cast<f32>(PostProEffect::GetRenderWidth()) / scene->GetWidth(),
+    static_cast<f32>(PostProEffect::GetRenderHeight()) / scene->GetHeight());
+  mLuminance->Bind();
+  glViewport(0, 0, sLuminanceSize, sLuminanceSize);
+  WFE_GRAPHICS->DrawOverScreen();
+
+  //Histogram, every point counts once in its bin
+  GLfloat clearColor[4];
+  glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+  glClearColor(0.f, 0.f, 0.f, 0.f);
+  mHistogram->Bind();
+  glViewport(0, 0, sBins, 1);
+  glClear(GL_COLOR_BUFFER_BIT);
+  glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+
+  state->SwitchShader(mHistogramShader);
+  state->EnableTexture(mLuminance->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  glUniform1f(glGetUniformLocation(mHistogramShader->GetHandle(), "uMinLog"), static_cast<f32>(sMinLog));
+  glUniform1f(glGetUniformLocation(mHistogramShader->GetHandle(), "uMaxLog"), static_cast<f32>(sMaxLog));
+  glUniform1f(glGetUniformLocation(mHistogramShader->GetHandle(), "uBins"), static_cast<f32>(sBins));
+
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_ONE, GL_ONE);
+  glBindBuffer(GL_ARRAY_BUFFER, mPointBuffer);
+  glEnableVertexAttribArray(mTexCoordAttrib);
+  glVertexAttribPointer(mTexCoordAttrib, 2, GL_FLOAT, GL_FALSE, 0, 0);
+  glDrawArrays(GL_POINTS, 0, sLuminanceSize * sLuminanceSize);
+  glDisableVertexAttribArray(mTexCoordAttrib);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glDisable(GL_BLEND);
+
+  //Keep last frame's exposure to adapt from
+  GLint exposureFramebuffer = 0;
+  mExposure->Bind();
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &exposureFramebuffer);
+  mPrevious->Bind();
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, exposureFramebuffer);
+  glBlitFramebuffer(0, 0, 1, 1, 0, 0, 1, 1, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+  state->SwitchShader(mAdaptShader);
+  state->EnableTexture(mHistogram->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  state->EnableTexture(mPrevious->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_BLOOMZERO);
+  glUniform1f(glGetUniformLocation(mAdaptShader->GetHandle(), "uMinLog"), static_cast<f32>(sMinLog));
+  glUniform1f(glGetUniformLocation(mAdaptShader->GetHandle(), "uMaxLog"), static_cast<f32>(sMaxLog));
+  glUniform1f(glGetUniformLocation(mAdaptShader->GetHandle(), "uKey"), mSettings.mKey);
+  glUniform1f(glGetUniformLocation(mAdaptShader->GetHandle(), "uMinExposure"), mSettings.mMinExposure);
+  glUniform1f(glGetUniformLocation(mAdaptShader->GetHandle(), "uMaxExposure"), mSettings.mMaxExposure);
+  glUniform1f(glGetUniformLocation(mAdaptShader->GetHandle(), "uLowPercent"), mSettings.mLowPercent);
+  glUniform1f(glGetUniformLocation(mAdaptShader->GetHandle(), "uHighPercent"), std::max(mSettings.mHighPercent, mSettings.mLowPercent + .01f));
+  glUniform1f(glGetUniformLocation(mAdaptShader->GetHandle(), "uAdaptation"), 1.f - exp(-deltaTime * mSettings.mAdaptationSpeed));
+  glUniform1f(glGetUniformLocation(mAdaptShader->GetHandle(), "uInvCount"), 1.f / (sLuminanceSize * sLuminanceSize));
+  mExposure->Bind();
+  glViewport(0, 0, 1, 1);
+  WFE_GRAPHICS->DrawOverScreen();
+
+  //All targets were bound behind the cache's back
+  state->Invalidate();
+}
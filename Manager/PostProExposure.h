@@ -0,0 +1,89 @@
+/******************************************************************************/
+/*!
+\file   PostProExposure.h
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Automatic exposure from a luminance histogram of the scene, built and adapted
+on the GPU once per frame. Effects read the result straight from a 1x1
+target, so nothing ever waits for a readback
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+#ifndef POSTPROEXPOSURE_H
+#define POSTPROEXPOSURE_H
+
+/*****************************************************************************/
+/*!
+  Forward Declarations
+*/
+/*****************************************************************************/
+namespace wfe
+{
+  class RenderBuffer;
+  class Shader;
+}
+
+/*****************************************************************************/
+/*!
+  Type Declarations (Types that are associated with this class declared here)
+*/
+/*****************************************************************************/
+struct PostProExposureSettings
+{
+  f32 mKey;             //Scene luminance that ends up at this value after exposure
+  f32 mAdaptationSpeed; //Higher adapts faster, per second
+  f32 mMinExposure;
+  f32 mMaxExposure;
+  f32 mLowPercent;      //Darkest part of the histogram that is ignored, 0..1
+  f32 mHighPercent;     //Brightest part above this is ignored, 0..1
+};
+
+class PostProExposure
+{
+public:
+  //////////////////////////////////////////////////////////////////////////
+  //Ctors
+  PostProExposure();
+  ~PostProExposure();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Member functions
+  //Measures the scene and moves the exposure towards it. Call before the effects run
+  void Build(wfe::RenderBuffer* scene);
+
+  //////////////////////////////////////////////////////////////////////////
+  //Getters (Implement simple ones here)
+  PostProExposureSettings& GetSettings() { return mSettings; }
+  //Exposure in r, average scene luminance in g. The handle never changes, so it can be recorded
+  wfe::RenderBuffer* GetExposure() const { return mExposure; }
+
+  //////////////////////////////////////////////////////////////////////////
+  static const s32 sLuminanceSize = 64;
+  static const s32 sBins = 64;
+  //Range of log2 luminance the bins cover
+  static const s32 sMinLog = -10;
+  static const s32 sMaxLog = 6;
+
+private:
+  //////////////////////////////////////////////////////////////////////////
+  //Private member data
+  PostProExposureSettings mSettings;
+
+  wfe::RenderBuffer* mLuminance;
+  wfe::RenderBuffer* mHistogram;
+  wfe::RenderBuffer* mPrevious;
+  wfe::RenderBuffer* mExposure;
+
+  wfe::Shader* mLuminanceShader;
+  wfe::Shader* mHistogramShader;
+  wfe::Shader* mAdaptShader;
+
+  //One point per luminance texel
+  GLuint mPointBuffer;
+  GLint mTexCoordAttrib;
+  f32 mLastTime;
+}; // class PostProExposure
+
+#endif // POSTPROEXPOSURE_H
@@ -0,0 +1,285 @@
+/******************************************************************************/
+/*!
+\file   PostProGraph.cpp
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Schedules the post processing stack as a graph of named results
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+
+/*****************************************************************************/
+/*!
+Includes
+*/
+/*****************************************************************************/
+#include "Precompiled.h" //Precompiled header
+#include "RenderBuffer.h"
+#include "GraphicsManager.h"
+#include "PostProEffect.h"
+#include "PostProCommandList.h"
+#include "PostProcessingManager.h"
+#include "RenderTargetPool.h"
+
+#include "PostProGraph.h" //Own header
+
+/*****************************************************************************/
+/*!
+Use the engine namespace, for convenience
+*/
+/*****************************************************************************/
+using namespace wfe;
+
+PostProGraph::PostProGraph() : mLiveNodeCount(0), mUsesDepthPyramid(false), mUsesExposure(false)
+{
+}
+
+PostProGraph::~PostProGraph()
+{
+  Clear();
+}
+
+/*****************************************************************************/
+/*!
+Turns the effects into nodes, drops the ones nobody reads, assigns targets
+and records the live nodes in order. Effects can only read results of nodes
+added before them, so the order they were added in is already a valid order
+to run them in
+*/
+/*****************************************************************************/
+void PostProGraph::Build(const std::vector<PostProEffect*>& effects, RenderBuffer* original, PostProCommandList& list)
+{
+  Clear();
+  list.Clear();
+
+  PostProResourceScope scope;
+  scope["original"] = scope["previous"] = AddResource(original, PostProEffect::GetColorFormat(false), !PostProEffect::IsHDR());
+  scope["depth"] = AddResource(WFE_GRAPHICS->GetDepthAndNormalBuffer(), RT_FORMAT_RGBA8, true);
+
+  for (u32 i = 0; i < effects.size(); ++i)
+  {
+    AddNodes(effects[i], scope);
+
+    std::stringstream ss;
+    ss << "effect" << i;
+    scope[ss.str()] = scope["previous"];
+  }
+
+  s32 output = scope["previous"];
+  FindLiveNodes(output);
+  AllocateTargets(original->GetWidth(), original->GetHeight());
+
+  std::vector<Node>::iterator ite = mNodes.begin();
+  while (ite != mNodes.end())
+  {
+    Node& node = *ite;
+    ++ite;
+
+    if (!node.mLive)
+    {
+      continue;
+    }
+
+    mUsesDepthPyramid = mUsesDepthPyramid || node.mEffect->UsesDepthPyramid();
+    mUsesExposure = mUsesExposure || node.mEffect->UsesExposure();
+
+    std::vector<RenderBuffer*> inputs;
+    for (u32 i = 0; i < node.mInputs.size(); ++i)
+    {
+      inputs.push_back(mResources[node.mInputs[i]].mTarget);
+    }
+    node.mEffect->SetInputTargets(inputs);
+
+    RenderBuffer* source = mResources[node.mSource].mTarget;
+    RenderBuffer* dest = mResources[node.mOutput].mTarget;
+    node.mEffect->SetCombineBase(node.mBase == -1 ? source : mResources[node.mBase].mTarget);
+
+    if (!node.mEffect->Record(list, source, dest))
+    {
+      list.AddEffectPass(node.mEffect, source, dest);
+    }
+  }
+
+  list.SetOutput(mResources[output].mTarget);
+}
+
+void PostProGraph::Clear()
+{
+  std::vector<RenderBuffer*>::iterator ite = mTargets.begin();
+  while (ite != mTargets.end())
+  {
+    PostProcessingManager::sRenderTargetPool->Release(*ite);
+    ++ite;
+  }
+
+  mTargets.clear();
+  mNodes.clear();
+  mResources.clear();
+  mLiveNodeCount = 0;
+  mUsesDepthPyramid = false;
+  mUsesExposure = false;
+}
+
+s32 PostProGraph::AddResource(RenderBuffer* target, RenderTargetFormat format, b8 ldr)
+{
+  Resource resource = { target, format, ldr, target != 0, false, -1 };
+  mResources.push_back(resource);
+  return mResources.size() - 1;
+}
+
+/*****************************************************************************/
+/*!
+Adds the sub effects of the effect, then the effect itself. Sub effects see
+a copy of the outer names, so their names do not leak out
+*/
+/*****************************************************************************/
+void PostProGraph::AddNodes(PostProEffect* effect, PostProResourceScope& scope)
+{
+  PostProResourceScope inner = scope;
+  inner["input"] = scope["previous"];
+
+  const std::vector<PostProEffect*>& subEffects = effect->GetSubEffects();
+  for (u32 i = 0; i < subEffects.size(); ++i)
+  {
+    AddNodes(subEffects[i], inner);
+  }
+
+  Node node;
+  node.mEffect = effect;
+  node.mSource = Resolve(inner, effect->GetSourceName());
+  //Not the source, which is an intermediate result for effects with sub effects
+  node.mBase = POSTPRO_CM_REPLACE == effect->GetCombineMode() ? -1 : scope["previous"];
+  node.mLive = false;
+
+  //Once tonemapped, results stay LDR unless something reads an HDR result again
+  b8 ldr = effect->OutputsLDR() || mResources[node.mSource].mLDR;
+  if (node.mBase != -1)
+  {
+    ldr = ldr && mResources[node.mBase].mLDR;
+  }
+
+  const std::vector<PostProEffectInput>& inputs = effect->GetInputs();
+  for (u32 i = 0; i < inputs.size(); ++i)
+  {
+    node.mInputs.push_back(Resolve(inner, inputs[i].mName));
+    ldr = ldr && (effect->OutputsLDR() || mResources[node.mInputs.back()].mLDR);
+  }
+
+  RenderTargetFormat format = ldr ? RT_FORMAT_RGBA8 : PostProEffect::GetColorFormat(effect->OutputsAlpha());
+  node.mOutput = AddResource(0, format, ldr);
+  mNodes.push_back(node);
+
+  scope["previous"] = node.mOutput;
+  if (!effect->GetOutputName().empty())
+  {
+    scope[effect->GetOutputName()] = node.mOutput;
+  }
+}
+
+s32 PostProGraph::Resolve(PostProResourceScope& scope, const std::string& name) const
+{
+  PostProResourceScope::const_iterator it = scope.find(name);
+  if (it != scope.end())
+  {
+    return it->second;
+  }
+
+  WFE_LOGGER_POPUP << "Post processing result '" << name << "' does not exist, using the previous result" << std::endl;
+  return scope["previous"];
+}
+
+/*****************************************************************************/
+/*!
+Walks back from the output. Nodes whose result is never read are not run
+*/
+/*****************************************************************************/
+void PostProGraph::FindLiveNodes(s32 output)
+{
+  mResources[output].mRead = true;
+  mResources[output].mLastUse = mNodes.size();
+
+  for (s32 i = static_cast<s32>(mNodes.size()) - 1; i >= 0; --i)
+  {
+    Node& node = mNodes[i];
+
+    if (!mResources[node.mOutput].mRead)
+    {
+      continue;
+    }
+
+    node.mLive = true;
+    ++mLiveNodeCount;
+
+    mResources[node.mSource].mRead = true;
+    mResources[node.mSource].mLastUse = std::max(mResources[node.mSource].mLastUse, i);
+
+    for (u32 j = 0; j < node.mInputs.size(); ++j)
+    {
+      Resource& input = mResources[node.mInputs[j]];
+      input.mRead = true;
+      input.mLastUse = std::max(input.mLastUse, i);
+    }
+
+    if (node.mBase != -1)
+    {
+      mResources[node.mBase].mRead = true;
+      mResources[node.mBase].mLastUse = std::max(mResources[node.mBase].mLastUse, i);
+    }
+  }
+}
+
+/*****************************************************************************/
+/*!
+Gives every live node a target. A target goes back to the free list after
+the last node reading it, so a stack needs about as many targets as it has
+results alive at the same time
+*/
+/*****************************************************************************/
+void PostProGraph::AllocateTargets(s32 width, s32 height)
+{
+  std::vector<RenderBuffer*> freeTargets[RT_FORMAT_NUM];
+
+  for (s32 i = 0; i < static_cast<s32>(mNodes.size()); ++i)
+  {
+    Node& node = mNodes[i];
+
+    if (!node.mLive)
+    {
+      continue;
+    }
+
+    //The inputs of this node are still in use, so this never aliases one of them
+    Resource& output = mResources[node.mOutput];
+    std::vector<RenderBuffer*>& freeOfFormat = freeTargets[output.mFormat];
+
+    if (freeOfFormat.empty())
+    {
+      mTargets.push_back(PostProcessingManager::sRenderTargetPool->Acquire(width, height, output.mFormat, 0));
+      freeOfFormat.push_back(mTargets.back());
+    }
+
+    output.mTarget = freeOfFormat.back();
+    freeOfFormat.pop_back();
+
+    std::vector<s32> reads = node.mInputs;
+    reads.push_back(node.mSource);
+    if (node.mBase != -1)
+    {
+      reads.push_back(node.mBase);
+    }
+
+    for (u32 j = 0; j < reads.size(); ++j)
+    {
+      Resource& read = mResources[reads[j]];
+
+      if (!read.mExternal && read.mLastUse == i)
+      {
+        freeTargets[read.mFormat].push_back(read.mTarget);
+        //Read twice by the same node, only free it once
+        read.mLastUse = -1;
+      }
+    }
+  }
+}
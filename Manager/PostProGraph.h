@@ -0,0 +1,119 @@
+/******************************************************************************/
+/*!
+\file   PostProGraph.h
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Schedules the post processing stack as a graph of named results
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+#ifndef POSTPROGRAPH_H
+#define POSTPROGRAPH_H
+
+/*****************************************************************************/
+/*!
+  Includes (Only include if required! Forward declare if you can!)
+*/
+/*****************************************************************************/
+#include "RenderTargetPool.h"
+
+/*****************************************************************************/
+/*!
+  Forward Declarations
+*/
+/*****************************************************************************/
+namespace wfe
+{
+  class RenderBuffer;
+}
+
+class PostProEffect;
+class PostProCommandList;
+
+/*****************************************************************************/
+/*!
+  Type Declarations (Types that are associated with this class declared here)
+*/
+/*****************************************************************************/
+typedef std::map<std::string, s32> PostProResourceScope;
+
+//Every effect and sub effect is a node that reads named results and writes one
+//new result. Names that always exist:
+// original - the scene before any effect
+// depth    - the depth and normal buffer
+// previous - result of the effect before, the stack's own chain
+// input    - inside an effect with sub effects, that effect's input
+// effectN  - result of the Nth effect on the stack
+//plus whatever the effects publish with SetOutputName. Results are only kept
+//alive until their last reader ran, so targets are shared between nodes.
+//Results stay in HDR formats until they only depend on tonemapped results
+class PostProGraph
+{
+public:
+  //////////////////////////////////////////////////////////////////////////
+  //Ctors
+  PostProGraph();
+  ~PostProGraph();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Member functions
+  //Schedules the effects reading from original and records them into the list
+  void Build(const std::vector<PostProEffect*>& effects, wfe::RenderBuffer* original, PostProCommandList& list);
+  //Hands all targets back to the pool
+  void Clear();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Getters (Implement simple ones here)
+  u32 GetNodeCount() const { return mNodes.size(); }
+  u32 GetLiveNodeCount() const { return mLiveNodeCount; }
+  u32 GetTargetCount() const { return mTargets.size(); }
+  //True if a live node reads the depth pyramid
+  b8 UsesDepthPyramid() const { return mUsesDepthPyramid; }
+  //True if a live node reads the automatic exposure
+  b8 UsesExposure() const { return mUsesExposure; }
+
+private:
+  //////////////////////////////////////////////////////////////////////////
+  //Private types
+  struct Resource
+  {
+    wfe::RenderBuffer* mTarget;
+    RenderTargetFormat mFormat;
+    b8 mLDR;
+    b8 mExternal; //Not owned by the graph, never reused
+    b8 mRead;
+    s32 mLastUse;
+  };
+
+  struct Node
+  {
+    PostProEffect* mEffect;
+    s32 mSource;
+    std::vector<s32> mInputs;
+    //Input of the effect, what the combine mode blends over. -1 in REPLACE
+    s32 mBase;
+    s32 mOutput;
+    b8 mLive;
+  };
+
+  //////////////////////////////////////////////////////////////////////////
+  //Private member functions (functions for internal class use only)
+  s32 AddResource(wfe::RenderBuffer* target, RenderTargetFormat format, b8 ldr);
+  void AddNodes(PostProEffect* effect, PostProResourceScope& scope);
+  s32 Resolve(PostProResourceScope& scope, const std::string& name) const;
+  void FindLiveNodes(s32 output);
+  void AllocateTargets(s32 width, s32 height);
+
+  //////////////////////////////////////////////////////////////////////////
+  //Private member data
+  std::vector<Node> mNodes;
+  std::vector<Resource> mResources;
+  std::vector<wfe::RenderBuffer*> mTargets;
+  u32 mLiveNodeCount;
+  b8 mUsesDepthPyramid;
+  b8 mUsesExposure;
+}; // class PostProGraph
+
+#endif // POSTPROGRAPH_H
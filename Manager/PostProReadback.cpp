@@ -0,0 +1,150 @@
+/******************************************************************************/
+/*!
+\file   PostProReadback.cpp
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Ring of pixel buffer objects for reading targets back without stalling. A
+read is started now and picked up a few frames later, once its fence says
+the copy is done
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+
+/*****************************************************************************/
+/*!
+Includes
+*/
+/*****************************************************************************/
+#include "Precompiled.h" //Precompiled header
+#include "RenderBuffer.h"
+
+#include "PostProReadback.h" //Own header
+
+/*****************************************************************************/
+/*!
+Use the engine namespace, for convenience
+*/
+/*****************************************************************************/
+using namespace wfe;
+
+PostProReadback::PostProReadback() : mOldest(0), mPending(0)
+{
+  for (u32 i = 0; i < sRingSize; ++i)
+  {
+    Slot slot = { 0, 0, 0, 0, 0, 0 };
+    mSlots[i] = slot;
+  }
+}
+
+PostProReadback::~PostProReadback()
+{
+  Clear();
+}
+
+/*****************************************************************************/
+/*!
+glReadPixels into a bound pack buffer only queues the copy, the call returns
+right away. The fence tells us later when the data has arrived
+*/
+/*****************************************************************************/
+b8 PostProReadback::Read(RenderBuffer* source, s32 width, s32 height, GLenum format, GLenum type, u32 bytesPerPixel, u32 tag)
+{
+  if (mPending == sRingSize)
+  {
+    return false;
+  }
+
+  Slot& slot = mSlots[(mOldest + mPending) % sRingSize];
+  u32 size = width * height * bytesPerPixel;
+
+  if (!slot.mBuffer)
+  {
+    glGenBuffers(1, &slot.mBuffer);
+  }
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.mBuffer);
+  if (slot.mSize != size)
+  {
+    glBufferData(GL_PIXEL_PACK_BUFFER, size, 0, GL_STREAM_READ);
+    slot.mSize = size;
+  }
+
+  GLint sourceFramebuffer = 0;
+  source->Bind();
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &sourceFramebuffer);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, sourceFramebuffer);
+
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, width, height, format, type, 0);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  slot.mFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  slot.mWidth = width;
+  slot.mHeight = height;
+  slot.mTag = tag;
+  ++mPending;
+
+  return true;
+}
+
+b8 PostProReadback::Poll(std::vector<u8>& pixels, s32& width, s32& height, u32& tag)
+{
+  if (!mPending)
+  {
+    return false;
+  }
+
+  //Reads finish in the order they were started, so only the oldest is worth checking
+  Slot& slot = mSlots[mOldest];
+  GLenum status = glClientWaitSync(slot.mFence, 0, 0);
+  if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+  {
+    return false;
+  }
+
+  glDeleteSync(slot.mFence);
+  slot.mFence = 0;
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.mBuffer);
+  const u8* mapped = static_cast<const u8*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, slot.mSize, GL_MAP_READ_BIT));
+  if (mapped)
+  {
+    pixels.assign(mapped, mapped + slot.mSize);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  width = slot.mWidth;
+  height = slot.mHeight;
+  tag = slot.mTag;
+
+  mOldest = (mOldest + 1) % sRingSize;
+  --mPending;
+
+  return mapped != 0;
+}
+
+void PostProReadback::Clear()
+{
+  for (u32 i = 0; i < sRingSize; ++i)
+  {
+    Slot& slot = mSlots[i];
+
+    if (slot.mFence)
+    {
+      glDeleteSync(slot.mFence);
+    }
+    if (slot.mBuffer)
+    {
+      glDeleteBuffers(1, &slot.mBuffer);
+    }
+
+    Slot empty = { 0, 0, 0, 0, 0, 0 };
+    slot = empty;
+  }
+
+  mOldest = 0;
+  mPending = 0;
+}
@@ -0,0 +1,75 @@
+/******************************************************************************/
+/*!
+\file   PostProReadback.h
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Ring of pixel buffer objects for reading targets back without stalling. A
+read is started now and picked up a few frames later, once its fence says
+the copy is done
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+#ifndef POSTPROREADBACK_H
+#define POSTPROREADBACK_H
+
+/*****************************************************************************/
+/*!
+  Forward Declarations
+*/
+/*****************************************************************************/
+namespace wfe
+{
+  class RenderBuffer;
+}
+
+class PostProReadback
+{
+public:
+  //////////////////////////////////////////////////////////////////////////
+  //Ctors
+  PostProReadback();
+  ~PostProReadback();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Member functions
+
+  //Starts copying the lower left width x height pixels of source into a free
+  //buffer. Returns false when every buffer is still in flight
+  b8 Read(wfe::RenderBuffer* source, s32 width, s32 height, GLenum format, GLenum type, u32 bytesPerPixel, u32 tag);
+  //Copies out the oldest read if the GPU is done with it. Never waits, call
+  //until it returns false to pick up everything that finished
+  b8 Poll(std::vector<u8>& pixels, s32& width, s32& height, u32& tag);
+  //Drops reads that were never picked up and frees the buffers
+  void Clear();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Getters (Implement simple ones here)
+  u32 GetPendingCount() const { return mPending; }
+
+  //////////////////////////////////////////////////////////////////////////
+  //Reads in flight at most. Enough to cover the frames the driver queues up
+  static const u32 sRingSize = 4;
+
+private:
+  //////////////////////////////////////////////////////////////////////////
+  //Private types
+  struct Slot
+  {
+    GLuint mBuffer;
+    u32 mSize;
+    GLsync mFence;
+    s32 mWidth;
+    s32 mHeight;
+    u32 mTag;
+  };
+
+  //////////////////////////////////////////////////////////////////////////
+  //Private member data
+  Slot mSlots[sRingSize];
+  u32 mOldest;
+  u32 mPending;
+}; // class PostProReadback
+
+#endif // POSTPROREADBACK_H
@@ -0,0 +1,614 @@
+/******************************************************************************/
+/*!
+\file   PostProShaderLibrary.cpp
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Compiles specialized variants of the post processing shaders, with effect
+options turned into #defines, and keeps their linked binaries on disk
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+
+/*****************************************************************************/
+/*!
+Includes
+*/
+/*****************************************************************************/
+#include "Precompiled.h" //Precompiled header
+#include "GraphicsManager.h"
+#include "ShaderManager.h"
+
+#include "PostProShaderLibrary.h" //Own header
+
+#include <fstream>
+
+/*****************************************************************************/
+/*!
+Use the engine namespace, for convenience
+*/
+/*****************************************************************************/
+using namespace wfe;
+
+//Sampler names Shader::EnableTexture knows, by the unit it binds them to
+struct PostProSamplerUnit
+{
+  cstr mName;
+  s32 mMapType;
+};
+
+static const PostProSamplerUnit sSamplerUnits[] =
+{
+  { "uColorMap", Shader::WFE_SHADER_MAPTYPE_COLOR },
+  { "uShadowMap", Shader::WFE_SHADER_MAPTYPE_SHADOW },
+  { "uOriginalMap", Shader::WFE_SHADER_MAPTYPE_ORIGINAL },
+  { "uPass0", Shader::WFE_SHADER_MAPTYPE_BLOOMZERO },
+  { "uPass1", Shader::WFE_SHADER_MAPTYPE_BLOOMONE },
+  { "uPass2", Shader::WFE_SHADER_MAPTYPE_BLOOMTWO },
+  { "uPass3", Shader::WFE_SHADER_MAPTYPE_BLOOMTHREE }
+};
+
+//Start of the cache file, the version goes up when its layout changes
+static const u32 sCacheMagic = 0x50505342; //PPSB
+static const u32 sCacheVersion = 1;
+
+//64 bit FNV-1a, continued from hash
+static u64 HashBytes(u64 hash, const void* data, u32 size)
+{
+  const u8* bytes = static_cast<const u8*>(data);
+  for (u32 i = 0; i < size; ++i)
+  {
+    hash ^= bytes[i];
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
+}
+
+static u64 HashString(u64 hash, const std::string& text)
+{
+  //The size goes in as well, so "ab" + "c" and "a" + "bc" differ
+  u32 size = text.size();
+  hash = HashBytes(hash, &size, sizeof(size));
+  return HashBytes(hash, text.data(), size);
+}
+
+static const u64 sHashSeed = 0xCBF29CE484222325ull;
+
+static void WriteU32(std::ofstream& file, u32 value)
+{
+  file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void WriteU64(std::ofstream& file, u64 value)
+{
+  file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static b8 ReadU32(std::ifstream& file, u32& value)
+{
+  return !!file.read(reinterpret_cast<char*>(&value), sizeof(value));
+}
+
+static b8 ReadU64(std::ifstream& file, u64& value)
+{
+  return !!file.read(reinterpret_cast<char*>(&value), sizeof(value));
+}
+
+PostProShaderLibrary::PostProShaderLibrary() : mShaderDirectory("Shaders/"), mCacheFile("PostProShaders.cache"), mDriverHash(0), mCacheLoaded(false), mCacheDirty(false), mCacheHits(0)
+{
+}
+
+PostProShaderLibrary::~PostProShaderLibrary()
+{
+  Clear();
+  SaveCache();
+}
+
+GLuint PostProShaderLibrary::GetVariant(Shader* base, const std::string& fragmentFile, const PostProShaderDefines& defines)
+{
+  if (!base)
+  {
+    return 0;
+  }
+
+  std::string key = Request(base, fragmentFile, defines);
+
+  //Requested earlier and not picked up yet, this waits for the link
+  std::map<std::string, PendingProgram>::iterator pending = mPending.find(key);
+  if (pending != mPending.end())
+  {
+    mPrograms[key] = Finish(pending->second);
+    mPending.erase(pending);
+  }
+
+  return mPrograms[key];
+}
+
+void PostProShaderLibrary::RequestVariant(Shader* base, const std::string& fragmentFile, const PostProShaderDefines& defines)
+{
+  if (base)
+  {
+    Request(base, fragmentFile, defines);
+  }
+}
+
+b8 PostProShaderLibrary::IsVariantReady(Shader* base, const std::string& fragmentFile, const PostProShaderDefines& defines) const
+{
+  if (!base)
+  {
+    return true;
+  }
+
+  std::map<std::string, PendingProgram>::const_iterator pending = mPending.find(GetKey(base, fragmentFile, GetHeader(defines)));
+  if (pending == mPending.end())
+  {
+    return true;
+  }
+
+#ifdef GL_KHR_parallel_shader_compile
+  //Without the extension the link is synchronous and the program is always ready
+  if (glMaxShaderCompilerThreadsKHR)
+  {
+    GLint completed = GL_TRUE;
+    glGetProgramiv(pending->second.mProgram, GL_COMPLETION_STATUS_KHR, &completed);
+    return completed == GL_TRUE;
+  }
+#endif
+
+  return true;
+}
+
+void PostProShaderLibrary::Clear()
+{
+  std::map<std::string, GLuint>::iterator ite = mPrograms.begin();
+  while (ite != mPrograms.end())
+  {
+    if (ite->second)
+    {
+      glDeleteProgram(ite->second);
+    }
+    ++ite;
+  }
+
+  mPrograms.clear();
+
+  std::map<std::string, PendingProgram>::iterator pending = mPending.begin();
+  while (pending != mPending.end())
+  {
+    glDeleteShader(pending->second.mFragmentShader);
+    glDeleteProgram(pending->second.mProgram);
+    ++pending;
+  }
+
+  mPending.clear();
+}
+
+std::string PostProShaderLibrary::GetHeader(const PostProShaderDefines& defines)
+{
+  std::stringstream header;
+  header << "#define SPECIALIZED 1\n";
+
+  PostProShaderDefines::const_iterator ite = defines.begin();
+  while (ite != defines.end())
+  {
+    header << "#define " << ite->first << " " << ite->second << "\n";
+    ++ite;
+  }
+
+  return header.str();
+}
+
+std::string PostProShaderLibrary::GetKey(Shader* base, const std::string& fragmentFile, const std::string& header)
+{
+  std::stringstream key;
+  key << base->GetHandle() << ":" << fragmentFile << ":" << header;
+  return key.str();
+}
+
+/*****************************************************************************/
+/*!
+Starts the variant unless it was already requested. A program loaded from the
+cache is done right away, a compiled one waits in mPending for Finish
+*/
+/*****************************************************************************/
+std::string PostProShaderLibrary::Request(Shader* base, const std::string& fragmentFile, const PostProShaderDefines& defines)
+{
+  std::string header = GetHeader(defines);
+  std::string key = GetKey(base, fragmentFile, header);
+
+  if (mPrograms.find(key) != mPrograms.end() || mPending.find(key) != mPending.end())
+  {
+    return key;
+  }
+
+  PendingProgram pending;
+  pending.mFragmentFile = fragmentFile;
+  pending.mHeader = header;
+
+  if (!Compile(base, pending))
+  {
+    mPrograms[key] = 0;
+  }
+  else if (pending.mFragmentShader)
+  {
+    mPending[key] = pending;
+  }
+  else
+  {
+    SetSamplers(pending.mProgram);
+    mPrograms[key] = pending.mProgram;
+  }
+
+  return key;
+}
+
+/*****************************************************************************/
+/*!
+The whole file is written again. Entries are only ever added while running,
+so it is only written when one was
+*/
+/*****************************************************************************/
+void PostProShaderLibrary::SaveCache()
+{
+  if (!mCacheDirty || mCacheFile.empty())
+  {
+    return;
+  }
+
+  std::ofstream file(mCacheFile.c_str(), std::ios::binary);
+  if (!file)
+  {
+    WFE_LOGGER_POPUP << "Post processing shader cache '" << mCacheFile << "' can't be written" << std::endl;
+    return;
+  }
+
+  WriteU32(file, sCacheMagic);
+  WriteU32(file, sCacheVersion);
+  WriteU64(file, mDriverHash);
+  WriteU32(file, mBinaries.size());
+
+  std::map<u64, ProgramBinary>::const_iterator ite = mBinaries.begin();
+  while (ite != mBinaries.end())
+  {
+    const std::vector<u8>& data = ite->second.mData;
+
+    WriteU64(file, ite->first);
+    WriteU32(file, ite->second.mFormat);
+    WriteU32(file, data.size());
+    WriteU64(file, HashBytes(sHashSeed, &data[0], data.size()));
+    file.write(reinterpret_cast<const char*>(&data[0]), data.size());
+    ++ite;
+  }
+
+  mCacheDirty = false;
+}
+
+void PostProShaderLibrary::SetCacheFile(const std::string& path)
+{
+  SaveCache();
+
+  mCacheFile = path;
+  mBinaries.clear();
+  mCacheLoaded = false;
+}
+
+/*****************************************************************************/
+/*!
+Binaries only load into the driver that wrote them, a file written by another
+one is dropped as a whole. Reading stops at the first entry that is cut off or
+does not match its checksum, the entries before it are still used
+*/
+/*****************************************************************************/
+void PostProShaderLibrary::LoadCache()
+{
+  mCacheLoaded = true;
+
+  //No binary formats, nothing can be cached
+  GLint formatCount = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+  if (formatCount <= 0)
+  {
+    mCacheFile.clear();
+    return;
+  }
+
+  mDriverHash = sHashSeed;
+  mDriverHash = HashString(mDriverHash, reinterpret_cast<cstr>(glGetString(GL_VENDOR)));
+  mDriverHash = HashString(mDriverHash, reinterpret_cast<cstr>(glGetString(GL_RENDERER)));
+  mDriverHash = HashString(mDriverHash, reinterpret_cast<cstr>(glGetString(GL_VERSION)));
+
+  if (mCacheFile.empty())
+  {
+    return;
+  }
+
+  std::ifstream file(mCacheFile.c_str(), std::ios::binary);
+  if (!file)
+  {
+    return;
+  }
+
+  u32 magic = 0;
+  u32 version = 0;
+  u64 driverHash = 0;
+  u32 count = 0;
+  if (!ReadU32(file, magic) || !ReadU32(file, version) || !ReadU64(file, driverHash) || !ReadU32(file, count) ||
+    magic != sCacheMagic || version != sCacheVersion || driverHash != mDriverHash)
+  {
+    //Rewritten with this driver's binaries
+    mCacheDirty = true;
+    return;
+  }
+
+  for (u32 i = 0; i < count; ++i)
+  {
+    u64 key = 0;
+    u32 format = 0;
+    u32 size = 0;
+    u64 checksum = 0;
+    if (!ReadU64(file, key) || !ReadU32(file, format) || !ReadU32(file, size) || !ReadU64(file, checksum) || !size)
+    {
+      mCacheDirty = true;
+      return;
+    }
+
+    ProgramBinary& binary = mBinaries[key];
+    binary.mFormat = format;
+    binary.mData.resize(size);
+    if (!file.read(reinterpret_cast<char*>(&binary.mData[0]), size) || HashBytes(sHashSeed, &binary.mData[0], size) != checksum)
+    {
+      WFE_LOGGER_POPUP << "Post processing shader cache '" << mCacheFile << "' is corrupt, its programs are compiled again" << std::endl;
+      mBinaries.erase(key);
+      mCacheDirty = true;
+      return;
+    }
+  }
+}
+
+/*****************************************************************************/
+/*!
+A binary the driver refuses leaves the program unlinked. The entry is dropped
+and the caller compiles the program, which writes a new one
+*/
+/*****************************************************************************/
+GLuint PostProShaderLibrary::LoadBinary(u64 key)
+{
+  std::map<u64, ProgramBinary>::iterator found = mBinaries.find(key);
+  if (found == mBinaries.end())
+  {
+    return 0;
+  }
+
+  GLuint program = glCreateProgram();
+  glProgramBinary(program, found->second.mFormat, &found->second.mData[0], found->second.mData.size());
+
+  GLint linked = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  if (!linked)
+  {
+    glDeleteProgram(program);
+    mBinaries.erase(found);
+    mCacheDirty = true;
+    return 0;
+  }
+
+  ++mCacheHits;
+  return program;
+}
+
+void PostProShaderLibrary::StoreBinary(u64 key, GLuint program)
+{
+  if (mCacheFile.empty())
+  {
+    return;
+  }
+
+  GLint size = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size);
+  if (size <= 0)
+  {
+    return;
+  }
+
+  ProgramBinary& binary = mBinaries[key];
+  binary.mData.resize(size);
+
+  GLenum format = 0;
+  glGetProgramBinary(program, size, 0, &format, &binary.mData[0]);
+  binary.mFormat = format;
+
+  mCacheDirty = true;
+}
+
+/*****************************************************************************/
+/*!
+The defines go after a #version line, everything else in the file is left as
+it is. #line puts the line numbers of compile errors back on the file's lines.
+The binary cache is keyed by everything that goes into the program: both
+sources, which include the defines, and the attribute locations
+*/
+/*****************************************************************************/
+b8 PostProShaderLibrary::Compile(Shader* base, PendingProgram& pending)
+{
+  const std::string& fragmentFile = pending.mFragmentFile;
+
+  if (!mCacheLoaded)
+  {
+    LoadCache();
+  }
+
+  std::ifstream file((mShaderDirectory + fragmentFile).c_str());
+  if (!file)
+  {
+    WFE_LOGGER_POPUP << "Post processing shader '" << fragmentFile << "' can't be read for its variants" << std::endl;
+    return false;
+  }
+
+  std::stringstream sourceStream;
+  sourceStream << file.rdbuf();
+  std::string source = sourceStream.str();
+
+  std::string version;
+  if (source.compare(0, 8, "#version") == 0)
+  {
+    std::string::size_type lineEnd = source.find('\n');
+    version = source.substr(0, lineEnd + 1);
+    source = lineEnd == std::string::npos ? std::string() : source.substr(lineEnd + 1);
+  }
+
+  std::string fullSource = version + pending.mHeader + (version.empty() ? "#line 1\n" : "#line 2\n") + source;
+
+  //Borrow the vertex shader the engine linked into the base program
+  GLuint baseProgram = base->GetHandle();
+  GLuint vertexShader = 0;
+  GLuint attached[4];
+  GLsizei attachedCount = 0;
+  glGetAttachedShaders(baseProgram, 4, &attachedCount, attached);
+
+  for (GLsizei i = 0; i < attachedCount; ++i)
+  {
+    GLint type = 0;
+    glGetShaderiv(attached[i], GL_SHADER_TYPE, &type);
+    if (GL_VERTEX_SHADER == type)
+    {
+      vertexShader = attached[i];
+    }
+  }
+
+  //The engine sets the attributes up by the base program's locations
+  std::vector<std::pair<std::string, GLint> > attributes;
+  GLint attributeCount = 0;
+  glGetProgramiv(baseProgram, GL_ACTIVE_ATTRIBUTES, &attributeCount);
+  for (GLint i = 0; i < attributeCount; ++i)
+  {
+    GLchar name[128];
+    GLint size = 0;
+    GLenum type = 0;
+    glGetActiveAttrib(baseProgram, i, sizeof(name), 0, &size, &type, name);
+
+    //Built in attributes have no location
+    GLint location = glGetAttribLocation(baseProgram, name);
+    if (location >= 0)
+    {
+      attributes.push_back(std::make_pair(std::string(name), location));
+    }
+  }
+
+  u64 key = HashString(sHashSeed, fullSource);
+  if (vertexShader)
+  {
+    GLint vertexSourceLength = 0;
+    glGetShaderiv(vertexShader, GL_SHADER_SOURCE_LENGTH, &vertexSourceLength);
+    if (vertexSourceLength > 0)
+    {
+      std::vector<GLchar> vertexSource(vertexSourceLength);
+      glGetShaderSource(vertexShader, vertexSourceLength, 0, &vertexSource[0]);
+      key = HashString(key, &vertexSource[0]);
+    }
+  }
+  for (u32 i = 0; i < attributes.size(); ++i)
+  {
+    key = HashString(key, attributes[i].first);
+    key = HashBytes(key, &attributes[i].second, sizeof(attributes[i].second));
+  }
+
+  pending.mKey = key;
+  pending.mFragmentShader = 0;
+  pending.mProgram = LoadBinary(key);
+  if (pending.mProgram)
+  {
+    return true;
+  }
+
+  cstr fullSourcePtr = fullSource.c_str();
+
+  pending.mFragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+  glShaderSource(pending.mFragmentShader, 1, &fullSourcePtr, 0);
+  glCompileShader(pending.mFragmentShader);
+
+  pending.mProgram = glCreateProgram();
+  if (vertexShader)
+  {
+    glAttachShader(pending.mProgram, vertexShader);
+  }
+  glAttachShader(pending.mProgram, pending.mFragmentShader);
+
+  for (u32 i = 0; i < attributes.size(); ++i)
+  {
+    glBindAttribLocation(pending.mProgram, attributes[i].second, attributes[i].first.c_str());
+  }
+
+  //Has to be set before linking for glGetProgramBinary to work
+  if (!mCacheFile.empty())
+  {
+    glProgramParameteri(pending.mProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  }
+
+  //No status is asked for here, with parallel shader compile the driver
+  //compiles and links in the background until Finish
+  glLinkProgram(pending.mProgram);
+  return true;
+}
+
+/*****************************************************************************/
+/*!
+Waits for the link of a requested variant and checks it. The compile log is
+only there as long as the fragment shader is, so it is kept until now
+*/
+/*****************************************************************************/
+GLuint PostProShaderLibrary::Finish(PendingProgram& pending)
+{
+  GLuint program = pending.mProgram;
+
+  GLint compiled = GL_FALSE;
+  glGetShaderiv(pending.mFragmentShader, GL_COMPILE_STATUS, &compiled);
+  if (!compiled)
+  {
+    GLchar log[1024];
+    glGetShaderInfoLog(pending.mFragmentShader, sizeof(log), 0, log);
+    WFE_LOGGER_POPUP << "Variant of '" << pending.mFragmentFile << "' failed to compile:\n" << pending.mHeader << log << std::endl;
+  }
+
+  glDetachShader(program, pending.mFragmentShader);
+  glDeleteShader(pending.mFragmentShader);
+  pending.mFragmentShader = 0;
+
+  GLint linked = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  if (!linked)
+  {
+    if (compiled)
+    {
+      GLchar log[1024];
+      glGetProgramInfoLog(program, sizeof(log), 0, log);
+      WFE_LOGGER_POPUP << "Variant of '" << pending.mFragmentFile << "' failed to link:\n" << pending.mHeader << log << std::endl;
+    }
+    glDeleteProgram(program);
+    return 0;
+  }
+
+  StoreBinary(pending.mKey, program);
+  SetSamplers(program);
+  return program;
+}
+
+/*****************************************************************************/
+/*!
+Sampler values belong to the program and are not part of its binary, they
+are set once when it is done
+*/
+/*****************************************************************************/
+void PostProShaderLibrary::SetSamplers(GLuint program)
+{
+  GLint previousProgram = 0;
+  glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+  glUseProgram(program);
+
+  for (u32 i = 0; i < sizeof(sSamplerUnits) / sizeof(sSamplerUnits[0]); ++i)
+  {
+    glUniform1i(glGetUniformLocation(program, sSamplerUnits[i].mName), sSamplerUnits[i].mMapType);
+  }
+
+  glUseProgram(previousProgram);
+}
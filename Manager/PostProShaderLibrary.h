@@ -0,0 +1,132 @@
+/******************************************************************************/
+/*!
+\file   PostProShaderLibrary.h
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Compiles specialized variants of the post processing shaders, with effect
+options turned into #defines, and keeps their linked binaries on disk
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+#ifndef POSTPROSHADERLIBRARY_H
+#define POSTPROSHADERLIBRARY_H
+
+/*****************************************************************************/
+/*!
+  Forward Declarations
+*/
+/*****************************************************************************/
+namespace wfe
+{
+  class Shader;
+}
+
+/*****************************************************************************/
+/*!
+  Type Declarations (Types that are associated with this class declared here)
+*/
+/*****************************************************************************/
+//Name and value of every #define of a variant
+typedef std::map<std::string, s32> PostProShaderDefines;
+
+//A variant is the fragment shader of an effect compiled again with SPECIALIZED
+//and the given defines put in front of it. It is linked with the vertex shader
+//of the engine's program and gets the same attribute locations, so it draws
+//with everything the engine set up for that program. Samplers point at the unit
+//of their map type, the way Shader::EnableTexture binds them.
+//Shaders support both: without SPECIALIZED they read the options from uniforms.
+//Linked variants are saved with glGetProgramBinary into the cache file and
+//loaded from it on later runs instead of being compiled. Entries are keyed by a
+//hash of the sources with their defines, the file by the driver that wrote it.
+//Anything that does not load is compiled again.
+class PostProShaderLibrary
+{
+public:
+  //////////////////////////////////////////////////////////////////////////
+  //Ctors
+  PostProShaderLibrary();
+  ~PostProShaderLibrary();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Member functions
+  //Program for the defines, compiled the first time it is asked for. Returns 0
+  //if it does not compile, the caller draws with the base program then. Waits
+  //for the link of a requested variant that is not done yet
+  GLuint GetVariant(wfe::Shader* base, const std::string& fragmentFile, const PostProShaderDefines& defines);
+  //Starts compiling the variant without waiting for it, so that GetVariant
+  //finds it done later on
+  void RequestVariant(wfe::Shader* base, const std::string& fragmentFile, const PostProShaderDefines& defines);
+  //False while a requested variant still links in the background
+  b8 IsVariantReady(wfe::Shader* base, const std::string& fragmentFile, const PostProShaderDefines& defines) const;
+  //Deletes every variant
+  void Clear();
+  //Writes the binaries to the cache file if new ones were added. Done on
+  //destruction as well
+  void SaveCache();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Getters (Implement simple ones here)
+  u32 GetVariantCount() const { return mPrograms.size(); }
+  const std::string& GetShaderDirectory() const { return mShaderDirectory; }
+  const std::string& GetCacheFile() const { return mCacheFile; }
+  //Variants loaded from the cache instead of being compiled
+  u32 GetCacheHitCount() const { return mCacheHits; }
+
+  //////////////////////////////////////////////////////////////////////////
+  //Setters (Implement simple ones here)
+  //Where the fragment shader files are read from
+  void SetShaderDirectory(const std::string& directory) { mShaderDirectory = directory; }
+  //Empty turns the cache off. The directory has to exist
+  void SetCacheFile(const std::string& path);
+
+private:
+  //////////////////////////////////////////////////////////////////////////
+  //Private types
+  struct ProgramBinary
+  {
+    GLenum mFormat;
+    std::vector<u8> mData;
+  };
+
+  //Variant whose link was started but not checked yet
+  struct PendingProgram
+  {
+    GLuint mProgram;
+    GLuint mFragmentShader; //Kept for the compile log, 0 if loaded from the cache
+    u64 mKey; //Of its binary
+    std::string mFragmentFile;
+    std::string mHeader;
+  };
+
+  //////////////////////////////////////////////////////////////////////////
+  //Private member functions (functions for internal class use only)
+  static std::string GetHeader(const PostProShaderDefines& defines);
+  static std::string GetKey(wfe::Shader* base, const std::string& fragmentFile, const std::string& header);
+  std::string Request(wfe::Shader* base, const std::string& fragmentFile, const PostProShaderDefines& defines);
+  b8 Compile(wfe::Shader* base, PendingProgram& pending);
+  GLuint Finish(PendingProgram& pending);
+  void SetSamplers(GLuint program);
+  void LoadCache();
+  GLuint LoadBinary(u64 key);
+  void StoreBinary(u64 key, GLuint program);
+
+  //////////////////////////////////////////////////////////////////////////
+  //Private member data
+  //By base program, fragment file and defines. Failed variants are kept as 0
+  std::map<std::string, GLuint> mPrograms;
+  //Same keys, requested and still linking
+  std::map<std::string, PendingProgram> mPending;
+  std::string mShaderDirectory;
+
+  //By the hash of everything that went into the program
+  std::map<u64, ProgramBinary> mBinaries;
+  std::string mCacheFile;
+  u64 mDriverHash;
+  b8 mCacheLoaded;
+  b8 mCacheDirty;
+  u32 mCacheHits;
+}; // class PostProShaderLibrary
+
+#endif // POSTPROSHADERLIBRARY_H
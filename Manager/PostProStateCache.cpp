@@ -0,0 +1,239 @@
+/******************************************************************************/
+/*!
+\file   PostProStateCache.cpp
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Remembers the GL state set by the post processing stack and skips calls
+that would not change anything
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+
+/*****************************************************************************/
+/*!
+Includes
+*/
+/*****************************************************************************/
+#include "Precompiled.h" //Precompiled header
+#include "RenderBuffer.h"
+#include "GraphicsManager.h"
+#include "ShaderManager.h"
+#include "PostProEffect.h"
+
+#include "PostProStateCache.h" //Own header
+
+/*****************************************************************************/
+/*!
+Use the engine namespace, for convenience
+*/
+/*****************************************************************************/
+using namespace wfe;
+
+typedef decltype(Shader::WFE_SHADER_MAPTYPE_COLOR) ShaderMapType;
+
+static const s32 sUnknownCombineMode = -1;
+
+PostProStateCache::PostProStateCache() : mShader(0), mProgram(0), mTarget(0), mPendingClear(0), mCombineMode(sUnknownCombineMode), mBlendWasEnabled(true)
+{
+  memset(&mCounters, 0, sizeof(mCounters));
+  Invalidate();
+}
+
+void PostProStateCache::BeginFrame()
+{
+  memset(&mCounters, 0, sizeof(mCounters));
+  Invalidate();
+
+  mBlendWasEnabled = glIsEnabled(GL_BLEND) == GL_TRUE;
+}
+
+void PostProStateCache::EndFrame()
+{
+  FlushClear();
+
+  //Hand blending back the way the engine left it
+  if (mBlendWasEnabled)
+  {
+    glEnable(GL_BLEND);
+  }
+  else
+  {
+    glDisable(GL_BLEND);
+  }
+
+  Invalidate();
+}
+
+void PostProStateCache::Invalidate()
+{
+  FlushClear();
+
+  mShader = 0;
+  mProgram = 0;
+  mTarget = 0;
+  mPendingClear = 0;
+  mCombineMode = sUnknownCombineMode;
+
+  InvalidateTextures();
+}
+
+void PostProStateCache::InvalidateTextures()
+{
+  for (u32 i = 0; i < sMaxMapTypes; ++i)
+  {
+    mUnitTextures[i] = 0;
+  }
+  mProgramSamplers.clear();
+}
+
+void PostProStateCache::SwitchShader(Shader* shader, GLuint program)
+{
+  if (!program && shader)
+  {
+    program = shader->GetHandle();
+  }
+
+  if (shader == mShader && program == mProgram)
+  {
+    ++mCounters.mShaderSwitchesSkipped;
+    return;
+  }
+
+  if (shader != mShader)
+  {
+    WFE_GRAPHICS->SwitchShader(shader);
+    mShader = shader;
+    mProgram = shader ? shader->GetHandle() : 0;
+  }
+
+  //Variants keep everything the engine set up for the shader and only swap the program
+  if (program != mProgram)
+  {
+    glUseProgram(program);
+    mProgram = program;
+  }
+
+  ++mCounters.mShaderSwitches;
+}
+
+void PostProStateCache::EnableTexture(GLuint handle, s32 mapType)
+{
+  ASSERT(mShader);
+  ASSERT(mapType >= 0 && static_cast<u32>(mapType) < sMaxMapTypes);
+
+  u32 mapBit = 1 << mapType;
+  GLuint program = mProgram;
+
+  std::vector<std::pair<GLuint, u32> >::iterator ite = mProgramSamplers.begin();
+  while (ite != mProgramSamplers.end() && ite->first != program)
+  {
+    ++ite;
+  }
+
+  if (ite != mProgramSamplers.end() && (ite->second & mapBit) && mUnitTextures[mapType] == handle)
+  {
+    ++mCounters.mTextureBindsSkipped;
+    return;
+  }
+
+  if (program == mShader->GetHandle())
+  {
+    mShader->EnableTexture(handle, static_cast<ShaderMapType>(mapType));
+  }
+  else
+  {
+    //The sampler locations the shader knows are those of its own program. The
+    //samplers of a variant already point at their units
+    glActiveTexture(GL_TEXTURE0 + mapType);
+    glBindTexture(GL_TEXTURE_2D, handle);
+  }
+  mUnitTextures[mapType] = handle;
+  ++mCounters.mTextureBinds;
+
+  if (ite == mProgramSamplers.end())
+  {
+    mProgramSamplers.push_back(std::make_pair(program, mapBit));
+  }
+  else
+  {
+    ite->second |= mapBit;
+  }
+}
+
+void PostProStateCache::SetCombineBlending(s32 mode)
+{
+  if (mode == mCombineMode)
+  {
+    ++mCounters.mBlendChangesSkipped;
+    return;
+  }
+
+  if (POSTPRO_CM_REPLACE == mode)
+  {
+    glDisable(GL_BLEND);
+  }
+  else
+  {
+    glEnable(GL_BLEND);
+    PostProEffect::SwitchBlending(static_cast<PostProcessingCombineModes>(mode));
+  }
+
+  mCombineMode = mode;
+  ++mCounters.mBlendChanges;
+}
+
+void PostProStateCache::BindTarget(RenderBuffer* target)
+{
+  if (target == mTarget)
+  {
+    ++mCounters.mTargetBindsSkipped;
+    return;
+  }
+
+  //A clear that was held back still has to happen on the old target
+  FlushClear();
+
+  target->Bind();
+  glViewport(0, 0, PostProEffect::GetRenderWidth(), PostProEffect::GetRenderHeight());
+  mTarget = target;
+  ++mCounters.mTargetBinds;
+}
+
+void PostProStateCache::ClearTarget(RenderBuffer* target)
+{
+  BindTarget(target);
+  mPendingClear = target;
+}
+
+void PostProStateCache::DrawOverScreen()
+{
+  //Without blending the quad overwrites every pixel of the render rect, so the clear is pointless
+  if (mPendingClear)
+  {
+    if (POSTPRO_CM_REPLACE == mCombineMode)
+    {
+      mPendingClear = 0;
+      ++mCounters.mClearsSkipped;
+    }
+    else
+    {
+      FlushClear();
+    }
+  }
+
+  WFE_GRAPHICS->DrawOverScreen();
+  ++mCounters.mDraws;
+}
+
+void PostProStateCache::FlushClear()
+{
+  if (mPendingClear)
+  {
+    //The pending clear always belongs to the bound target
+    mPendingClear->Clear();
+    mPendingClear = 0;
+    ++mCounters.mClears;
+  }
+}
@@ -0,0 +1,108 @@
+/******************************************************************************/
+/*!
+\file   PostProStateCache.h
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Remembers the GL state set by the post processing stack and skips calls
+that would not change anything
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+#ifndef POSTPROSTATECACHE_H
+#define POSTPROSTATECACHE_H
+
+/*****************************************************************************/
+/*!
+  Forward Declarations
+*/
+/*****************************************************************************/
+namespace wfe
+{
+  class RenderBuffer;
+  class Shader;
+}
+
+/*****************************************************************************/
+/*!
+  Type Declarations (Types that are associated with this class declared here)
+*/
+/*****************************************************************************/
+struct PostProStateCounters
+{
+  u32 mShaderSwitches;
+  u32 mShaderSwitchesSkipped;
+  u32 mTextureBinds;
+  u32 mTextureBindsSkipped;
+  u32 mBlendChanges;
+  u32 mBlendChangesSkipped;
+  u32 mTargetBinds;
+  u32 mTargetBindsSkipped;
+  u32 mClears;
+  u32 mClearsSkipped;
+  u32 mDraws;
+};
+
+//Anything that changes GL state behind the cache's back (engine calls, effects
+//that bind directly) must be followed by Invalidate.
+//Textures are tracked per map type, assuming Shader::EnableTexture binds map type N
+//to texture unit N and points the sampler of that map type at it
+class PostProStateCache
+{
+public:
+  //////////////////////////////////////////////////////////////////////////
+  //Ctors
+  PostProStateCache();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Member functions
+  void BeginFrame();
+  void EndFrame();
+
+  //Forget everything, the next call of every kind goes to GL
+  void Invalidate();
+  //For code that enabled textures through the shader directly
+  void InvalidateTextures();
+
+  //program is a variant of shader from PostProShaderLibrary, 0 uses the shader's own program
+  void SwitchShader(wfe::Shader* shader, GLuint program = 0);
+  void EnableTexture(GLuint handle, s32 mapType);
+  //mode is a PostProcessingCombineModes. REPLACE turns blending off so a full
+  //screen draw overwrites every pixel
+  void SetCombineBlending(s32 mode);
+  void BindTarget(wfe::RenderBuffer* target);
+
+  //The clear is held back until we know whether the next draw covers everything anyway
+  void ClearTarget(wfe::RenderBuffer* target);
+  //Draws a full screen quad over the render rect
+  void DrawOverScreen();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Getters (Implement simple ones here)
+  const PostProStateCounters& GetCounters() const { return mCounters; }
+
+private:
+  //////////////////////////////////////////////////////////////////////////
+  //Private member functions (functions for internal class use only)
+  void FlushClear();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Private member data
+  static const u32 sMaxMapTypes = 16;
+
+  wfe::Shader* mShader;
+  GLuint mProgram;
+  wfe::RenderBuffer* mTarget;
+  wfe::RenderBuffer* mPendingClear;
+  s32 mCombineMode;
+  b8 mBlendWasEnabled;
+
+  GLuint mUnitTextures[sMaxMapTypes];
+  //Map types whose sampler has been pointed at its unit, per program
+  std::vector<std::pair<GLuint, u32> > mProgramSamplers;
+
+  PostProStateCounters mCounters;
+}; // class PostProStateCache
+
+#endif // POSTPROSTATECACHE_H
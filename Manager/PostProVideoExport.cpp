@@ -0,0 +1,226 @@
+/******************************************************************************/
+/*!
+\file   PostProVideoExport.cpp
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Streams the post processed frames to a Y4M file. The frame is converted to
+planar YUV 4:2:0 on the GPU, so only 1.5 bytes per pixel come back, and a
+background thread does the writing
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+
+/*****************************************************************************/
+/*!
+Includes
+*/
+/*****************************************************************************/
+#include "Precompiled.h" //Precompiled header
+#include "RenderBuffer.h"
+#include "GraphicsManager.h"
+#include "ShaderManager.h"
+#include "RenderTargetPool.h"
+#include "PostProEffect.h"
+#include "PostProcessingManager.h"
+
+#include "PostProVideoExport.h" //Own header
+
+/*****************************************************************************/
+/*!
+Use the engine namespace, for convenience
+*/
+/*****************************************************************************/
+using namespace wfe;
+
+PostProVideoExport::PostProVideoExport() : mPlanes(0), mExporting(false), mFramesPerSecond(60), mFrameWidth(0), mFrameHeight(0), mFrameIndex(0), mDropped(0), mQuit(false)
+{
+  mShader = &WFE_SHADER_MANAGER->GetResource("YUVPack.xml");
+}
+
+PostProVideoExport::~PostProVideoExport()
+{
+  StopWriter();
+  PostProcessingManager::sRenderTargetPool->Release(mPlanes);
+}
+
+b8 PostProVideoExport::Start(const std::string& path, u32 framesPerSecond)
+{
+  //Frames of an earlier export still go to the old file
+  StopWriter();
+  mReadback.Clear();
+
+  mFile.open(path.c_str(), std::ios::binary | std::ios::trunc);
+  if (!mFile)
+  {
+    WFE_LOGGER_POPUP << "Video export could not open " << path << std::endl;
+    return false;
+  }
+
+  mFramesPerSecond = std::max<u32>(framesPerSecond, 1);
+  mFrameWidth = 0;
+  mFrameHeight = 0;
+  mFrameIndex = 0;
+  mDropped = 0;
+  mExporting = true;
+
+  mQuit = false;
+  mWriter = std::thread(&PostProVideoExport::WriterLoop, this);
+  return true;
+}
+
+void PostProVideoExport::Stop()
+{
+  mExporting = false;
+}
+
+/*****************************************************************************/
+/*!
+Hands the frames whose copy finished to the writer, then converts and
+starts the read of this frame. Nothing here waits on the GPU or the disk,
+a frame is dropped instead
+*/
+/*****************************************************************************/
+void PostProVideoExport::Update(RenderBuffer* output, s32 width, s32 height)
+{
+  while (mReadback.GetPendingCount())
+  {
+    std::vector<u8>* frame = new std::vector<u8>;
+    s32 planesWidth, planesHeight;
+    u32 index;
+    if (!mReadback.Poll(*frame, planesWidth, planesHeight, index))
+    {
+      delete frame;
+      break;
+    }
+
+    std::unique_lock<std::mutex> lock(mFramesMutex);
+    if (mFrames.size() >= sMaxQueuedFrames)
+    {
+      ++mDropped;
+      delete frame;
+      continue;
+    }
+
+    mFrames.push_back(frame);
+    mFrameQueued.notify_one();
+  }
+
+  if (!mExporting)
+  {
+    //Close the file once the last frames are out
+    if (mWriter.joinable() && !mReadback.GetPendingCount())
+    {
+      StopWriter();
+    }
+    return;
+  }
+
+  if (!mFrameWidth)
+  {
+    //4 luma bytes per texel and chroma rows packed in pairs need these multiples
+    mFrameWidth = std::max(8, width & ~7);
+    mFrameHeight = std::max(4, height & ~3);
+
+    std::stringstream header;
+    header << "YUV4MPEG2 W" << mFrameWidth << " H" << mFrameHeight << " F" << mFramesPerSecond << ":1 Ip A1:1 C420jpeg XCOLORRANGE=LIMITED\n";
+
+    //Nothing is queued for the writer yet
+    mFile << header.str();
+  }
+
+  if (mReadback.GetPendingCount() == PostProReadback::sRingSize)
+  {
+    ++mDropped;
+    return;
+  }
+
+  Convert(output);
+
+  //The planes are the frame, header aside
+  mReadback.Read(mPlanes, mFrameWidth / 4, mFrameHeight * 3 / 2, GL_RGBA, GL_UNSIGNED_BYTE, 4, mFrameIndex);
+  ++mFrameIndex;
+}
+
+void PostProVideoExport::Convert(RenderBuffer* output)
+{
+  s32 planesWidth = mFrameWidth / 4;
+  s32 planesHeight = mFrameHeight * 3 / 2;
+
+  if (!mPlanes || mPlanes->GetWidth() != planesWidth || mPlanes->GetHeight() != planesHeight)
+  {
+    PostProcessingManager::sRenderTargetPool->Release(mPlanes);
+    mPlanes = PostProcessingManager::sRenderTargetPool->Acquire(planesWidth, planesHeight, RT_FORMAT_RGBA8, 0);
+  }
+
+  //The engine's blending may be back on after the stack, the planes must not blend
+  b8 blend = glIsEnabled(GL_BLEND) == GL_TRUE;
+  glDisable(GL_BLEND);
+
+  WFE_GRAPHICS->SwitchShader(mShader);
+  mShader->EnableTexture(output->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+  glUniform2f(glGetUniformLocation(mShader->GetHandle(), "uUVScale"),
+    static_cast<f32>(PostProEffect::GetRenderWidth()) / output->GetWidth(),
+    static_cast<f32>(PostProEffect::GetRenderHeight()) / output->GetHeight());
+  glUniform2f(glGetUniformLocation(mShader->GetHandle(), "uFrameSize"), static_cast<f32>(mFrameWidth), static_cast<f32>(mFrameHeight));
+  mPlanes->Bind();
+  glViewport(0, 0, planesWidth, planesHeight);
+  WFE_GRAPHICS->DrawOverScreen();
+
+  if (blend)
+  {
+    glEnable(GL_BLEND);
+  }
+}
+
+void PostProVideoExport::StopWriter()
+{
+  if (!mWriter.joinable())
+  {
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mFramesMutex);
+    mQuit = true;
+    mFrameQueued.notify_all();
+  }
+
+  //The writer finishes the queue before it leaves
+  mWriter.join();
+  mFile.close();
+
+  if (mDropped)
+  {
+    WFE_LOGGER_POPUP << "Video export dropped " << mDropped << " frames" << std::endl;
+  }
+}
+
+void PostProVideoExport::WriterLoop()
+{
+  for (;;)
+  {
+    std::vector<u8>* frame = 0;
+    {
+      std::unique_lock<std::mutex> lock(mFramesMutex);
+      while (mFrames.empty() && !mQuit)
+      {
+        mFrameQueued.wait(lock);
+      }
+
+      if (mFrames.empty())
+      {
+        return;
+      }
+
+      frame = mFrames.front();
+      mFrames.pop_front();
+    }
+
+    mFile << "FRAME\n";
+    mFile.write(reinterpret_cast<const char*>(&(*frame)[0]), frame->size());
+
+    delete frame;
+  }
+}
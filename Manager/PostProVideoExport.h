@@ -0,0 +1,102 @@
+/******************************************************************************/
+/*!
+\file   PostProVideoExport.h
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Streams the post processed frames to a Y4M file. The frame is converted to
+planar YUV 4:2:0 on the GPU, so only 1.5 bytes per pixel come back, and a
+background thread does the writing
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+#ifndef POSTPROVIDEOEXPORT_H
+#define POSTPROVIDEOEXPORT_H
+
+/*****************************************************************************/
+/*!
+  Includes (Only include if required! Forward declare if you can!)
+*/
+/*****************************************************************************/
+#include "PostProReadback.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+
+/*****************************************************************************/
+/*!
+  Forward Declarations
+*/
+/*****************************************************************************/
+namespace wfe
+{
+  class RenderBuffer;
+  class Shader;
+}
+
+//The YUV pass writes the three planes into one RGBA8 target, four bytes per
+//texel, laid out so that the read back buffer already is the Y4M frame:
+//the Y rows top first, then the U rows, then the V rows
+class PostProVideoExport
+{
+public:
+  //////////////////////////////////////////////////////////////////////////
+  //Ctors
+  PostProVideoExport();
+  ~PostProVideoExport();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Member functions
+
+  //Opens path and writes every following frame to it. The frame size is
+  //taken from the first frame and stays fixed, later frames are scaled to it
+  b8 Start(const std::string& path, u32 framesPerSecond);
+  //No new frames are converted. The file is closed once the frames already
+  //on their way are written
+  void Stop();
+
+  //Call once per frame with the final image, whether exporting or not
+  void Update(wfe::RenderBuffer* output, s32 width, s32 height);
+
+  //////////////////////////////////////////////////////////////////////////
+  //Getters (Implement simple ones here)
+  b8 IsExporting() const { return mExporting; }
+  //Frames skipped because the GPU or the disk fell behind
+  u32 GetDroppedCount() const { return mDropped; }
+
+  //////////////////////////////////////////////////////////////////////////
+  //Frames waiting for the writer at most, before new ones are dropped
+  static const u32 sMaxQueuedFrames = 8;
+
+private:
+  //////////////////////////////////////////////////////////////////////////
+  //Private member functions (functions for internal class use only)
+  void Convert(wfe::RenderBuffer* output);
+  void StopWriter();
+  void WriterLoop();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Private member data
+  wfe::Shader* mShader;
+  wfe::RenderBuffer* mPlanes;
+  PostProReadback mReadback;
+  b8 mExporting;
+  u32 mFramesPerSecond;
+  s32 mFrameWidth;  //0 until the first frame
+  s32 mFrameHeight;
+  u32 mFrameIndex;
+  u32 mDropped;
+
+  std::ofstream mFile;
+  std::thread mWriter;
+  std::deque<std::vector<u8>*> mFrames;
+  std::mutex mFramesMutex;
+  std::condition_variable mFrameQueued;
+  b8 mQuit;
+}; // class PostProVideoExport
+
+#endif // POSTPROVIDEOEXPORT_H
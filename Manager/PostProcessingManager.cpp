@@ -1,203 +1,605 @@
-/******************************************************************************/
-/*!
-\file   PostProcessingManager.cpp
-\par    email: y.li\@digipen.edu
-\par    name:  Sebastian Li Ye Wei
-\par    Project: CS370 
-\date   02/08/2013
-\brief  
-Class that performs post processing effects for the game
-
-All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
-*/
-/******************************************************************************/
-
-/*****************************************************************************/
-/*!
-Includes
-*/
-/*****************************************************************************/
-#include "Precompiled.h" //Precompiled header
-#include "RenderBuffer.h"
-#include "Window.h"
-#include "GraphicsManager.h"
-#include "ShaderManager.h"
-#include "PostProEffect.h"
-
-#include "PostProcessingManager.h" //Own header
-
-/*****************************************************************************/
-/*!
-Use the engine namespace, for convenience
-*/
-/*****************************************************************************/
-using namespace wfe;
-
-PostProEffectFactoryContainer PostProcessingManager::mPostProEffectFactoryContainer;
-TwBar* PostProcessingManager::sStackBar = 0;
-TwBar* PostProcessingManager::sStackManagerBar = 0;
-
-PostProcessingManager::PostProcessingManager() : mDrawDepthTexture(false)
-{
-  mSourceBuffer = new RenderBuffer(WFE_WINDOW->GetResoWidth(), WFE_WINDOW->GetResoHeight(), false);
-  mDestBuffer = new RenderBuffer(WFE_WINDOW->GetResoWidth(), WFE_WINDOW->GetResoHeight(), false);
-
-  //Init texture handle
-  glGenTextures(1, &mOriginalTextureHandle);
-  //Setup texture params
-  glBindTexture(GL_TEXTURE_2D, mOriginalTextureHandle);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-  glBindTexture(GL_TEXTURE_2D, 0);
-  mData = new u8[4 * WFE_WINDOW->GetResoWidth() * WFE_WINDOW->GetResoHeight()];
-}
-
-PostProcessingManager::~PostProcessingManager()
-{
-  //Delete effects
-  ClearPostProEffects();
-
-  //Delete buffers
-  SafeDelete(&mSourceBuffer);
-  SafeDelete(&mDestBuffer);
-  delete[] mData;
-}
-
-void PostProcessingManager::ApplyPostProEffects()
-{
-  WFE_GRAPHICS->ApplyAO();
-
-  //Clear settings before we start
-  WFE_GRAPHICS->SwitchShader(0);
-  glActiveTexture(GL_TEXTURE0);
-
-  //Profile how long our post processing takes
-  WFE_FRC->StartTimingWindow("PostPro");
-
-  s32 sizeX = WFE_WINDOW->GetResoWidth();
-  s32 sizeY = WFE_WINDOW->GetResoHeight();
-  Shader* shader = 0;
-
-  Matrix4 oldProjViewMtx = WFE_GRAPHICS->GetProjViewMatrix();
-
-  //////////////////////////////////////////////////////////////////////////
-  //Set the projection matrix for the graphics
-  WFE_GRAPHICS->SetProjViewMtx(Matrix4());
-
-  //////////////////////////////////////////////////////////////////////////
-  //Clear out the buffers
-  mSourceBuffer->Bind();
-  mSourceBuffer->Clear();
-
-  //////////////////////////////////////////////////////////////////////////
-  //Set some states
-  glDisable(GL_DEPTH_TEST);
-  glDepthMask(false);
-
-  //////////////////////////////////////////////////////////////////////////
-  //Copy the default frame buffer drawn to my own frame buffer
-  mSourceBuffer->Bind();
-  glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
-  glBlitFramebuffer(0, 0, sizeX, sizeY,
-    0, 0, sizeX, sizeY,
-    GL_COLOR_BUFFER_BIT,
-    GL_NEAREST);
-
-  // Assume we are having a clean image here
-  glReadPixels(0, 0, sizeX, sizeY, GL_RGBA, GL_UNSIGNED_BYTE, mData);
-  //Setup texture params
-  glBindTexture(GL_TEXTURE_2D, mOriginalTextureHandle);
-  //Allocate the texture
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, sizeX, sizeY, 0, GL_RGBA, GL_UNSIGNED_BYTE, mData);
-  glBindTexture(GL_TEXTURE_2D, 0);
-
-  PostProEffectContainerIt ite = mPostProEffects.begin();
-  while (ite != mPostProEffects.end())
-  {
-    (*ite)->Apply(mSourceBuffer, mDestBuffer);
-
-    // swap around to save memory, no reason to create tons of frame buffer 
-    // NOTE: limitation to this implementation is that every frame buffer are of the same size
-    //       this can still be solved, inform me (ES) if you need such functionality (i was lazy to implement it)
-    std::swap(mSourceBuffer, mDestBuffer);
-
-    ++ite;
-  }
-
-  //////////////////////////////////////////////////////////////////////////
-  //End image processing special effects
-  ResetRenderTarget();
-
-  //Draw from last used buffer back to screen
-  shader = &WFE_SHADER_MANAGER->GetResource("SimpleAttribs.xml");
-  WFE_GRAPHICS->SwitchShader(shader);
-  shader->EnableTexture(mSourceBuffer->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
-
-  WFE_GRAPHICS->DrawOverScreen();
-
-  //Draw out the depth texture
-  if (mDrawDepthTexture)
-  {
-    glViewport(0, 0, 256, 256);
-    shader = &WFE_SHADER_MANAGER->GetResource("SimpleAttribs.xml");
-    WFE_GRAPHICS->SwitchShader(shader);
-    shader->EnableTexture(WFE_GRAPHICS->GetShadowMapBuffer()->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
-    WFE_GRAPHICS->DrawOverScreen();
-    ResetRenderTarget();
-  }
-
-  //////////////////////////////////////////////////////////////////////////
-  //Reset states
-  WFE_GRAPHICS->SwitchBlendingMode(WFE_BM_NORMAL);
-  glEnable(GL_DEPTH_TEST);
-  glDepthMask(true);
-
-  WFE_GRAPHICS->SetProjViewMtx(oldProjViewMtx);
-
-  GraphicsManager::CheckGLError();
-  WFE_GRAPHICS->SwitchShader(0);
-
-  WFE_FRC->EndTimingWindow("PostPro");
-}
-
-void PostProcessingManager::ClearPostProEffects()
-{
-  while(!mPostProEffects.empty())
-  {
-    PopPostProEffect();
-  }
-}
-
-void PostProcessingManager::PopPostProEffect()
-{
-  if (!mPostProEffects.empty())
-  {
-    FactoryFree(mPostProEffectFactoryContainer, mPostProEffects.back()->GetType(), mPostProEffects.back());
-    mPostProEffects.pop_back();
-  }
-}
-
-b8 PostProcessingManager::RemovePostProEffect(u32 index)
-{
-  if(index < mPostProEffects.size())
-  {
-    FactoryFree(mPostProEffectFactoryContainer, mPostProEffects[index]->GetType(), mPostProEffects[index]);
-
-    mPostProEffects.erase(mPostProEffects.begin() + index);
-
-    return true;
-  }
-
-  return false;
-}
-
-void PostProcessingManager::PushPostProEffect( PostProEffect* effect )
-{
-  effect->CreateATBMain(mPostProEffects.size());
-
-  mPostProEffects.push_back(effect);
-}
-
-
+/******************************************************************************/
+/*!
+\file   PostProcessingManager.cpp
+\par    email: y.li\@digipen.edu
+\par    name:  Sebastian Li Ye Wei
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Class that performs post processing effects for the game
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+
+/*****************************************************************************/
+/*!
+Includes
+*/
+/*****************************************************************************/
+#include "Precompiled.h" //Precompiled header
+#include "RenderBuffer.h"
+#include "Window.h"
+#include "GraphicsManager.h"
+#include "ShaderManager.h"
+#include "PostProEffect.h"
+#include "RenderTargetPool.h"
+#include "PostProStateCache.h"
+#include "PostProDepthMask.h"
+#include "PostProDepthPyramid.h"
+#include "PostProExposure.h"
+#include "PostProCapture.h"
+#include "PostProVideoExport.h"
+#include "PostProBatch.h"
+#include "PostProShaderLibrary.h"
+
+#include "PostProcessingManager.h" //Own header
+
+#include <future>
+
+/*****************************************************************************/
+/*!
+Use the engine namespace, for convenience
+*/
+/*****************************************************************************/
+using namespace wfe;
+
+PostProEffectFactoryContainer PostProcessingManager::mPostProEffectFactoryContainer;
+TwBar* PostProcessingManager::sStackBar = 0;
+TwBar* PostProcessingManager::sStackManagerBar = 0;
+RenderTargetPool* PostProcessingManager::sRenderTargetPool = 0;
+PostProStateCache* PostProcessingManager::sStateCache = 0;
+PostProDepthMask* PostProcessingManager::sDepthMask = 0;
+PostProDepthPyramid* PostProcessingManager::sDepthPyramid = 0;
+PostProExposure* PostProcessingManager::sExposure = 0;
+PostProShaderLibrary* PostProcessingManager::sShaderLibrary = 0;
+
+/*****************************************************************************/
+/*!
+An effect that has been created but is still waiting for its host side
+resources and shader programs before it can join the stack
+*/
+/*****************************************************************************/
+struct PendingPostProEffect
+{
+  PostProEffect* mEffect;
+  std::future<void> mHostPrepared;
+};
+
+PostProcessingManager::PostProcessingManager() : mOriginalBuffer(0), mDrawDepthTexture(false), mRenderScale(1.f),
+  mResolveProgram(0), mResolveSampleCountHandle(-1), mResolveScaleHandle(-1), mResolveTonemapHandle(-1), mMultisampleTexture(0), mTonemapResolve(false), mBatchAtlasGeneration(0)
+{
+  mCapture = new PostProCapture;
+  mVideoExport = new PostProVideoExport;
+  sRenderTargetPool = new RenderTargetPool;
+  mBatch = new PostProBatch;
+  sStateCache = new PostProStateCache;
+  sDepthMask = new PostProDepthMask;
+  sDepthPyramid = new PostProDepthPyramid;
+  sExposure = new PostProExposure;
+  sShaderLibrary = new PostProShaderLibrary;
+  mScreenShader = &WFE_SHADER_MANAGER->GetResource("SimpleAttribs.xml");
+  mResolveShader = &WFE_SHADER_MANAGER->GetResource("MSAAResolve.xml");
+
+  Resize(WFE_WINDOW->GetResoWidth(), WFE_WINDOW->GetResoHeight());
+
+#ifdef GL_KHR_parallel_shader_compile
+  //Let the driver compile and link on as many threads as it likes
+  if(glMaxShaderCompilerThreadsKHR)
+  {
+    glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+  }
+#endif
+}
+
+PostProcessingManager::~PostProcessingManager()
+{
+  //Delete effects
+  ClearPendingEffects();
+  ClearPostProEffects();
+
+  //Finishes writing the frames already captured
+  SafeDelete(&mCapture);
+  SafeDelete(&mVideoExport);
+
+  //Delete buffers
+  mScreenRecording.mGraph.Clear();
+  mBatchRecording.mGraph.Clear();
+  SafeDelete(&mBatch);
+  SafeDelete(&sDepthPyramid);
+  SafeDelete(&sExposure);
+  sRenderTargetPool->Release(mOriginalBuffer);
+  SafeDelete(&sRenderTargetPool);
+  SafeDelete(&sStateCache);
+  SafeDelete(&sDepthMask);
+  SafeDelete(&sShaderLibrary);
+}
+
+void PostProcessingManager::ApplyPostProEffects()
+{
+  UpdatePendingEffects();
+
+  WFE_GRAPHICS->ApplyAO();
+
+  //Clear settings before we start
+  WFE_GRAPHICS->SwitchShader(0);
+  glActiveTexture(GL_TEXTURE0);
+
+  //Profile how long our post processing takes
+  WFE_FRC->StartTimingWindow("PostPro");
+
+  s32 sizeX = WFE_WINDOW->GetResoWidth();
+  s32 sizeY = WFE_WINDOW->GetResoHeight();
+  Shader* shader = 0;
+
+  if (sizeX != mOriginalBuffer->GetWidth() || sizeY != mOriginalBuffer->GetHeight())
+  {
+    Resize(sizeX, sizeY);
+  }
+
+  //Effects whose shaders ignore uUVScale would read the unused part of the targets
+  f32 renderScale = mRenderScale;
+  for (u32 i = 0; i < mPostProEffects.size() && renderScale < 1.f; ++i)
+  {
+    if (!mPostProEffects[i]->SupportsRenderScale())
+    {
+      renderScale = 1.f;
+    }
+  }
+
+  //Part of the targets the stack renders into
+  s32 renderX = std::max(1, static_cast<s32>(sizeX * renderScale));
+  s32 renderY = std::max(1, static_cast<s32>(sizeY * renderScale));
+  PostProEffect::SetRenderRect(renderX, renderY, sizeX, sizeY);
+
+  Matrix4 oldProjViewMtx = WFE_GRAPHICS->GetProjViewMatrix();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Set the projection matrix for the graphics
+  WFE_GRAPHICS->SetProjViewMtx(Matrix4());
+
+  //////////////////////////////////////////////////////////////////////////
+  //Clear out the buffers
+  mOriginalBuffer->Bind();
+  mOriginalBuffer->Clear();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Set some states
+  glDisable(GL_DEPTH_TEST);
+  glDepthMask(false);
+
+  //////////////////////////////////////////////////////////////////////////
+  //Copy the default frame buffer drawn, or resolve the multisampled scene, to my own frame buffer.
+  //Effects never write to it, so it stays the clean image for the whole frame
+  if (!mMultisampleTexture || !ResolveMultisampleSource(renderX, renderY))
+  {
+    mOriginalBuffer->Bind();
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, sizeX, sizeY,
+      0, 0, renderX, renderY,
+      GL_COLOR_BUFFER_BIT,
+      renderX == sizeX && renderY == sizeY ? GL_NEAREST : GL_LINEAR);
+  }
+
+  RenderBuffer* output = RunStack(mScreenRecording, mOriginalBuffer);
+
+  //////////////////////////////////////////////////////////////////////////
+  //End image processing special effects
+  ResetRenderTarget();
+
+  //Draw from last used buffer back to screen
+  if (renderX == sizeX && renderY == sizeY)
+  {
+    shader = mScreenShader;
+    WFE_GRAPHICS->SwitchShader(shader);
+    shader->EnableTexture(output->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+
+    WFE_GRAPHICS->DrawOverScreen();
+  }
+  else
+  {
+    //Scale the render rect up to the whole screen
+    output->Bind();
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, renderX, renderY,
+      0, 0, sizeX, sizeY,
+      GL_COLOR_BUFFER_BIT,
+      GL_LINEAR);
+    ResetRenderTarget();
+  }
+
+  //Starts this frame's copy and hands finished ones to the writers
+  mCapture->Update(output, renderX, renderY);
+  mVideoExport->Update(output, renderX, renderY);
+  ResetRenderTarget();
+
+  //Draw out the depth texture
+  if (mDrawDepthTexture)
+  {
+    glViewport(0, 0, 256, 256);
+    shader = mScreenShader;
+    WFE_GRAPHICS->SwitchShader(shader);
+    shader->EnableTexture(WFE_GRAPHICS->GetShadowMapBuffer()->GetColorTextureHandle(), Shader::WFE_SHADER_MAPTYPE_COLOR);
+    WFE_GRAPHICS->DrawOverScreen();
+    ResetRenderTarget();
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  //Reset states
+  WFE_GRAPHICS->SwitchBlendingMode(WFE_BM_NORMAL);
+  glEnable(GL_DEPTH_TEST);
+  glDepthMask(true);
+
+  WFE_GRAPHICS->SetProjViewMtx(oldProjViewMtx);
+
+  GraphicsManager::CheckGLError();
+  WFE_GRAPHICS->SwitchShader(0);
+
+  WFE_FRC->EndTimingWindow("PostPro");
+}
+
+/*****************************************************************************/
+/*!
+The layers are laid out as tiles of one atlas, which becomes the original of
+the stack. Every pass then covers all tiles with a single quad, so the number
+of draws, shader switches and target binds does not grow with the layer count
+*/
+/*****************************************************************************/
+b8 PostProcessingManager::ApplyPostProEffectsBatched( GLuint images, s32 width, s32 height, u32 layerCount, GLuint results )
+{
+  UpdatePendingEffects();
+
+  RenderBuffer* atlas = mBatch->Reserve(width, height, layerCount, mPostProEffects);
+  if (!atlas)
+  {
+    return false;
+  }
+
+  if (mBatch->GetAtlasGeneration() != mBatchAtlasGeneration)
+  {
+    mBatchAtlasGeneration = mBatch->GetAtlasGeneration();
+    mBatchRecording.mDirty = true;
+  }
+
+  //Clear settings before we start
+  WFE_GRAPHICS->SwitchShader(0);
+  glActiveTexture(GL_TEXTURE0);
+
+  WFE_FRC->StartTimingWindow("PostProBatch");
+
+  //The tiles and their gutters are the render rect
+  PostProEffect::SetRenderRect(mBatch->GetUsedWidth(), mBatch->GetUsedHeight(), atlas->GetWidth(), atlas->GetHeight());
+
+  Matrix4 oldProjViewMtx = WFE_GRAPHICS->GetProjViewMatrix();
+  WFE_GRAPHICS->SetProjViewMtx(Matrix4());
+
+  glDisable(GL_DEPTH_TEST);
+  glDepthMask(false);
+
+  mBatch->Gather(images);
+
+  RenderBuffer* output = RunStack(mBatchRecording, atlas);
+  mBatch->SetOutput(output);
+
+  if (results)
+  {
+    mBatch->Scatter(output, results);
+  }
+
+  ResetRenderTarget();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Reset states
+  WFE_GRAPHICS->SwitchBlendingMode(WFE_BM_NORMAL);
+  glEnable(GL_DEPTH_TEST);
+  glDepthMask(true);
+
+  WFE_GRAPHICS->SetProjViewMtx(oldProjViewMtx);
+
+  GraphicsManager::CheckGLError();
+  WFE_GRAPHICS->SwitchShader(0);
+
+  WFE_FRC->EndTimingWindow("PostProBatch");
+
+  return true;
+}
+
+void PostProcessingManager::SetHDR( b8 hdr )
+{
+  if (hdr == PostProEffect::IsHDR())
+  {
+    return;
+  }
+
+  //Every target format of the chain changes
+  PostProEffect::SetHDR(hdr);
+  Resize(mOriginalBuffer->GetWidth(), mOriginalBuffer->GetHeight());
+}
+
+b8 PostProcessingManager::GetHDR() const
+{
+  return PostProEffect::IsHDR();
+}
+
+void PostProcessingManager::SetMultisampleSource( GLuint texture )
+{
+  //Checked when it is resolved, its storage can change size or sample count any frame
+  mMultisampleTexture = texture;
+}
+
+/*****************************************************************************/
+/*!
+The resolve is the draw that fills the original target anyway, so the scene
+is read once instead of being resolved by the engine and copied by a blit.
+Every texel of the render rect is written, blending is turned off for it.
+A smaller render rect picks the nearest scene pixel of each of its pixels.
+The size and sample count are asked for every frame, the engine reallocates
+the texture when the window or the multisample setting changes
+*/
+/*****************************************************************************/
+b8 PostProcessingManager::ResolveMultisampleSource( s32 renderX, s32 renderY )
+{
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, mMultisampleTexture);
+
+  GLint width = 0;
+  GLint height = 0;
+  GLint samples = 0;
+  glGetTexLevelParameteriv(GL_TEXTURE_2D_MULTISAMPLE, 0, GL_TEXTURE_WIDTH, &width);
+  glGetTexLevelParameteriv(GL_TEXTURE_2D_MULTISAMPLE, 0, GL_TEXTURE_HEIGHT, &height);
+  glGetTexLevelParameteriv(GL_TEXTURE_2D_MULTISAMPLE, 0, GL_TEXTURE_SAMPLES, &samples);
+
+  if (width <= 0 || height <= 0 || samples <= 0)
+  {
+    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+    WFE_LOGGER_POPUP << "Post processing multisample source is not a multisample texture, reading the default framebuffer instead" << std::endl;
+    mMultisampleTexture = 0;
+    return false;
+  }
+
+  GLboolean blend = glIsEnabled(GL_BLEND);
+  glDisable(GL_BLEND);
+
+  mOriginalBuffer->Bind();
+  glViewport(0, 0, renderX, renderY);
+
+  WFE_GRAPHICS->SwitchShader(mResolveShader);
+
+  GLuint program = mResolveShader->GetHandle();
+  if (mResolveProgram != program)
+  {
+    //The sampler unit never changes, it is set along with the lookups
+    mResolveProgram = program;
+    mResolveSampleCountHandle = glGetUniformLocation(program, "uSampleCount");
+    mResolveScaleHandle = glGetUniformLocation(program, "uScale");
+    mResolveTonemapHandle = glGetUniformLocation(program, "uTonemapResolve");
+    glUniform1i(glGetUniformLocation(program, "uSceneMap"), 0);
+  }
+
+  glUniform1i(mResolveSampleCountHandle, samples);
+  glUniform2f(mResolveScaleHandle, static_cast<f32>(width) / renderX, static_cast<f32>(height) / renderY);
+  glUniform1i(mResolveTonemapHandle, mTonemapResolve);
+
+  WFE_GRAPHICS->DrawOverScreen();
+
+  glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+
+  if (blend)
+  {
+    glEnable(GL_BLEND);
+  }
+
+  return true;
+}
+
+void PostProcessingManager::StartCapture( const std::string& directory, u32 workerCount )
+{
+  mCapture->Start(directory, workerCount);
+}
+
+void PostProcessingManager::StopCapture()
+{
+  mCapture->Stop();
+}
+
+b8 PostProcessingManager::IsCapturing() const
+{
+  return mCapture->IsCapturing();
+}
+
+b8 PostProcessingManager::StartVideoExport( const std::string& path, u32 framesPerSecond )
+{
+  return mVideoExport->Start(path, framesPerSecond);
+}
+
+void PostProcessingManager::StopVideoExport()
+{
+  mVideoExport->Stop();
+}
+
+b8 PostProcessingManager::IsExportingVideo() const
+{
+  return mVideoExport->IsExporting();
+}
+
+const PostProStateCounters& PostProcessingManager::GetStateCounters() const
+{
+  return sStateCache->GetCounters();
+}
+
+void PostProcessingManager::Resize( s32 width, s32 height )
+{
+  //Only the manager's and the screen graph's buffers depend on the resolution. Effects size
+  //their transient targets from the source buffer and pick the new size up next frame
+  mScreenRecording.mGraph.Clear();
+  sRenderTargetPool->Release(mOriginalBuffer);
+
+  mOriginalBuffer = sRenderTargetPool->Acquire(width, height, PostProEffect::GetColorFormat(false), 0);
+  mOriginalTextureHandle = mOriginalBuffer->GetColorTextureHandle();
+
+  //Targets of the old size are no longer of use to anyone
+  sRenderTargetPool->Trim();
+
+  InvalidateRecordings();
+}
+
+void PostProcessingManager::RecordCommandList( StackRecording& recording, RenderBuffer* original )
+{
+  recording.mGraph.Build(mPostProEffects, original, recording.mCommandList);
+
+  recording.mOriginal = original;
+  recording.mDirty = false;
+  recording.mStructureVersion = PostProEffect::GetStructureVersion();
+}
+
+RenderBuffer* PostProcessingManager::RunStack( StackRecording& recording, RenderBuffer* original )
+{
+  if (recording.mDirty || original != recording.mOriginal || recording.mStructureVersion != PostProEffect::GetStructureVersion())
+  {
+    RecordCommandList(recording, original);
+  }
+
+  sStateCache->BeginFrame();
+
+  //Shared by every effect that reads depth at a coarser scale
+  if (recording.mGraph.UsesDepthPyramid())
+  {
+    sDepthPyramid->Build();
+  }
+
+  //Measured on the scene before any effect touched it
+  if (recording.mGraph.UsesExposure())
+  {
+    sExposure->Build(original);
+  }
+
+  recording.mCommandList.Replay();
+  sStateCache->EndFrame();
+
+  return recording.mCommandList.GetOutput();
+}
+
+void PostProcessingManager::InvalidateRecordings()
+{
+  mScreenRecording.mDirty = true;
+  mBatchRecording.mDirty = true;
+}
+
+void PostProcessingManager::ClearPostProEffects()
+{
+  while(!mPostProEffects.empty())
+  {
+    PopPostProEffect();
+  }
+}
+
+void PostProcessingManager::PopPostProEffect()
+{
+  if (!mPostProEffects.empty())
+  {
+    FactoryFree(mPostProEffectFactoryContainer, mPostProEffects.back()->GetType(), mPostProEffects.back());
+    mPostProEffects.pop_back();
+    InvalidateRecordings();
+  }
+}
+
+b8 PostProcessingManager::RemovePostProEffect(u32 index)
+{
+  if(index < mPostProEffects.size())
+  {
+    FactoryFree(mPostProEffectFactoryContainer, mPostProEffects[index]->GetType(), mPostProEffects[index]);
+
+    mPostProEffects.erase(mPostProEffects.begin() + index);
+    InvalidateRecordings();
+
+    return true;
+  }
+
+  return false;
+}
+
+void PostProcessingManager::PushPostProEffect( PostProEffect* effect )
+{
+  effect->CreateATBMain(mPostProEffects.size());
+  effect->Prepare();
+
+  mPostProEffects.push_back(effect);
+  InvalidateRecordings();
+}
+
+void PostProcessingManager::PushPostProEffectAsync( s32 type )
+{
+  PendingPostProEffect* pending = new PendingPostProEffect;
+  pending->mEffect = FactoryCreate(mPostProEffectFactoryContainer, type);
+  //The shader manager links here on the render thread, only the host work is deferred
+  pending->mEffect->LoadShaders();
+  pending->mHostPrepared = std::async(std::launch::async, &PostProEffect::PrepareHost, pending->mEffect);
+
+  mPendingEffects.push_back(pending);
+}
+
+void PostProcessingManager::PrewarmPostProEffects( const std::vector<s32>& types )
+{
+  //Loading the shaders pulls them through the shader manager, which caches them.
+  //Their variants are started in the shader library, which keeps them as well
+  std::vector<s32>::const_iterator ite = types.begin();
+  while (ite != types.end())
+  {
+    PostProEffect* effect = FactoryCreate(mPostProEffectFactoryContainer, *ite);
+    effect->LoadShaders();
+    FactoryFree(mPostProEffectFactoryContainer, *ite, effect);
+
+    ++ite;
+  }
+}
+
+/*****************************************************************************/
+/*!
+Moves pending effects onto the stack in the order they were requested. At
+most one effect is uploaded per frame so that the cost is spread out
+*/
+/*****************************************************************************/
+void PostProcessingManager::UpdatePendingEffects()
+{
+  if (mPendingEffects.empty())
+  {
+    return;
+  }
+
+  PendingPostProEffect* pending = mPendingEffects.front();
+
+  if (pending->mHostPrepared.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+  {
+    return;
+  }
+
+  if (!pending->mEffect->IsReady())
+  {
+    return;
+  }
+
+  pending->mHostPrepared.get();
+  pending->mEffect->FinishPrepare();
+
+  PushPostProEffect(pending->mEffect);
+
+  mPendingEffects.erase(mPendingEffects.begin());
+  delete pending;
+}
+
+void PostProcessingManager::ClearPendingEffects()
+{
+  while (!mPendingEffects.empty())
+  {
+    PendingPostProEffect* pending = mPendingEffects.front();
+
+    //Never free an effect a worker thread is still writing to
+    pending->mHostPrepared.wait();
+    FactoryFree(mPostProEffectFactoryContainer, pending->mEffect->GetType(), pending->mEffect);
+
+    mPendingEffects.erase(mPendingEffects.begin());
+    delete pending;
+  }
+}
+
+
@@ -1,102 +1,225 @@
-/******************************************************************************/
-/*!
-\file   PostProcessingManager.h
-\par    email: y.li\@digipen.edu
-\par    name:  Sebastian Li Ye Wei
-\par    Project: CS370 
-\date   02/08/2013
-\brief  
-  Class that performs post processing effects for the game
-  
-All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
-*/
-/******************************************************************************/
-#ifndef POSTPROCESSINGMANAGER_H
-#define POSTPROCESSINGMANAGER_H
-
-/*****************************************************************************/
-/*!
-  Includes (Only include if required! Forward declare if you can!)
-*/
-/*****************************************************************************/
-#include "PostProEffectTypeEnum.h"
-#include "AntTweakBar\AntTweakBar.h"
-
-/*****************************************************************************/
-/*!
-  Forward Declarations
-*/
-/*****************************************************************************/
-namespace wfe
-{
-  class RenderBuffer;
-
-  template<typename>
-  class FactoryPlant;
-}
-
-class PostProEffect;
-
-/*****************************************************************************/
-/*!
-  Type Declarations (Types that are associated with this class declared here)
-*/
-/*****************************************************************************/
-typedef std::map<s32, wfe::FactoryPlant<PostProEffect>*> PostProEffectFactoryContainer;
-typedef std::vector<PostProEffect*> PostProEffectContainer;
-typedef std::vector<PostProEffect*>::iterator PostProEffectContainerIt;
-
-class PostProcessingManager
-{
-public:
-  //////////////////////////////////////////////////////////////////////////
-  //Ctors
-  PostProcessingManager();
-  virtual ~PostProcessingManager();
-
-  //////////////////////////////////////////////////////////////////////////
-  //Member functions
-  virtual void ApplyPostProEffects();
-
-  //Clears all post pro effects
-  void ClearPostProEffects();
-
-  //Use this function to add new post pro effect to the effect stack
-  void PushPostProEffect(PostProEffect* effect);
-
-  //Removes the last effect
-  void PopPostProEffect();
-
-  // remove any post processing effect of given index, returns true if it was possible to remove it
-  // yes i noe vector shldnt be removed this way but i dun really care about tat
-  b8 RemovePostProEffect(u32 index);
-
-  //////////////////////////////////////////////////////////////////////////
-  //Getters (Implement simple ones here)
-  b8 GetDrawDepthTexture() const { return mDrawDepthTexture; }
-  GLuint GetOriginalTextureHandle() const { return mOriginalTextureHandle; }
-  const PostProEffectContainer& GetPostProEffectContainer() const { return mPostProEffects; }
-
-  //////////////////////////////////////////////////////////////////////////
-  //Setters (Implement simple ones here)
-  void SetDrawDepthTexture(b8 draw) { mDrawDepthTexture = draw; }
-
-  static PostProEffectFactoryContainer mPostProEffectFactoryContainer;
-  static TwBar* sStackManagerBar;
-  static TwBar* sStackBar;
-private:
-  //////////////////////////////////////////////////////////////////////////
-  //Private member functions (functions for internal class use only)
-
-  //////////////////////////////////////////////////////////////////////////
-  //Private member data
-  wfe::RenderBuffer* mSourceBuffer;
-  wfe::RenderBuffer* mDestBuffer;
-  GLuint mOriginalTextureHandle;
-  b8 mDrawDepthTexture;
-  u8* mData;
-
-  PostProEffectContainer mPostProEffects;
-}; // class PostProcessingManager
-
+/******************************************************************************/
+/*!
+\file   PostProcessingManager.h
+\par    email: y.li\@digipen.edu
+\par    name:  Sebastian Li Ye Wei
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+  Class that performs post processing effects for the game
+  
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+#ifndef POSTPROCESSINGMANAGER_H
+#define POSTPROCESSINGMANAGER_H
+
+/*****************************************************************************/
+/*!
+  Includes (Only include if required! Forward declare if you can!)
+*/
+/*****************************************************************************/
+#include "PostProEffectTypeEnum.h"
+#include "PostProCommandList.h"
+#include "PostProGraph.h"
+#include "AntTweakBar\AntTweakBar.h"
+
+/*****************************************************************************/
+/*!
+  Forward Declarations
+*/
+/*****************************************************************************/
+namespace wfe
+{
+  class RenderBuffer;
+
+  template<typename>
+  class FactoryPlant;
+}
+
+class PostProEffect;
+class RenderTargetPool;
+class PostProStateCache;
+class PostProDepthMask;
+class PostProDepthPyramid;
+class PostProExposure;
+class PostProCapture;
+class PostProVideoExport;
+class PostProBatch;
+class PostProShaderLibrary;
+struct PostProStateCounters;
+struct PendingPostProEffect;
+
+/*****************************************************************************/
+/*!
+  Type Declarations (Types that are associated with this class declared here)
+*/
+/*****************************************************************************/
+typedef std::map<s32, wfe::FactoryPlant<PostProEffect>*> PostProEffectFactoryContainer;
+typedef std::vector<PostProEffect*> PostProEffectContainer;
+typedef std::vector<PostProEffect*>::iterator PostProEffectContainerIt;
+typedef std::vector<PendingPostProEffect*> PendingPostProEffectContainer;
+
+class PostProcessingManager
+{
+public:
+  //////////////////////////////////////////////////////////////////////////
+  //Ctors
+  PostProcessingManager();
+  virtual ~PostProcessingManager();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Member functions
+  virtual void ApplyPostProEffects();
+
+  //Runs the stack once for all layers of images, a GL_TEXTURE_2D_ARRAY of width x height
+  //layers, instead of once per image. The results are copied into the layers of results
+  //unless it is 0, GetBatch().GetOutput() holds them either way until the stack runs again.
+  //Every layer goes through the same effects with the same settings, and effects that read
+  //depth see the depth buffer of the frame, so batches are meant for color only stacks
+  b8 ApplyPostProEffectsBatched(GLuint images, s32 width, s32 height, u32 layerCount, GLuint results = 0);
+
+  //Clears all post pro effects
+  void ClearPostProEffects();
+
+  //Use this function to add new post pro effect to the effect stack
+  void PushPostProEffect(PostProEffect* effect);
+
+  //Creates the effect now but prepares its resources over the next frames.
+  //The effect only joins the stack once its shaders are linked and its resources uploaded
+  void PushPostProEffectAsync(s32 type);
+
+  //Creates and frees one of every given effect type so that their shaders are
+  //compiled and cached before they are needed. Call this during level load
+  void PrewarmPostProEffects(const std::vector<s32>& types);
+
+  //Removes the last effect
+  void PopPostProEffect();
+
+  //Reallocates the resolution dependent buffers. Called automatically when the window resolution changes
+  void Resize(s32 width, s32 height);
+
+  //Writes the post processed frames to directory as a PNG sequence on workerCount
+  //threads. The render thread never waits, frames are dropped if the disk falls behind
+  void StartCapture(const std::string& directory, u32 workerCount = 2);
+  void StopCapture();
+  b8 IsCapturing() const;
+
+  //Streams the post processed frames to a Y4M file. The conversion to YUV 4:2:0
+  //runs on the GPU after the stack, the file is written on a background thread
+  b8 StartVideoExport(const std::string& path, u32 framesPerSecond = 60);
+  void StopVideoExport();
+  b8 IsExportingVideo() const;
+
+  // remove any post processing effect of given index, returns true if it was possible to remove it
+  // yes i noe vector shldnt be removed this way but i dun really care about tat
+  b8 RemovePostProEffect(u32 index);
+
+  //////////////////////////////////////////////////////////////////////////
+  //Getters (Implement simple ones here)
+  b8 GetDrawDepthTexture() const { return mDrawDepthTexture; }
+  GLuint GetOriginalTextureHandle() const { return mOriginalTextureHandle; }
+  const PostProEffectContainer& GetPostProEffectContainer() const { return mPostProEffects; }
+  //Schedule of the stack as it runs on the screen
+  const PostProGraph& GetGraph() const { return mScreenRecording.mGraph; }
+  const PostProBatch& GetBatch() const { return *mBatch; }
+  u32 GetPendingPostProEffectCount() const { return mPendingEffects.size(); }
+  //GL calls issued and skipped by the state cache during the last frame
+  const PostProStateCounters& GetStateCounters() const;
+
+  //////////////////////////////////////////////////////////////////////////
+  //Setters (Implement simple ones here)
+  void SetDrawDepthTexture(b8 draw) { mDrawDepthTexture = draw; }
+
+  //Dynamic resolution. The stack renders into the lower left part of the targets and
+  //is scaled up to the screen at the end, so changing the scale never reallocates.
+  //It is ignored while an effect on the stack does not support it
+  void SetRenderScale(f32 scale) { mRenderScale = Clamp<f32>(scale, 0.25f, 1.f); }
+  f32 GetRenderScale() const { return mRenderScale; }
+
+  //Runs the stack in float targets up to the first Tonemap effect. R11G11B10F is
+  //used where alpha is not needed, so HDR costs about the same bandwidth as RGBA8
+  void SetHDR(b8 hdr);
+  b8 GetHDR() const;
+
+  //The scene as a GL_TEXTURE_2D_MULTISAMPLE. While set, the stack reads it instead of the
+  //default framebuffer and resolves it while filling the original target, so the engine
+  //neither resolves the scene nor is it copied. 0 goes back to the default framebuffer
+  void SetMultisampleSource(GLuint texture);
+  GLuint GetMultisampleSource() const { return mMultisampleTexture; }
+
+  //Weights the samples of the multisample resolve by their brightness, so HDR edges
+  //stay antialiased after tonemapping
+  void SetTonemapResolve(b8 tonemap) { mTonemapResolve = tonemap; }
+  b8 GetTonemapResolve() const { return mTonemapResolve; }
+
+  static PostProEffectFactoryContainer mPostProEffectFactoryContainer;
+  static TwBar* sStackManagerBar;
+  static TwBar* sStackBar;
+  static RenderTargetPool* sRenderTargetPool;
+  static PostProStateCache* sStateCache;
+  static PostProDepthMask* sDepthMask;
+  static PostProDepthPyramid* sDepthPyramid;
+  static PostProExposure* sExposure;
+  static PostProShaderLibrary* sShaderLibrary;
+private:
+  //////////////////////////////////////////////////////////////////////////
+  //Private types
+
+  //The stack scheduled and recorded for one original target. The screen and the
+  //batch atlas each keep their own, so alternating between them records nothing
+  struct StackRecording
+  {
+    StackRecording() : mOriginal(0), mDirty(true), mStructureVersion(0) {}
+
+    PostProGraph mGraph;
+    PostProCommandList mCommandList;
+    wfe::RenderBuffer* mOriginal;
+    b8 mDirty;
+    u32 mStructureVersion;
+  };
+
+  //////////////////////////////////////////////////////////////////////////
+  //Private member functions (functions for internal class use only)
+  void UpdatePendingEffects();
+  void ClearPendingEffects();
+
+  //Schedules the effect stack reading from original and records it into the recording.
+  //Only done when the stack or the original target changes
+  void RecordCommandList(StackRecording& recording, wfe::RenderBuffer* original);
+  //Runs the stack recorded for original and returns the target holding the result
+  wfe::RenderBuffer* RunStack(StackRecording& recording, wfe::RenderBuffer* original);
+  //The stack changed, both recordings are scheduled again when next used
+  void InvalidateRecordings();
+  //Fills the render rect of mOriginalBuffer from the multisample source. False when
+  //the source is no longer a multisample texture, the caller copies the default framebuffer then
+  b8 ResolveMultisampleSource(s32 renderX, s32 renderY);
+
+  //////////////////////////////////////////////////////////////////////////
+  //Private member data
+  wfe::RenderBuffer* mOriginalBuffer;
+  GLuint mOriginalTextureHandle;
+  b8 mDrawDepthTexture;
+  f32 mRenderScale;
+  wfe::Shader* mScreenShader;
+
+  wfe::Shader* mResolveShader;
+  GLuint mResolveProgram; //Program the handles below were looked up in
+  GLint mResolveSampleCountHandle;
+  GLint mResolveScaleHandle;
+  GLint mResolveTonemapHandle;
+  GLuint mMultisampleTexture;
+  b8 mTonemapResolve;
+
+  PostProCapture* mCapture;
+  PostProVideoExport* mVideoExport;
+  PostProBatch* mBatch;
+  u32 mBatchAtlasGeneration; //Of the atlas mBatchRecording was recorded with
+  StackRecording mScreenRecording;
+  StackRecording mBatchRecording;
+
+  PostProEffectContainer mPostProEffects;
+  PendingPostProEffectContainer mPendingEffects;
+}; // class PostProcessingManager
+
 #endif // POSTPROCESSINGMANAGER_H
\ No newline at end of file
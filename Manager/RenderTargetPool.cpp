@@ -0,0 +1,253 @@
+/******************************************************************************/
+/*!
+\file   RenderTargetPool.cpp
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Pool of render targets shared by the post processing effects
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+
+/*****************************************************************************/
+/*!
+Includes
+*/
+/*****************************************************************************/
+#include "Precompiled.h" //Precompiled header
+#include "RenderBuffer.h"
+
+#include "RenderTargetPool.h" //Own header
+
+/*****************************************************************************/
+/*!
+Use the engine namespace, for convenience
+*/
+/*****************************************************************************/
+using namespace wfe;
+
+RenderTargetPool::RenderTargetPool() : mBudget(0), mBytesAllocated(0)
+{
+}
+
+RenderTargetPool::~RenderTargetPool()
+{
+  Clear();
+}
+
+RenderBuffer* RenderTargetPool::Acquire(s32 width, s32 height, RenderTargetFormat format, const PostProEffect* owner)
+{
+  std::vector<Entry>::iterator ite = mEntries.begin();
+  while (ite != mEntries.end())
+  {
+    if (!ite->mInUse && ite->mWidth == width && ite->mHeight == height && ite->mFormat == format)
+    {
+      ite->mInUse = true;
+      ite->mOwner = owner;
+      return ite->mTarget;
+    }
+    ++ite;
+  }
+
+  u32 bytes = width * height * GetBytesPerPixel(format);
+
+  //Make room for the new target. If everything is in use the allocation still
+  //goes through, rendering must not fail because of the budget
+  if (mBudget)
+  {
+    EvictUnused(mBudget > bytes ? mBudget - bytes : 0);
+  }
+
+  Entry entry;
+  entry.mTarget = CreateTarget(width, height, format);
+  entry.mWidth = width;
+  entry.mHeight = height;
+  entry.mFormat = format;
+  entry.mBytes = bytes;
+  entry.mOwner = owner;
+  entry.mInUse = true;
+  mEntries.push_back(entry);
+
+  mBytesAllocated += bytes;
+
+  return entry.mTarget;
+}
+
+void RenderTargetPool::Release(RenderBuffer* target)
+{
+  if (!target)
+  {
+    return;
+  }
+
+  std::vector<Entry>::iterator ite = mEntries.begin();
+  while (ite != mEntries.end())
+  {
+    if (ite->mTarget == target)
+    {
+      ASSERT(ite->mInUse);
+      ite->mInUse = false;
+      ite->mOwner = 0;
+      return;
+    }
+    ++ite;
+  }
+
+  //Target did not come from this pool
+  ASSERT(false);
+}
+
+void RenderTargetPool::Trim()
+{
+  EvictUnused(0);
+}
+
+void RenderTargetPool::Clear()
+{
+  std::vector<Entry>::iterator ite = mEntries.begin();
+  while (ite != mEntries.end())
+  {
+    ASSERT(!ite->mInUse);
+    SafeDelete(&ite->mTarget);
+    ++ite;
+  }
+
+  mEntries.clear();
+  mBytesAllocated = 0;
+}
+
+void RenderTargetPool::GetReport(std::vector<RenderTargetReportEntry>& report) const
+{
+  report.clear();
+
+  std::vector<Entry>::const_iterator ite = mEntries.begin();
+  while (ite != mEntries.end())
+  {
+    if (ite->mInUse)
+    {
+      std::vector<RenderTargetReportEntry>::iterator reportIte = report.begin();
+      while (reportIte != report.end() && reportIte->mOwner != ite->mOwner)
+      {
+        ++reportIte;
+      }
+
+      if (reportIte == report.end())
+      {
+        RenderTargetReportEntry entry = { ite->mOwner, 0 };
+        report.push_back(entry);
+        reportIte = report.end() - 1;
+      }
+
+      reportIte->mBytes += ite->mBytes;
+    }
+    ++ite;
+  }
+}
+
+u32 RenderTargetPool::GetBytesPerPixel(RenderTargetFormat format)
+{
+  switch (format)
+  {
+  case RT_FORMAT_RGBA8:
+    return 4;
+  case RT_FORMAT_RGBA16F:
+    return 8;
+  case RT_FORMAT_R11G11B10F:
+    return 4;
+  case RT_FORMAT_RGBA32F:
+    return 16;
+  default:
+    ASSERT(false);
+  }
+
+  return 0;
+}
+
+u32 RenderTargetPool::GetBytesInUse() const
+{
+  u32 bytes = 0;
+
+  std::vector<Entry>::const_iterator ite = mEntries.begin();
+  while (ite != mEntries.end())
+  {
+    if (ite->mInUse)
+    {
+      bytes += ite->mBytes;
+    }
+    ++ite;
+  }
+
+  return bytes;
+}
+
+u32 RenderTargetPool::GetBytesHeldBy(const PostProEffect* owner) const
+{
+  u32 bytes = 0;
+
+  std::vector<Entry>::const_iterator ite = mEntries.begin();
+  while (ite != mEntries.end())
+  {
+    if (ite->mInUse && ite->mOwner == owner)
+    {
+      bytes += ite->mBytes;
+    }
+    ++ite;
+  }
+
+  return bytes;
+}
+
+RenderBuffer* RenderTargetPool::CreateTarget(s32 width, s32 height, RenderTargetFormat format)
+{
+  RenderBuffer* target = new RenderBuffer(width, height, false);
+
+  //Render buffers are created as RGBA8, respecify the color storage for the other formats.
+  //The frame buffer keeps the same texture object attached so it stays valid
+  if (RT_FORMAT_RGBA8 != format)
+  {
+    glBindTexture(GL_TEXTURE_2D, target->GetColorTextureHandle());
+
+    switch (format)
+    {
+    case RT_FORMAT_RGBA16F:
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_HALF_FLOAT, 0);
+      break;
+    case RT_FORMAT_R11G11B10F:
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_R11F_G11F_B10F, width, height, 0, GL_RGB, GL_FLOAT, 0);
+      break;
+    case RT_FORMAT_RGBA32F:
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, 0);
+      break;
+    default:
+      ASSERT(false);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+  }
+
+  return target;
+}
+
+/*****************************************************************************/
+/*!
+Frees targets nobody holds until at most maxBytes are allocated
+*/
+/*****************************************************************************/
+void RenderTargetPool::EvictUnused(u32 maxBytes)
+{
+  std::vector<Entry>::iterator ite = mEntries.begin();
+  while (ite != mEntries.end() && mBytesAllocated > maxBytes)
+  {
+    if (!ite->mInUse)
+    {
+      mBytesAllocated -= ite->mBytes;
+      SafeDelete(&ite->mTarget);
+      ite = mEntries.erase(ite);
+    }
+    else
+    {
+      ++ite;
+    }
+  }
+}
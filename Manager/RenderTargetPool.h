@@ -0,0 +1,112 @@
+/******************************************************************************/
+/*!
+\file   RenderTargetPool.h
+\par    Project: CS370 
+\date   02/08/2013
+\brief  
+Pool of render targets shared by the post processing effects
+
+All content (c) 2012 DigiPen Institute of Technology Singapore, all rights reserved.
+*/
+/******************************************************************************/
+#ifndef RENDERTARGETPOOL_H
+#define RENDERTARGETPOOL_H
+
+/*****************************************************************************/
+/*!
+  Forward Declarations
+*/
+/*****************************************************************************/
+namespace wfe
+{
+  class RenderBuffer;
+}
+
+class PostProEffect;
+
+/*****************************************************************************/
+/*!
+  Type Declarations (Types that are associated with this class declared here)
+*/
+/*****************************************************************************/
+enum RenderTargetFormat
+{
+  RT_FORMAT_RGBA8,      //LDR, also used after tonemapping
+  RT_FORMAT_RGBA16F,    //HDR with alpha
+  RT_FORMAT_R11G11B10F, //HDR without alpha, same size as RGBA8
+  RT_FORMAT_RGBA32F,    //Sums and other data that needs full float precision
+  RT_FORMAT_NUM
+};
+
+struct RenderTargetReportEntry
+{
+  const PostProEffect* mOwner; //0 for targets held by the manager
+  u32 mBytes;
+};
+
+class RenderTargetPool
+{
+public:
+  //////////////////////////////////////////////////////////////////////////
+  //Ctors
+  RenderTargetPool();
+  ~RenderTargetPool();
+
+  //////////////////////////////////////////////////////////////////////////
+  //Member functions
+
+  //Returns a free target of the given size and format, creating one if there is none
+  wfe::RenderBuffer* Acquire(s32 width, s32 height, RenderTargetFormat format, const PostProEffect* owner);
+
+  //Hands the target back to the pool. It stays allocated for the next Acquire
+  void Release(wfe::RenderBuffer* target);
+
+  //Frees every target that is not held by anyone
+  void Trim();
+
+  //Frees everything. Every target must have been released
+  void Clear();
+
+  //Bytes currently held per owner, one entry per owner
+  void GetReport(std::vector<RenderTargetReportEntry>& report) const;
+
+  static u32 GetBytesPerPixel(RenderTargetFormat format);
+
+  //////////////////////////////////////////////////////////////////////////
+  //Getters (Implement simple ones here)
+  u32 GetBudget() const { return mBudget; }
+  u32 GetBytesAllocated() const { return mBytesAllocated; }
+  u32 GetBytesInUse() const;
+  u32 GetBytesHeldBy(const PostProEffect* owner) const;
+
+  //////////////////////////////////////////////////////////////////////////
+  //Setters (Implement simple ones here)
+
+  //0 means no budget. Free targets are evicted to stay within the budget
+  void SetBudget(u32 bytes) { mBudget = bytes; }
+
+private:
+  struct Entry
+  {
+    wfe::RenderBuffer* mTarget;
+    s32 mWidth;
+    s32 mHeight;
+    RenderTargetFormat mFormat;
+    u32 mBytes;
+    const PostProEffect* mOwner;
+    b8 mInUse;
+  };
+
+  //////////////////////////////////////////////////////////////////////////
+  //Private member functions (functions for internal class use only)
+  wfe::RenderBuffer* CreateTarget(s32 width, s32 height, RenderTargetFormat format);
+  void EvictUnused(u32 maxBytes);
+
+  //////////////////////////////////////////////////////////////////////////
+  //Private member data
+  std::vector<Entry> mEntries;
+  u32 mBudget;
+  u32 mBytesAllocated;
+}; // class RenderTargetPool
+
+#endif // RENDERTARGETPOOL_H
@@ -0,0 +1,19 @@
+/******************************************************************************/
+/*!
+\file   BatchGather.fs
+\par    Course: CS370
+\brief  
+  Copies a layer of the batch's texture array into its tile
+*/
+/******************************************************************************/
+
+#extension GL_EXT_texture_array : require
+
+uniform sampler2DArray uImages; // one image per layer
+
+varying vec3 vTexCoord;
+
+void main(void)
+{
+  gl_FragColor = texture2DArray(uImages, vTexCoord);
+}
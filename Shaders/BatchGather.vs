@@ -0,0 +1,27 @@
+/******************************************************************************/
+/*!
+\file   BatchGather.vs
+\par    Course: CS370
+\brief  
+  One instance per layer of the batch, moves the quad onto the layer's tile
+  of the atlas, gutter included
+*/
+/******************************************************************************/
+
+#extension GL_ARB_draw_instanced : require
+
+attribute vec2 aTexCoord; // corner of the tile, 0 to 1
+
+uniform vec4 uTileRects[16]; // per layer, corners of the tile and its gutter in clip space
+uniform vec2 uGutter;        // width of the gutter in texture coordinates of a layer
+
+varying vec3 vTexCoord;
+
+void main(void)
+{
+  vec4 rect = uTileRects[gl_InstanceIDARB];
+  gl_Position = vec4(mix(rect.xy, rect.zw, aTexCoord), 0.0, 1.0);
+
+  // Runs past 0 and 1 over the gutter, the clamped sampler repeats the edge
+  vTexCoord = vec3(mix(-uGutter, vec2(1.0) + uGutter, aTexCoord), float(gl_InstanceIDARB));
+}
@@ -0,0 +1,27 @@
+/******************************************************************************/
+/*!
+\file   BilateralBlur.fs
+\par    Course: CS370
+\brief  
+  One axis of the 1 2 1 blur over the bilateral grid
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap; // grid, slices side by side
+
+uniform vec2 uStep;      // in texels, a slice width steps along the intensity
+uniform vec2 uAtlasSize; // in texels
+
+vec4 Cell(vec2 texel)
+{
+  if(texel.x < 0.0 || texel.y < 0.0 || texel.x >= uAtlasSize.x || texel.y >= uAtlasSize.y)
+    return vec4(0.0);
+  return texture2D(uColorMap, texel / uAtlasSize);
+}
+
+void main(void)
+{
+  vec2 texel = gl_FragCoord.xy;
+
+  gl_FragColor = Cell(texel - uStep) * 0.25 + Cell(texel) * 0.5 + Cell(texel + uStep) * 0.25;
+}
@@ -0,0 +1,40 @@
+/******************************************************************************/
+/*!
+\file   BilateralSlice.fs
+\par    Course: CS370
+\brief  
+  Reads the smoothed color out of the bilateral grid at the pixel's position
+  and intensity. Filtering interpolates within a slice, the two slices
+  around the intensity are mixed here
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap; // image
+uniform sampler2D uPass0;    // blurred grid, slices side by side
+
+varying vec2 vTexCoord;
+uniform vec2 uUVScale; // part of uColorMap that holds the image
+
+uniform vec3 uGridScale;   // grid cells per pixel, slices per intensity
+uniform vec2 uAtlasSize;   // all slices side by side
+uniform float uSliceWidth; // in cells
+
+vec4 Slice(float slice, vec2 cell)
+{
+  return texture2D(uPass0, (vec2(slice * uSliceWidth + cell.x, cell.y) + 0.5) / uAtlasSize);
+}
+
+void main(void)
+{
+  vec4 color = texture2D(uColorMap, vTexCoord * uUVScale);
+  float intensity = clamp(dot(color.rgb, vec3(0.2126, 0.7152, 0.0722)), 0.0, 1.0);
+
+  // Same cells as the splat, without rounding
+  vec3 grid = vec3(gl_FragCoord.xy, intensity) * uGridScale + 1.0;
+  float slice = floor(grid.z);
+
+  vec4 cell = mix(Slice(slice, grid.xy), Slice(slice + 1.0, grid.xy), grid.z - slice);
+
+  // Weight is the number of pixels that ended up around the cell
+  gl_FragColor = vec4(cell.a > 0.0001 ? cell.rgb / cell.a : color.rgb, color.a);
+}
@@ -0,0 +1,15 @@
+/******************************************************************************/
+/*!
+\file   BilateralSplat.fs
+\par    Course: CS370
+\brief  
+  Adds the pixel to its grid cell, blended additively
+*/
+/******************************************************************************/
+
+varying vec4 vColor;
+
+void main(void)
+{
+  gl_FragColor = vColor;
+}
@@ -0,0 +1,39 @@
+/******************************************************************************/
+/*!
+\file   BilateralSplat.vs
+\par    Course: CS370
+\brief  
+  One point per pixel, one instance per row. Moves the point onto the grid
+  cell of the pixel's position and intensity
+*/
+/******************************************************************************/
+
+#extension GL_ARB_draw_instanced : require
+
+attribute float aPixelX;
+
+uniform sampler2D uColorMap; // image
+
+uniform vec2 uSourceSize;  // size of uColorMap in texels
+uniform vec3 uGridScale;   // grid cells per pixel, slices per intensity
+uniform vec2 uAtlasSize;   // all slices side by side
+uniform float uSliceWidth; // in cells
+
+varying vec4 vColor;
+
+void main(void)
+{
+  vec2 pixel = vec2(aPixelX, float(gl_InstanceIDARB)) + 0.5;
+  vec4 color = texture2DLod(uColorMap, pixel / uSourceSize, 0.0);
+  float intensity = clamp(dot(color.rgb, vec3(0.2126, 0.7152, 0.0722)), 0.0, 1.0);
+
+  // Nearest cell, past the empty one at the start of every axis
+  vec3 cell = floor(vec3(pixel, intensity) * uGridScale + 0.5) + 1.0;
+  vec2 texel = vec2(cell.z * uSliceWidth + cell.x, cell.y) + 0.5;
+
+  gl_Position = vec4(texel / uAtlasSize * 2.0 - 1.0, 0.0, 1.0);
+  gl_PointSize = 1.0;
+
+  // The weight goes into alpha, the slice divides by it
+  vColor = vec4(color.rgb, 1.0);
+}
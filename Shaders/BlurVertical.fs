@@ -1,44 +1,84 @@
-/******************************************************************************/
-/*!
-\author Lim Ee Siang
-\par    email: e.lim\@digipen.edu
-\par    Course: CS370
-\brief  
-
-*/
-/******************************************************************************/
-
-uniform sampler2D uColorMap;
-uniform sampler2D uShadowMap;
-
-varying vec2 vTexCoord;
-
-uniform float uMapSize;
-uniform int uHalfSize;
-uniform float uBlurCutoff;
-uniform bool uInvert;
-uniform bool uNaiveDOF;
-
-void main(void)
-{
-  vec4 col = vec4(0.0, 0.0, 0.0, 1.0);
-  
-  float depth = texture2D(uShadowMap, vTexCoord).r;
-  
-  if(!uNaiveDOF || (uInvert? depth <= uBlurCutoff: depth >= uBlurCutoff))
-  { 
-    float weight = 1.0 / (uHalfSize * 2 + 1);
-    for(int i = -uHalfSize; i <= uHalfSize; ++i)
-    {
-      vec2 coord = vTexCoord;
-      coord.y += i * uMapSize;
-      col += weight * texture2D(uColorMap, coord);
-    }  
-    
-    gl_FragColor = col;   
-  }  
-  else
-  {
-    gl_FragColor = texture2D(uColorMap, vTexCoord); 
-  }
+/******************************************************************************/
+/*!
+\author Lim Ee Siang
+\par    email: e.lim\@digipen.edu
+\par    Course: CS370
+\brief  
+
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap;
+uniform sampler2D uShadowMap;
+
+varying vec2 vTexCoord;
+
+uniform float uMapSize;
+uniform float uBlurCutoff;
+
+#ifdef SPECIALIZED
+// Options compiled in by PostProShaderLibrary. The loop has constant bounds
+// and unrolls, the depth branch folds away
+#define BLUR_HALF_SIZE HALF_SIZE
+#define BLUR_NAIVE_DOF (NAIVE_DOF != 0)
+#define BLUR_INVERT (INVERT != 0)
+#else
+uniform int uHalfSize;
+uniform bool uInvert;
+uniform bool uNaiveDOF;
+#define BLUR_HALF_SIZE uHalfSize
+#define BLUR_NAIVE_DOF uNaiveDOF
+#define BLUR_INVERT uInvert
+#endif
+
+uniform vec2 uUVScale; // part of uColorMap that holds the image
+
+uniform int uCombineMode;
+uniform float uOpacity;
+
+// Keep in sync with PostProcessingCombineModes and the copies in the other
+// shaders that combine with their input themselves
+vec4 PostProCombine(vec4 base, vec4 result)
+{
+  vec4 blended = result;
+
+  if(uCombineMode == 1)      // NORMAL
+    blended = mix(base, result, result.a);
+  else if(uCombineMode == 2) // ADD
+    blended = base + result;
+  else if(uCombineMode == 3) // SUB
+    blended = base - result;
+  else if(uCombineMode == 4) // MULTIPLY
+    blended = base * result;
+  else if(uCombineMode == 5) // SCREEN
+    blended = 1.0 - (1.0 - clamp(base, 0.0, 1.0)) * (1.0 - clamp(result, 0.0, 1.0));
+
+  // REPLACE ignores the opacity, LERP is just the opacity
+  return uCombineMode == 0 ? result : mix(base, blended, uOpacity);
+}
+
+void main(void)
+{
+  vec4 col = vec4(0.0, 0.0, 0.0, 1.0);
+  vec4 base = texture2D(uColorMap, vTexCoord * uUVScale);
+  
+  float depth = texture2D(uShadowMap, vTexCoord).r;
+  
+  if(!BLUR_NAIVE_DOF || (BLUR_INVERT? depth <= uBlurCutoff: depth >= uBlurCutoff))
+  { 
+    float weight = 1.0 / float(BLUR_HALF_SIZE * 2 + 1);
+    for(int i = -BLUR_HALF_SIZE; i <= BLUR_HALF_SIZE; ++i)
+    {
+      vec2 coord = vTexCoord * uUVScale;
+      // Clamp to the centre of the last texel of the render rect
+      coord.y = min(coord.y + float(i) * uMapSize, uUVScale.y - 0.5 * uMapSize);
+      col += weight * texture2D(uColorMap, coord);
+    }  
+    
+    gl_FragColor = PostProCombine(base, col);   
+  }  
+  else
+  {
+    gl_FragColor = base; 
+  }
 }
\ No newline at end of file
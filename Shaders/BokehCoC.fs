@@ -0,0 +1,27 @@
+/******************************************************************************/
+/*!
+\file   BokehCoC.fs
+\par    Course: CS370
+\brief  
+  Half resolution color with the circle of confusion in alpha, in half
+  resolution pixels
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap;  // full resolution image
+uniform sampler2D uShadowMap; // depth buffer, always covers the whole view
+
+varying vec2 vTexCoord;
+uniform vec2 uUVScale; // part of uColorMap that holds the image
+
+uniform float uFocusDepth;
+uniform float uFocusRange;
+uniform float uMaxCoC;
+
+void main(void)
+{
+  float depth = texture2D(uShadowMap, vTexCoord).r;
+  float coc = min(abs(depth - uFocusDepth) / uFocusRange, 1.0) * uMaxCoC;
+
+  gl_FragColor = vec4(texture2D(uColorMap, vTexCoord * uUVScale).rgb, coc);
+}
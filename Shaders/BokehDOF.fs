@@ -0,0 +1,32 @@
+/******************************************************************************/
+/*!
+\file   BokehDOF.fs
+\par    Course: CS370
+\brief  
+  Blends the half resolution bokeh over the sharp image by the full
+  resolution circle of confusion
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap;  // sharp image
+uniform sampler2D uShadowMap; // depth buffer, always covers the whole view
+uniform sampler2D uPass1;     // half resolution bokeh
+
+varying vec2 vTexCoord;
+uniform vec2 uUVScale; // part of uColorMap that holds the image
+
+uniform float uFocusDepth;
+uniform float uFocusRange;
+uniform float uMaxCoC;
+
+void main(void)
+{
+  float depth = texture2D(uShadowMap, vTexCoord).r;
+  float coc = min(abs(depth - uFocusDepth) / uFocusRange, 1.0) * uMaxCoC;
+
+  vec2 coord = vTexCoord * uUVScale;
+  vec4 sharp = texture2D(uColorMap, coord);
+  vec3 bokeh = texture2D(uPass1, coord).rgb;
+
+  gl_FragColor = vec4(mix(sharp.rgb, bokeh, smoothstep(0.5, 1.5, coc)), sharp.a);
+}
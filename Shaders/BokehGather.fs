@@ -0,0 +1,80 @@
+/******************************************************************************/
+/*!
+\file   BokehGather.fs
+\par    Course: CS370
+\brief  
+  Half resolution gather blur. Tiles whose neighbourhood is in focus return
+  right away, tiles with a uniform CoC skip the per sample weighting
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap; // half resolution color and CoC
+uniform sampler2D uPass1;    // min/max CoC per tile
+
+uniform int uTileSize;
+uniform int uSamples;
+uniform vec2 uCoCTexelSize;  // 1 / size of the CoC target
+uniform vec2 uCoCMaxUV;      // part of the CoC target that holds the image
+uniform vec2 uTileTexelSize; // 1 / size of the tile target
+uniform vec2 uTileMaxUV;     // part of the tile target that holds tiles
+
+const float cGoldenAngle = 2.39996323;
+
+void main(void)
+{
+  vec2 pixel = floor(gl_FragCoord.xy);
+  vec2 uv = (pixel + 0.5) * uCoCTexelSize;
+  vec4 center = texture2D(uColorMap, uv);
+
+  // Blurry pixels can reach one tile over, so look at the neighbour tiles too
+  vec2 tile = (floor(pixel / float(uTileSize)) + 0.5) * uTileTexelSize;
+  float minCoC = 1000.0;
+  float maxCoC = 0.0;
+  for(int y = -1; y <= 1; ++y)
+  {
+    for(int x = -1; x <= 1; ++x)
+    {
+      vec2 range = texture2D(uPass1, clamp(tile + vec2(x, y) * uTileTexelSize, vec2(0.0), uTileMaxUV)).rg;
+      minCoC = min(minCoC, range.r);
+      maxCoC = max(maxCoC, range.g);
+    }
+  }
+
+  // In focus, nothing to blur
+  if(maxCoC < 0.5)
+  {
+    gl_FragColor = vec4(center.rgb, 0.0);
+    return;
+  }
+
+  vec3 sum = center.rgb;
+  float weight = 1.0;
+
+  // Uniform tiles blur with one radius, every sample counts
+  if(maxCoC - minCoC < 1.0)
+  {
+    for(int i = 1; i < uSamples; ++i)
+    {
+      float r = sqrt(float(i) / float(uSamples)) * center.a;
+      float a = float(i) * cGoldenAngle;
+      sum += texture2D(uColorMap, min(uv + vec2(cos(a), sin(a)) * r * uCoCTexelSize, uCoCMaxUV)).rgb;
+    }
+
+    gl_FragColor = vec4(sum / float(uSamples), center.a);
+    return;
+  }
+
+  // Mixed tiles, a sample only counts if its own CoC reaches this pixel
+  for(int i = 1; i < uSamples; ++i)
+  {
+    float r = sqrt(float(i) / float(uSamples)) * maxCoC;
+    float a = float(i) * cGoldenAngle;
+    vec4 s = texture2D(uColorMap, min(uv + vec2(cos(a), sin(a)) * r * uCoCTexelSize, uCoCMaxUV));
+    float w = clamp(s.a - r + 1.0, 0.0, 1.0);
+
+    sum += s.rgb * w;
+    weight += w;
+  }
+
+  gl_FragColor = vec4(sum / weight, center.a);
+}
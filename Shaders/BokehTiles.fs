@@ -0,0 +1,35 @@
+/******************************************************************************/
+/*!
+\file   BokehTiles.fs
+\par    Course: CS370
+\brief  
+  Smallest and largest circle of confusion of every tile of the half
+  resolution image. One fragment per tile
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap; // half resolution color and CoC
+
+uniform int uTileSize;
+uniform vec2 uCoCTexelSize; // 1 / size of the CoC target
+uniform vec2 uCoCMaxUV;     // part of the CoC target that holds the image
+
+void main(void)
+{
+  vec2 first = floor(gl_FragCoord.xy) * float(uTileSize) + 0.5;
+  float minCoC = 1000.0;
+  float maxCoC = 0.0;
+
+  for(int y = 0; y < uTileSize; ++y)
+  {
+    for(int x = 0; x < uTileSize; ++x)
+    {
+      vec2 coord = min((first + vec2(x, y)) * uCoCTexelSize, uCoCMaxUV);
+      float coc = texture2D(uColorMap, coord).a;
+      minCoC = min(minCoC, coc);
+      maxCoC = max(maxCoC, coc);
+    }
+  }
+
+  gl_FragColor = vec4(minCoC, maxCoC, 0.0, 1.0);
+}
@@ -0,0 +1,46 @@
+/******************************************************************************/
+/*!
+\file   Combine.fs
+\par    Course: CS370
+\brief  
+  Combines the output of an effect with the image the effect was applied to.
+  Used for effects whose shader cannot combine by itself.
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap;    // output of the effect, covers the whole texture
+uniform sampler2D uOriginalMap; // image before the effect
+
+varying vec2 vTexCoord;
+
+uniform vec2 uUVScale;
+
+uniform int uCombineMode;
+uniform float uOpacity;
+
+// Keep in sync with PostProcessingCombineModes and the copies in the other
+// shaders that combine with their input themselves
+vec4 PostProCombine(vec4 base, vec4 result)
+{
+  vec4 blended = result;
+
+  if(uCombineMode == 1)      // NORMAL
+    blended = mix(base, result, result.a);
+  else if(uCombineMode == 2) // ADD
+    blended = base + result;
+  else if(uCombineMode == 3) // SUB
+    blended = base - result;
+  else if(uCombineMode == 4) // MULTIPLY
+    blended = base * result;
+  else if(uCombineMode == 5) // SCREEN
+    blended = 1.0 - (1.0 - clamp(base, 0.0, 1.0)) * (1.0 - clamp(result, 0.0, 1.0));
+
+  // REPLACE ignores the opacity, LERP is just the opacity
+  return uCombineMode == 0 ? result : mix(base, blended, uOpacity);
+}
+
+void main(void)
+{
+  vec2 coord = vTexCoord * uUVScale;
+  gl_FragColor = PostProCombine(texture2D(uOriginalMap, coord), texture2D(uColorMap, coord));
+}
@@ -0,0 +1,44 @@
+/******************************************************************************/
+/*!
+\file   Convolution.fs
+\par    Course: CS370
+\brief  
+  Weighted sum of taps around the pixel. Runs the whole kernel, or one
+  pass of a rank-1 term of it
+*/
+/******************************************************************************/
+
+// Keep in sync with Convolution::sMaxTaps
+#define MAX_TAPS 128
+
+uniform sampler2D uColorMap; // image, or the horizontal pass of the term
+uniform sampler2D uPass0;    // terms before this one, added when uAccumulate is set
+
+varying vec2 vTexCoord;
+uniform vec2 uUVScale;  // part of uColorMap that holds the image
+uniform vec2 uTexelSize;
+
+uniform vec4 uTaps[MAX_TAPS]; // xy offset in texels, z weight
+uniform int uTapCount;
+uniform bool uAccumulate;
+uniform vec4 uBias;
+
+void main(void)
+{
+  vec2 center = vTexCoord * uUVScale;
+  vec4 sum = vec4(0.0);
+
+  for(int i = 0; i < MAX_TAPS; ++i)
+  {
+    if(i >= uTapCount)
+      break;
+
+    vec2 uv = clamp(center + uTaps[i].xy * uTexelSize, vec2(0.0), uUVScale - 0.5 * uTexelSize);
+    sum += texture2D(uColorMap, uv) * uTaps[i].z;
+  }
+
+  if(uAccumulate)
+    sum += texture2D(uPass0, center);
+
+  gl_FragColor = sum + uBias;
+}
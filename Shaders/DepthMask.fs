@@ -0,0 +1,27 @@
+/******************************************************************************/
+/*!
+\file   DepthMask.fs
+\par    Course: CS370
+\brief  
+  Keeps the pixels whose depth lies within the range. Only writes stencil
+*/
+/******************************************************************************/
+
+uniform sampler2D uShadowMap; // depth buffer, always covers the whole view
+
+varying vec2 vTexCoord;
+
+uniform float uMinDepth;
+uniform float uMaxDepth;
+
+void main(void)
+{
+  float depth = texture2D(uShadowMap, vTexCoord).r;
+
+  if(depth < uMinDepth || depth > uMaxDepth)
+  {
+    discard;
+  }
+
+  gl_FragColor = vec4(0.0);
+}
@@ -0,0 +1,56 @@
+/******************************************************************************/
+/*!
+\file   DepthPyramid.fs
+\par    Course: CS370
+\brief  
+  One level of the depth pyramid. Average depth in r, minimum in g and
+  maximum in b of the source texels below this texel
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap; // level before, or the depth buffer
+
+uniform vec2 uSourceSize;  // in texels
+uniform bool uFirstLevel;  // the depth buffer only holds depth in x
+
+void main(void)
+{
+  vec2 pixel = floor(gl_FragCoord.xy);
+  vec2 size = max(floor(uSourceSize / 2.0), vec2(1.0));
+  vec2 first = pixel * 2.0;
+
+  // The last texel of an odd sized source takes the extra row and column
+  vec2 last = first + 1.0;
+  last.x += (pixel.x == size.x - 1.0) ? uSourceSize.x - size.x * 2.0 : 0.0;
+  last.y += (pixel.y == size.y - 1.0) ? uSourceSize.y - size.y * 2.0 : 0.0;
+
+  float average = 0.0;
+  float minDepth = 1.0;
+  float maxDepth = 0.0;
+  float count = 0.0;
+
+  for(int y = 0; y < 3; ++y)
+  {
+    for(int x = 0; x < 3; ++x)
+    {
+      vec2 texel = first + vec2(float(x), float(y));
+      if(texel.x > last.x || texel.y > last.y)
+      {
+        continue;
+      }
+
+      vec3 tap = texture2D(uColorMap, (min(texel, uSourceSize - 1.0) + 0.5) / uSourceSize).rgb;
+      if(uFirstLevel)
+      {
+        tap = tap.xxx;
+      }
+
+      average += tap.r;
+      minDepth = min(minDepth, tap.g);
+      maxDepth = max(maxDepth, tap.b);
+      count += 1.0;
+    }
+  }
+
+  gl_FragColor = vec4(average / count, minDepth, maxDepth, 1.0);
+}
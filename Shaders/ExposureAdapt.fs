@@ -0,0 +1,53 @@
+/******************************************************************************/
+/*!
+\file   ExposureAdapt.fs
+\par    Course: CS370
+\brief  
+  Average luminance between two percentiles of the histogram, turned into
+  an exposure and blended with last frame's. Exposure in r, the average
+  luminance in g
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap; // histogram, 64 bins of texel counts
+uniform sampler2D uPass0;    // last frame's exposure
+
+uniform float uMinLog;
+uniform float uMaxLog;
+uniform float uKey;
+uniform float uMinExposure;
+uniform float uMaxExposure;
+uniform float uLowPercent;
+uniform float uHighPercent;
+uniform float uAdaptation; // how far to move towards the new exposure this frame
+uniform float uInvCount;   // one over the number of texels in the histogram
+
+void main(void)
+{
+  float below = 0.0;
+  float logSum = 0.0;
+  float weightSum = 0.0;
+
+  for(int i = 0; i < 64; ++i)
+  {
+    float share = texture2D(uColorMap, vec2((float(i) + 0.5) / 64.0, 0.5)).r * uInvCount;
+
+    // Part of this bin that lies between the percentiles
+    float inside = clamp(below + share, uLowPercent, uHighPercent) - clamp(below, uLowPercent, uHighPercent);
+    below += share;
+
+    logSum += inside * mix(uMinLog, uMaxLog, (float(i) + 0.5) / 64.0);
+    weightSum += inside;
+  }
+
+  float average = exp2(weightSum > 0.0 ? logSum / weightSum : 0.0);
+  float exposure = clamp(uKey / average, uMinExposure, uMaxExposure);
+
+  float previous = texture2D(uPass0, vec2(0.5)).r;
+  if(previous > 0.0)
+  {
+    exposure = mix(previous, exposure, uAdaptation);
+  }
+
+  gl_FragColor = vec4(exposure, average, 0.0, 1.0);
+}
@@ -0,0 +1,14 @@
+/******************************************************************************/
+/*!
+\file   ExposureHistogram.fs
+\par    Course: CS370
+\brief  
+  Counts one texel in its bin. Whole counts stay exact in a float target,
+  the adapt pass turns them into shares
+*/
+/******************************************************************************/
+
+void main(void)
+{
+  gl_FragColor = vec4(1.0);
+}
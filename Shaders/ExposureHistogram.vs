@@ -0,0 +1,25 @@
+/******************************************************************************/
+/*!
+\file   ExposureHistogram.vs
+\par    Course: CS370
+\brief  
+  One point per luminance texel, moved onto the texel of its histogram bin
+*/
+/******************************************************************************/
+
+attribute vec2 aTexCoord;
+
+uniform sampler2D uColorMap; // log2 luminance
+
+uniform float uMinLog;
+uniform float uMaxLog;
+uniform float uBins;
+
+void main(void)
+{
+  float logLuminance = texture2DLod(uColorMap, aTexCoord, 0.0).r;
+  float bin = clamp(floor((logLuminance - uMinLog) / (uMaxLog - uMinLog) * uBins), 0.0, uBins - 1.0);
+
+  gl_Position = vec4((bin + 0.5) / uBins * 2.0 - 1.0, 0.0, 0.0, 1.0);
+  gl_PointSize = 1.0;
+}
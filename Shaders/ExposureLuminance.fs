@@ -0,0 +1,35 @@
+/******************************************************************************/
+/*!
+\file   ExposureLuminance.fs
+\par    Course: CS370
+\brief  
+  Reduces the scene to a small grid of log2 luminance values for the
+  exposure histogram. Every texel averages a 4x4 grid of taps over the part
+  of the scene it covers
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap; // scene
+
+varying vec2 vTexCoord;
+uniform vec2 uUVScale; // part of uColorMap that holds the image
+
+void main(void)
+{
+  // Each output texel covers 1/64 of the image in both directions
+  vec2 cell = floor(vTexCoord * 64.0);
+  float logSum = 0.0;
+
+  for(int y = 0; y < 4; ++y)
+  {
+    for(int x = 0; x < 4; ++x)
+    {
+      vec2 coord = (cell + (vec2(float(x), float(y)) + 0.5) / 4.0) / 64.0;
+      vec3 color = texture2D(uColorMap, coord * uUVScale).rgb;
+      float luminance = dot(color, vec3(0.2126, 0.7152, 0.0722));
+      logSum += log2(max(luminance, 0.00001));
+    }
+  }
+
+  gl_FragColor = vec4(logSum / 16.0, 0.0, 0.0, 1.0);
+}
@@ -0,0 +1,145 @@
+/******************************************************************************/
+/*!
+\file   FXAA.fs
+\par    Course: CS370
+\brief  
+  Fast approximate anti-aliasing, after FXAA 3.11 quality. Finds the edge
+  through the pixel from luminance, walks along it to both ends and
+  resamples across it by how far the pixel is from the nearer end
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap;
+uniform float uMapWidth;
+uniform float uMapHeight;
+
+varying vec2 vTexCoord;
+uniform vec2 uUVScale; // part of uColorMap that holds the image
+
+uniform float uSubpixel;         // how much of the subpixel aliasing is removed, 0 to 1
+uniform float uEdgeThreshold;    // local contrast needed for an edge
+uniform float uEdgeThresholdMin; // no edges in darks below this contrast
+
+#define SEARCH_STEPS 10
+
+// Stop at the centre of the last texel, the one next to it may hold stale data
+vec2 ClampUV(vec2 uv)
+{
+  return min(uv, uUVScale - 0.5 / vec2(uMapWidth, uMapHeight));
+}
+
+float Luma(vec2 uv)
+{
+  return dot(texture2D(uColorMap, ClampUV(uv)).rgb, vec3(0.299, 0.587, 0.114));
+}
+
+void main(void)
+{
+  vec2 texel = vec2(1.0 / uMapWidth, 1.0 / uMapHeight);
+  vec2 uv = vTexCoord * uUVScale;
+  vec4 color = texture2D(uColorMap, uv);
+
+  float lumaM = dot(color.rgb, vec3(0.299, 0.587, 0.114));
+  float lumaN = Luma(uv + vec2(0.0, texel.y));
+  float lumaS = Luma(uv - vec2(0.0, texel.y));
+  float lumaE = Luma(uv + vec2(texel.x, 0.0));
+  float lumaW = Luma(uv - vec2(texel.x, 0.0));
+
+  float lumaMax = max(max(max(lumaN, lumaS), max(lumaE, lumaW)), lumaM);
+  float lumaMin = min(min(min(lumaN, lumaS), min(lumaE, lumaW)), lumaM);
+  float range = lumaMax - lumaMin;
+
+  // Flat or dark, nothing to do
+  if(range < max(uEdgeThresholdMin, lumaMax * uEdgeThreshold))
+  {
+    gl_FragColor = color;
+    return;
+  }
+
+  float lumaNE = Luma(uv + texel);
+  float lumaSW = Luma(uv - texel);
+  float lumaNW = Luma(uv + vec2(-texel.x, texel.y));
+  float lumaSE = Luma(uv + vec2(texel.x, -texel.y));
+
+  // Subpixel aliasing, how much the pixel stands out from the average around it
+  float lumaAverage = (2.0 * (lumaN + lumaS + lumaE + lumaW) + lumaNE + lumaSW + lumaNW + lumaSE) / 12.0;
+  float subpixel = smoothstep(0.0, 1.0, clamp(abs(lumaAverage - lumaM) / range, 0.0, 1.0));
+  subpixel = subpixel * subpixel * uSubpixel;
+
+  // A horizontal edge changes most along y
+  float edgeHorizontal = abs(lumaNW + lumaSW - 2.0 * lumaW) + 2.0 * abs(lumaN + lumaS - 2.0 * lumaM) + abs(lumaNE + lumaSE - 2.0 * lumaE);
+  float edgeVertical = abs(lumaNW + lumaNE - 2.0 * lumaN) + 2.0 * abs(lumaW + lumaE - 2.0 * lumaM) + abs(lumaSW + lumaSE - 2.0 * lumaS);
+  bool horizontal = edgeHorizontal >= edgeVertical;
+
+  // Side of the pixel the edge is on
+  float luma1 = horizontal ? lumaS : lumaW;
+  float luma2 = horizontal ? lumaN : lumaE;
+  float gradient1 = abs(luma1 - lumaM);
+  float gradient2 = abs(luma2 - lumaM);
+  bool side1 = gradient1 >= gradient2;
+
+  float stepLength = horizontal ? texel.y : texel.x;
+  float lumaLocal = side1 ? luma1 : luma2;
+  float gradientScaled = 0.25 * max(gradient1, gradient2);
+  if(side1)
+    stepLength = -stepLength;
+
+  float lumaEdge = 0.5 * (lumaM + lumaLocal);
+
+  // Start on the edge, half a texel towards the other side
+  vec2 edgeUV = uv;
+  if(horizontal)
+    edgeUV.y += stepLength * 0.5;
+  else
+    edgeUV.x += stepLength * 0.5;
+
+  vec2 offset = horizontal ? vec2(texel.x, 0.0) : vec2(0.0, texel.y);
+  vec2 uv1 = edgeUV - offset;
+  vec2 uv2 = edgeUV + offset;
+  float end1 = Luma(uv1) - lumaEdge;
+  float end2 = Luma(uv2) - lumaEdge;
+  bool reached1 = abs(end1) >= gradientScaled;
+  bool reached2 = abs(end2) >= gradientScaled;
+
+  // Walk both ways until the luma along the edge changes, in growing steps
+  float stepScale = 1.0;
+  for(int i = 0; i < SEARCH_STEPS; ++i)
+  {
+    if(reached1 && reached2)
+      break;
+
+    stepScale = i < 2 ? 1.0 : (i < 6 ? 1.5 : (i < 8 ? 2.0 : 4.0));
+
+    if(!reached1)
+    {
+      uv1 -= offset * stepScale;
+      end1 = Luma(uv1) - lumaEdge;
+      reached1 = abs(end1) >= gradientScaled;
+    }
+    if(!reached2)
+    {
+      uv2 += offset * stepScale;
+      end2 = Luma(uv2) - lumaEdge;
+      reached2 = abs(end2) >= gradientScaled;
+    }
+  }
+
+  float distance1 = horizontal ? uv.x - uv1.x : uv.y - uv1.y;
+  float distance2 = horizontal ? uv2.x - uv.x : uv2.y - uv.y;
+  bool nearer1 = distance1 < distance2;
+  float distanceNear = min(distance1, distance2);
+
+  // Only move when the nearer end goes the other way than the pixel
+  bool lumaMSmaller = lumaM < lumaEdge;
+  bool correct = ((nearer1 ? end1 : end2) < 0.0) != lumaMSmaller;
+  float pixelOffset = correct ? 0.5 - distanceNear / (distance1 + distance2) : 0.0;
+
+  float finalOffset = max(pixelOffset, subpixel);
+  vec2 finalUV = uv;
+  if(horizontal)
+    finalUV.y += finalOffset * stepLength;
+  else
+    finalUV.x += finalOffset * stepLength;
+
+  gl_FragColor = vec4(texture2D(uColorMap, ClampUV(finalUV)).rgb, color.a);
+}
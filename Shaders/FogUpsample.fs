@@ -0,0 +1,46 @@
+/******************************************************************************/
+/*!
+\file   FogUpsample.fs
+\par    Course: CS370
+\brief  
+  Brings the reduced resolution fog back to full resolution. Low resolution
+  texels at a different depth than the pixel get little weight, so the fog
+  does not bleed over silhouettes
+*/
+/******************************************************************************/
+
+varying vec2 vTexCoord;
+
+uniform sampler2D uShadowMap; // Full resolution depth
+uniform sampler2D uPass1;     // Fog factor in r, its depth in g
+
+uniform vec2 uLowResSize;
+uniform vec2 uLowResRect; // part of uPass1 that holds the fog, in texels
+
+float FogTap(vec2 uv, float depth, float bilinear, inout float weightSum)
+{
+  vec2 tap = texture2D(uPass1, min(uv, (uLowResRect - 0.5) / uLowResSize)).rg;
+  float weight = bilinear / (0.0001 + abs(depth - tap.g));
+  weightSum += weight;
+  return tap.r * weight;
+}
+
+void main(void)
+{
+  float depth = texture2D(uShadowMap, vTexCoord.st).x;
+
+  // The four low resolution texels around this pixel
+  vec2 texel = vTexCoord.st * uLowResRect - 0.5;
+  vec2 base = floor(texel);
+  vec2 f = texel - base;
+  vec2 uv = (base + 0.5) / uLowResSize;
+  vec2 texelStep = 1.0 / uLowResSize;
+
+  float weightSum = 0.0;
+  float fog = FogTap(uv, depth, (1.0 - f.x) * (1.0 - f.y), weightSum);
+  fog += FogTap(uv + vec2(texelStep.x, 0.0), depth, f.x * (1.0 - f.y), weightSum);
+  fog += FogTap(uv + vec2(0.0, texelStep.y), depth, (1.0 - f.x) * f.y, weightSum);
+  fog += FogTap(uv + texelStep, depth, f.x * f.y, weightSum);
+
+  gl_FragColor = vec4(1.0, 1.0, 1.0, clamp(fog / max(weightSum, 0.00001), 0.0, 1.0));
+}
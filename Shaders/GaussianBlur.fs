@@ -1,63 +1,85 @@
-/******************************************************************************/
-/*!
-\file   GaussianBlur.fs
-\author Hoh Shi Chao
-\par    email: s.hoh\@digipen.edu
-\par    DigiPen login: s.hoh
-\par    Course: CS370
-\date   3/1/2013
-\brief  
-  Simple Gaussian Blur
-*/
-/******************************************************************************/
-
-#define KERNEL_SIZE 9
-
-// Gaussian kernel
-// 1 2 1
-// 2 4 2
-// 1 2 1	
-float kernel[KERNEL_SIZE];
-
-varying vec2 vTexCoord;
-
-uniform sampler2D uColorMap;
-uniform float uMapWidth;
-uniform float uMapHeight;
-
-float step_w = 1.0/uMapWidth;
-float step_h = 1.0/uMapHeight;
-
-vec2 offset[KERNEL_SIZE];
-
-uniform float uRadius;
-
-void main(void)
-{
-    int i = 0;
-    vec4 sum = vec4(0.0);
-   
-   offset[0] = vec2(-step_w, -step_h);
-   offset[1] = vec2(0.0, -step_h);
-   offset[2] = vec2(step_w, -step_h);
-   
-   offset[3] = vec2(-step_w, 0.0);
-   offset[4] = vec2(0.0, 0.0);
-   offset[5] = vec2(step_w, 0.0);
-   
-   offset[6] = vec2(-step_w, step_h);
-   offset[7] = vec2(0.0, step_h);
-   offset[8] = vec2(step_w, step_h);
-   
-   kernel[0] = 1.0/16.0; 	kernel[1] = 2.0/16.0;	kernel[2] = 1.0/16.0;
-   kernel[3] = 2.0/16.0;	kernel[4] = 4.0/16.0;	kernel[5] = 2.0/16.0;
-   kernel[6] = 1.0/16.0;   	kernel[7] = 2.0/16.0;	kernel[8] = 1.0/16.0;
-   
-   for( i=0; i<KERNEL_SIZE; i++ )
-   {
-    vec4 tmp = texture2D(uColorMap, vTexCoord.xy + offset[i] * uRadius);
-    sum += tmp * kernel[i];
-   }
-
-   gl_FragColor = sum;
-}
\ No newline at end of file
+/******************************************************************************/
+/*!
+\file   GaussianBlur.fs
+\author Hoh Shi Chao
+\par    email: s.hoh\@digipen.edu
+\par    DigiPen login: s.hoh
+\par    Course: CS370
+\date   3/1/2013
+\brief  
+  Simple Gaussian Blur
+*/
+/******************************************************************************/
+
+varying vec2 vTexCoord;
+
+uniform sampler2D uColorMap;
+uniform float uMapWidth;
+uniform float uMapHeight;
+
+uniform float uRadius;
+uniform vec2 uUVScale; // part of uColorMap that holds the image
+
+uniform int uCombineMode;
+uniform float uOpacity;
+
+// Keep in sync with PostProcessingCombineModes and the copies in the other
+// shaders that combine with their input themselves
+vec4 PostProCombine(vec4 base, vec4 result)
+{
+  vec4 blended = result;
+
+  if(uCombineMode == 1)      // NORMAL
+    blended = mix(base, result, result.a);
+  else if(uCombineMode == 2) // ADD
+    blended = base + result;
+  else if(uCombineMode == 3) // SUB
+    blended = base - result;
+  else if(uCombineMode == 4) // MULTIPLY
+    blended = base * result;
+  else if(uCombineMode == 5) // SCREEN
+    blended = 1.0 - (1.0 - clamp(base, 0.0, 1.0)) * (1.0 - clamp(result, 0.0, 1.0));
+
+  // REPLACE ignores the opacity, LERP is just the opacity
+  return uCombineMode == 0 ? result : mix(base, blended, uOpacity);
+}
+
+vec4 Tap(vec2 center, vec2 texelStep, float x, float y)
+{
+  // Texels past the render rect hold stale data, bilinear taps must not reach them
+  vec2 texelSize = vec2(1.0 / uMapWidth, 1.0 / uMapHeight);
+  return texture2D(uColorMap, min(center + vec2(x, y) * texelStep, uUVScale - 0.5 * texelSize));
+}
+
+void main(void)
+{
+  vec2 texelSize = vec2(1.0 / uMapWidth, 1.0 / uMapHeight);
+  vec2 center = vTexCoord.xy * uUVScale;
+  vec4 base = texture2D(uColorMap, center);
+  vec4 sum;
+
+  // Gaussian kernel, written out so the weights and offsets are constants
+  // 1 2 1
+  // 2 4 2
+  // 1 2 1
+  if(uRadius == 1.0)
+  {
+    // A filtered tap on the corner between 4 texels averages them. The 2x2
+    // boxes of the four diagonal corners overlap into exactly this kernel
+    sum = (Tap(center, texelSize, -0.5, -0.5) + Tap(center, texelSize, 0.5, -0.5)
+         + Tap(center, texelSize, -0.5, 0.5) + Tap(center, texelSize, 0.5, 0.5)) * 0.25;
+  }
+  else
+  {
+    // Taps further apart than a texel, every one on its own
+    vec2 texelStep = texelSize * uRadius;
+    vec4 corners = Tap(center, texelStep, -1.0, -1.0) + Tap(center, texelStep, 1.0, -1.0)
+                 + Tap(center, texelStep, -1.0, 1.0) + Tap(center, texelStep, 1.0, 1.0);
+    vec4 edges = Tap(center, texelStep, 0.0, -1.0) + Tap(center, texelStep, -1.0, 0.0)
+               + Tap(center, texelStep, 1.0, 0.0) + Tap(center, texelStep, 0.0, 1.0);
+
+    sum = (corners + 2.0 * edges + 4.0 * base) * (1.0 / 16.0);
+  }
+
+  gl_FragColor = PostProCombine(base, sum);
+}
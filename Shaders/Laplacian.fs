@@ -0,0 +1,40 @@
+/******************************************************************************/
+/*!
+\file   Laplacian.fs
+\par    Course: CS370
+\brief  
+  Laplacian edge detection out of five taps instead of nine texels
+*/
+/******************************************************************************/
+
+varying vec2 vTexCoord;
+
+uniform sampler2D uColorMap;
+uniform float uMapWidth;
+uniform float uMapHeight;
+
+uniform vec2 uUVScale; // part of uColorMap that holds the image
+
+vec4 Tap(vec2 center, vec2 texelSize, float x, float y)
+{
+  return texture2D(uColorMap, min(center + vec2(x, y) * texelSize, uUVScale - 0.5 * texelSize));
+}
+
+void main(void)
+{
+  vec2 texelSize = vec2(1.0 / uMapWidth, 1.0 / uMapHeight);
+  vec2 center = vTexCoord.xy * uUVScale;
+  vec4 base = texture2D(uColorMap, center);
+
+  // Filtered taps 2/3 of a texel out weight the three texels of a row 2/3
+  // each, four of them weight all nine texels of the 3x3 block 4/9
+  //  1  1  1
+  //  1 -8  1  =  3x3 sum - 9 * center
+  //  1  1  1
+  vec4 block = Tap(center, texelSize, -2.0 / 3.0, -2.0 / 3.0) + Tap(center, texelSize, 2.0 / 3.0, -2.0 / 3.0)
+             + Tap(center, texelSize, -2.0 / 3.0, 2.0 / 3.0) + Tap(center, texelSize, 2.0 / 3.0, 2.0 / 3.0);
+
+  vec3 laplacian = block.rgb * (9.0 / 4.0) - base.rgb * 9.0;
+
+  gl_FragColor = vec4(abs(laplacian), 1.0);
+}
@@ -0,0 +1,28 @@
+/******************************************************************************/
+/*!
+\file   LuminanceAdaptive.fs
+\par    Course: CS370
+\brief  
+  Bright pass for bloom with the threshold relative to the automatic
+  exposure, so the same parts bloom in dark and bright scenes
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap; // image
+uniform sampler2D uPass3;    // exposure in r
+
+varying vec2 vTexCoord;
+uniform vec2 uUVScale; // part of uColorMap that holds the image
+
+uniform float uThreshold; // after exposure, 1 is white
+
+void main(void)
+{
+  vec3 color = texture2D(uColorMap, vTexCoord * uUVScale).rgb;
+  float exposure = texture2D(uPass3, vec2(0.5)).r;
+
+  float luminance = dot(color, vec3(0.2126, 0.7152, 0.0722)) * exposure;
+  float bright = max(luminance - uThreshold, 0.0) / max(luminance, 0.0001);
+
+  gl_FragColor = vec4(color * bright, 1.0);
+}
@@ -0,0 +1,42 @@
+/******************************************************************************/
+/*!
+\file   MSAAResolve.fs
+\par    Course: CS370
+\brief  
+  Resolves the multisampled scene into the original target of the stack.
+  Every sample is fetched on its own, optionally weighted so that bright
+  samples do not outshine the dark ones along HDR edges
+*/
+/******************************************************************************/
+
+#extension GL_ARB_texture_multisample : require
+#extension GL_EXT_gpu_shader4 : require
+
+uniform sampler2DMS uSceneMap; // multisampled scene
+
+uniform int uSampleCount;
+uniform vec2 uScale;           // scene pixels per render rect pixel
+uniform bool uTonemapResolve;  // averages the samples as if tonemapped
+
+void main(void)
+{
+  // Nearest scene pixel, the render rect can be smaller than the scene
+  ivec2 pixel = ivec2(floor(gl_FragCoord.xy * uScale));
+
+  vec4 sum = vec4(0.0);
+  float weightSum = 0.0;
+
+  for(int i = 0; i < uSampleCount; ++i)
+  {
+    vec4 tap = texelFetch(uSceneMap, pixel, i);
+
+    // Weighted by 1 / (1 + brightest channel), the average then matches the
+    // average of the Reinhard tonemapped samples much closer
+    float weight = uTonemapResolve ? 1.0 / (1.0 + max(tap.r, max(tap.g, tap.b))) : 1.0;
+
+    sum += tap * weight;
+    weightSum += weight;
+  }
+
+  gl_FragColor = sum / weightSum;
+}
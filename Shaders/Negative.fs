@@ -1,10 +1,35 @@
-uniform sampler2D uColorMap;
-
-varying vec2 vTexCoord;
-
-void main (void)
-{
-  vec4  color = texture2D(uColorMap, vTexCoord);
-  
-  gl_FragColor = vec4(1.0 - color.r, 1.0 - color.g, 1.0 - color.b, color.a);
+uniform sampler2D uColorMap;
+
+varying vec2 vTexCoord;
+uniform vec2 uUVScale; // part of uColorMap that holds the image
+
+uniform int uCombineMode;
+uniform float uOpacity;
+
+// Keep in sync with PostProcessingCombineModes and the copies in the other
+// shaders that combine with their input themselves
+vec4 PostProCombine(vec4 base, vec4 result)
+{
+  vec4 blended = result;
+
+  if(uCombineMode == 1)      // NORMAL
+    blended = mix(base, result, result.a);
+  else if(uCombineMode == 2) // ADD
+    blended = base + result;
+  else if(uCombineMode == 3) // SUB
+    blended = base - result;
+  else if(uCombineMode == 4) // MULTIPLY
+    blended = base * result;
+  else if(uCombineMode == 5) // SCREEN
+    blended = 1.0 - (1.0 - clamp(base, 0.0, 1.0)) * (1.0 - clamp(result, 0.0, 1.0));
+
+  // REPLACE ignores the opacity, LERP is just the opacity
+  return uCombineMode == 0 ? result : mix(base, blended, uOpacity);
+}
+
+void main (void)
+{
+  vec4  color = texture2D(uColorMap, vTexCoord * uUVScale);
+  
+  gl_FragColor = PostProCombine(color, vec4(1.0 - color.r, 1.0 - color.g, 1.0 - color.b, color.a));
 }
\ No newline at end of file
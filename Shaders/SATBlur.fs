@@ -0,0 +1,89 @@
+/******************************************************************************/
+/*!
+\file   SATBlur.fs
+\par    Course: CS370
+\brief  
+  Box blur of any size out of the summed-area table, four corners per pixel.
+  The radius can come from depth, so every pixel gets its own
+*/
+/******************************************************************************/
+
+#extension GL_EXT_gpu_shader4 : require
+
+uniform sampler2D uColorMap;  // summed-area table, see SATPrefix.fs
+uniform sampler2D uPass0;     // the image itself, for boxes smaller than a pixel
+uniform sampler2D uPass1;     // mean taken off the image when the table was built
+uniform sampler2D uShadowMap; // depth buffer, always covers the whole view
+
+varying vec2 vTexCoord;
+
+uniform vec2 uImageSize;  // render rect in pixels
+
+uniform float uRadius;    // in pixels, fractions blend in the edge texels
+uniform bool uDepthRadius;
+uniform float uFocusDepth;
+uniform float uFocusRange;
+
+// Sum of the image texels below and left of the corner. Between corners the
+// table is interpolated, which weights the edge texels by the fraction. Done
+// here on the four texels around the corner, the filtering hardware keeps only
+// a few bits of the fraction and the sums are large
+vec4 Sum(vec2 corner)
+{
+  vec2 lo = floor(corner);
+  vec2 hi = min(lo + 1.0, uImageSize);
+  vec2 f = corner - lo;
+
+  vec4 bottom = mix(texelFetch2D(uColorMap, ivec2(lo), 0), texelFetch2D(uColorMap, ivec2(hi.x, lo.y), 0), f.x);
+  vec4 top = mix(texelFetch2D(uColorMap, ivec2(lo.x, hi.y), 0), texelFetch2D(uColorMap, ivec2(hi), 0), f.x);
+  return mix(bottom, top, f.y);
+}
+
+void main(void)
+{
+  float radius = uRadius;
+  if(uDepthRadius)
+  {
+    float depth = texture2D(uShadowMap, vTexCoord).r;
+    radius *= min(abs(depth - uFocusDepth) / uFocusRange, 1.0);
+  }
+
+  vec2 pixel = floor(gl_FragCoord.xy);
+
+  // Up to a pixel each way the box only covers the 3x3 texels around the pixel,
+  // the outer ones by the radius. Reading them directly is exact, the table
+  // would subtract sums far larger than the result
+  if(radius < 1.0)
+  {
+    vec4 sum = vec4(0.0);
+    float weightSum = 0.0;
+
+    for(int y = -1; y <= 1; ++y)
+    {
+      for(int x = -1; x <= 1; ++x)
+      {
+        vec2 texel = pixel + vec2(float(x), float(y));
+        if(any(lessThan(texel, vec2(0.0))) || any(greaterThanEqual(texel, uImageSize)))
+        {
+          continue;
+        }
+
+        float weight = (x == 0 ? 1.0 : radius) * (y == 0 ? 1.0 : radius);
+        sum += texelFetch2D(uPass0, ivec2(texel), 0) * weight;
+        weightSum += weight;
+      }
+    }
+
+    gl_FragColor = sum / weightSum;
+    return;
+  }
+
+  // Corners of the box around the pixel, cut at the image edges
+  vec2 lo = clamp(pixel - radius, vec2(0.0), uImageSize);
+  vec2 hi = clamp(pixel + 1.0 + radius, vec2(0.0), uImageSize);
+
+  vec4 sum = Sum(hi) - Sum(vec2(lo.x, hi.y)) - Sum(vec2(hi.x, lo.y)) + Sum(lo);
+  float area = (hi.x - lo.x) * (hi.y - lo.y);
+
+  gl_FragColor = sum / area + texture2D(uPass1, vec2(0.5));
+}
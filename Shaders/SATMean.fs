@@ -0,0 +1,33 @@
+/******************************************************************************/
+/*!
+\file   SATMean.fs
+\par    Course: CS370
+\brief  
+  Mean of the image, drawn into a 1x1 target. The summed-area table sums the
+  image minus this, so the sums stay near 0 where floats are most precise
+*/
+/******************************************************************************/
+
+#extension GL_EXT_gpu_shader4 : require
+
+uniform sampler2D uColorMap; // the image
+
+uniform vec2 uImageSize;     // render rect in pixels
+
+void main(void)
+{
+  // A 16x16 grid of texels is plenty. The mean only has to be close, it is
+  // added back to the blurred result exactly
+  vec4 sum = vec4(0.0);
+
+  for(int y = 0; y < 16; ++y)
+  {
+    for(int x = 0; x < 16; ++x)
+    {
+      vec2 texel = floor((vec2(float(x), float(y)) + 0.5) / 16.0 * uImageSize);
+      sum += texelFetch2D(uColorMap, ivec2(texel), 0);
+    }
+  }
+
+  gl_FragColor = sum / 256.0;
+}
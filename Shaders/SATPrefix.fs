@@ -0,0 +1,44 @@
+/******************************************************************************/
+/*!
+\file   SATPrefix.fs
+\par    Course: CS370
+\brief  
+  One pass of the summed-area table. Adds 4 texels uStep apart, after
+  log4(size) passes along both axes every texel holds the sum of all image
+  texels below and left of it
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap; // pass before, or the image for the first pass
+uniform sampler2D uPass1;    // mean of the image, see SATMean.fs
+
+uniform vec2 uStep;        // in texels, along one axis
+uniform vec2 uSourceSize;  // size of uColorMap in texels
+uniform bool uFirstPass;   // uColorMap is the image, not the table
+
+// The table is one texel larger than the image. Row and column 0 are the
+// empty sums, so texel i holds the sum of the image texels before i
+vec4 Fetch(vec2 texel)
+{
+  if(uFirstPass)
+  {
+    texel -= vec2(1.0);
+    if(texel.x < 0.0 || texel.y < 0.0)
+      return vec4(0.0);
+    return texture2D(uColorMap, (texel + 0.5) / uSourceSize) - texture2D(uPass1, vec2(0.5));
+  }
+
+  if(texel.x < 0.0 || texel.y < 0.0)
+    return vec4(0.0);
+  return texture2D(uColorMap, (texel + 0.5) / uSourceSize);
+}
+
+void main(void)
+{
+  vec2 texel = floor(gl_FragCoord.xy);
+
+  gl_FragColor = Fetch(texel)
+               + Fetch(texel - uStep)
+               + Fetch(texel - uStep * 2.0)
+               + Fetch(texel - uStep * 3.0);
+}
@@ -0,0 +1,57 @@
+/******************************************************************************/
+/*!
+\file   SMAABlend.fs
+\par    Course: CS370
+\brief  
+  Last SMAA pass. Blends the pixel with its neighbours by the weights of
+  its own edges and the ones its right and upper neighbours found
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap; // image
+uniform sampler2D uPass0;    // blend weights, bottom edge in rg, left edge in ba
+
+uniform float uMapWidth;
+uniform float uMapHeight;
+
+varying vec2 vTexCoord;
+uniform vec2 uUVScale; // part of uColorMap that holds the image
+
+void main(void)
+{
+  vec2 texel = vec2(1.0 / uMapWidth, 1.0 / uMapHeight);
+  vec2 maxUV = uUVScale - texel * 0.5;
+  vec2 uv = vTexCoord * uUVScale;
+  vec2 uvUp = min(uv + vec2(0.0, texel.y), maxUV);
+  vec2 uvRight = min(uv + vec2(texel.x, 0.0), maxUV);
+  vec2 uvDown = max(uv - vec2(0.0, texel.y), texel * 0.5);
+  vec2 uvLeft = max(uv - vec2(texel.x, 0.0), texel * 0.5);
+
+  vec4 color = texture2D(uColorMap, uv);
+  vec4 weights = texture2D(uPass0, uv);
+
+  // The edge with the upper neighbour is that neighbour's bottom edge, the
+  // other side of it is its g. Same for the right neighbour's left edge
+  float down = weights.r;
+  float left = weights.b;
+  float up = uvUp.y < uv.y + texel.y * 0.5 ? 0.0 : texture2D(uPass0, uvUp).g;
+  float right = uvRight.x < uv.x + texel.x * 0.5 ? 0.0 : texture2D(uPass0, uvRight).a;
+
+  if(max(max(down, up), max(left, right)) < 0.00001)
+  {
+    gl_FragColor = color;
+    return;
+  }
+
+  // Only the stronger direction, like SMAA
+  if(max(down, up) >= max(left, right))
+  {
+    color = color * (1.0 - down - up) + texture2D(uColorMap, uvDown) * down + texture2D(uColorMap, uvUp) * up;
+  }
+  else
+  {
+    color = color * (1.0 - left - right) + texture2D(uColorMap, uvLeft) * left + texture2D(uColorMap, uvRight) * right;
+  }
+
+  gl_FragColor = color;
+}
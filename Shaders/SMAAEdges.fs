@@ -0,0 +1,59 @@
+/******************************************************************************/
+/*!
+\file   SMAAEdges.fs
+\par    Course: CS370
+\brief  
+  First SMAA pass. Luma edges with the left neighbour in r and with the one
+  below in g. Weak edges next to much stronger ones are dropped
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap;
+uniform float uMapWidth;
+uniform float uMapHeight;
+
+varying vec2 vTexCoord;
+uniform vec2 uUVScale; // part of uColorMap that holds the image
+
+uniform float uThreshold;
+
+vec2 sTexel;
+
+float Luma(vec2 uv, float x, float y)
+{
+  vec2 maxUV = uUVScale - sTexel * 0.5;
+  return dot(texture2D(uColorMap, clamp(uv + vec2(x, y) * sTexel, sTexel * 0.5, maxUV)).rgb, vec3(0.2126, 0.7152, 0.0722));
+}
+
+void main(void)
+{
+  sTexel = vec2(1.0 / uMapWidth, 1.0 / uMapHeight);
+  vec2 uv = vTexCoord * uUVScale;
+
+  float luma = Luma(uv, 0.0, 0.0);
+  float lumaLeft = Luma(uv, -1.0, 0.0);
+  float lumaBottom = Luma(uv, 0.0, -1.0);
+
+  vec2 delta = abs(luma - vec2(lumaLeft, lumaBottom));
+  vec2 edges = step(uThreshold, delta);
+
+  if(edges.x + edges.y == 0.0)
+  {
+    gl_FragColor = vec4(0.0);
+    return;
+  }
+
+  // Local contrast adaptation, the largest change around the pixel
+  float lumaRight = Luma(uv, 1.0, 0.0);
+  float lumaTop = Luma(uv, 0.0, 1.0);
+  float lumaLeftLeft = Luma(uv, -2.0, 0.0);
+  float lumaBottomBottom = Luma(uv, 0.0, -2.0);
+
+  vec2 maxDelta = max(delta, abs(luma - vec2(lumaRight, lumaTop)));
+  maxDelta = max(maxDelta, abs(vec2(lumaLeft, lumaBottom) - vec2(lumaLeftLeft, lumaBottomBottom)));
+  float finalDelta = max(maxDelta.x, maxDelta.y);
+
+  edges *= step(finalDelta, 2.0 * delta);
+
+  gl_FragColor = vec4(edges, 0.0, 0.0);
+}
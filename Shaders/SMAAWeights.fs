@@ -0,0 +1,111 @@
+/******************************************************************************/
+/*!
+\file   SMAAWeights.fs
+\par    Course: CS370
+\brief  
+  Second SMAA pass. For every edge of the pixel, finds how far the edge
+  runs both ways and which way the edges crossing its ends go, and looks up
+  how much of the pixels on both sides the silhouette line covers. Bottom
+  edge weights go into rg, left edge weights into ba
+*/
+/******************************************************************************/
+
+// Keep in sync with PPSMAA::sMaxDistance
+#define MAX_DISTANCE 16
+// Every search step reads two pixels
+#define SEARCH_STEPS 8
+
+uniform sampler2D uColorMap; // edges, left in r and bottom in g
+uniform sampler2D uPass0;    // area texture, see PPSMAA::PrepareHost
+uniform sampler2D uPass1;    // search texture
+
+uniform float uMapWidth;
+uniform float uMapHeight;
+uniform vec2 uRectSize; // render rect in pixels
+
+vec2 sSize;
+
+vec4 Edges(vec2 pixel)
+{
+  if(pixel.x < 0.0 || pixel.y < 0.0 || pixel.x >= uRectSize.x || pixel.y >= uRectSize.y)
+    return vec4(0.0);
+  return texture2D(uColorMap, (pixel + 0.5) / sSize);
+}
+
+// Filtered between two pixels with 3/4 on the nearer one. The search
+// texture turns that into how many of the two continue the edge
+float Search(vec2 position, bool bottomEdge)
+{
+  vec4 edges = texture2D(uColorMap, position / sSize);
+  float value = bottomEdge ? edges.g : edges.r;
+  return floor(texture2D(uPass1, vec2((floor(value * 4.0 + 0.5) + 0.5) / 8.0, 0.5)).r * 2.0 + 0.5);
+}
+
+// Pixels before the edge ends along the direction, at most MAX_DISTANCE - 1
+float SearchDistance(vec2 pixel, vec2 direction, bool bottomEdge)
+{
+  float distance = 0.0;
+
+  for(int i = 0; i < SEARCH_STEPS; ++i)
+  {
+    // 1/4 past the center of the nearer pixel, towards the further one
+    vec2 position = pixel + 0.5 + direction * (float(i) * 2.0 + 1.25);
+    float count = Search(position, bottomEdge);
+    distance += count;
+
+    if(count < 2.0)
+      break;
+  }
+
+  return min(distance, float(MAX_DISTANCE - 1));
+}
+
+// 1 for a crossing edge on the pixel's side, 2 on the other side
+float Crossing(float onSide, float otherSide)
+{
+  return step(0.5, onSide) + 2.0 * step(0.5, otherSide);
+}
+
+vec2 Area(float distance1, float distance2, float crossing1, float crossing2)
+{
+  vec2 texel = vec2(crossing1, crossing2) * float(MAX_DISTANCE) + vec2(distance1, distance2) + 0.5;
+  return texture2D(uPass0, texel / float(MAX_DISTANCE * 4)).rg;
+}
+
+void main(void)
+{
+  sSize = vec2(uMapWidth, uMapHeight);
+  vec2 pixel = floor(gl_FragCoord.xy);
+  vec4 edges = Edges(pixel);
+  vec4 weights = vec4(0.0);
+
+  // Edge with the pixel below, runs along x
+  if(edges.g > 0.5)
+  {
+    float left = min(SearchDistance(pixel, vec2(-1.0, 0.0), true), pixel.x);
+    float right = min(SearchDistance(pixel, vec2(1.0, 0.0), true), uRectSize.x - 1.0 - pixel.x);
+
+    vec2 leftEnd = vec2(pixel.x - left, pixel.y);
+    vec2 rightEnd = vec2(pixel.x + right + 1.0, pixel.y);
+    float crossing1 = Crossing(Edges(leftEnd).r, Edges(leftEnd - vec2(0.0, 1.0)).r);
+    float crossing2 = Crossing(Edges(rightEnd).r, Edges(rightEnd - vec2(0.0, 1.0)).r);
+
+    weights.rg = Area(left, right, crossing1, crossing2);
+  }
+
+  // Edge with the pixel to the left, runs along y
+  if(edges.r > 0.5)
+  {
+    float down = min(SearchDistance(pixel, vec2(0.0, -1.0), false), pixel.y);
+    float up = min(SearchDistance(pixel, vec2(0.0, 1.0), false), uRectSize.y - 1.0 - pixel.y);
+
+    vec2 bottomEnd = vec2(pixel.x, pixel.y - down);
+    vec2 topEnd = vec2(pixel.x, pixel.y + up + 1.0);
+    float crossing1 = Crossing(Edges(bottomEnd).g, Edges(bottomEnd - vec2(1.0, 0.0)).g);
+    float crossing2 = Crossing(Edges(topEnd).g, Edges(topEnd - vec2(1.0, 0.0)).g);
+
+    weights.ba = Area(down, up, crossing1, crossing2);
+  }
+
+  gl_FragColor = weights;
+}
@@ -0,0 +1,67 @@
+/******************************************************************************/
+/*!
+\file   SSAO.fs
+\par    Course: CS370
+\brief  
+  Ambient occlusion over the deinterleaved depth layers. All fragments of a
+  layer use that layer's sample pattern, and samples never leave the layer
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap; // linear depth layers
+
+uniform vec2 uLayerSize;          // in texels
+uniform vec4 uLayerPattern[16];   // rotation in xy, radius jitter in z
+
+uniform float uSampleDistance; // in half resolution pixels
+uniform float uAOScale;
+uniform int uDirections;
+uniform int uSteps;
+
+void main(void)
+{
+  vec2 atlasSize = uLayerSize * 4.0;
+  vec2 pixel = floor(gl_FragCoord.xy);
+  vec2 layer = floor(pixel / uLayerSize);
+  vec2 local = pixel - layer * uLayerSize;
+  vec2 layerOrigin = layer * uLayerSize;
+
+  vec4 pattern = uLayerPattern[int(layer.y * 4.0 + layer.x)];
+  float z = texture2D(uColorMap, (pixel + 0.5) / atlasSize).r;
+
+  float occlusion = 0.0;
+  float count = 0.0;
+
+  for(int i = 0; i < 16; ++i)
+  {
+    if(i >= uDirections)
+    {
+      break;
+    }
+
+    // Directions evenly spread, rotated per layer
+    float angle = 6.2831853 * float(i) / float(uDirections);
+    vec2 dir = vec2(cos(angle), sin(angle));
+    dir = vec2(dir.x * pattern.x - dir.y * pattern.y, dir.x * pattern.y + dir.y * pattern.x);
+
+    for(int j = 0; j < 8; ++j)
+    {
+      if(j >= uSteps)
+      {
+        break;
+      }
+
+      // A layer texel is 4 half resolution pixels wide
+      float radius = uSampleDistance * (float(j) + pattern.z) / float(uSteps);
+      vec2 sampleLocal = clamp(local + 0.5 + dir * radius * 0.25, vec2(0.5), uLayerSize - 0.5);
+      float sampleZ = texture2D(uColorMap, (layerOrigin + sampleLocal) / atlasSize).r;
+
+      // Closer samples occlude, less so the further in front they are
+      float dz = z - sampleZ;
+      occlusion += clamp(dz * uAOScale / z, 0.0, 1.0) / (1.0 + dz * dz);
+      count += 1.0;
+    }
+  }
+
+  gl_FragColor = vec4(1.0 - occlusion / count, z, 0.0, 1.0);
+}
@@ -0,0 +1,41 @@
+/******************************************************************************/
+/*!
+\file   SSAOBlur.fs
+\par    Course: CS370
+\brief  
+  One axis of the bilateral blur over the half resolution occlusion. Taps
+  across a depth edge get little weight, so occlusion does not bleed onto
+  the object in front
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap; // occlusion in r, linear depth in g
+
+varying vec2 vTexCoord;
+uniform vec2 uUVScale;  // part of uColorMap that holds the image
+uniform vec2 uMaxUV;
+uniform vec2 uDirection; // one texel along the blur axis
+uniform float uSharpness;
+
+void main(void)
+{
+  vec2 coord = vTexCoord * uUVScale;
+  vec2 center = texture2D(uColorMap, coord).rg;
+
+  float ao = 0.0;
+  float weightSum = 0.0;
+
+  for(int i = -4; i <= 4; ++i)
+  {
+    vec2 tap = texture2D(uColorMap, min(coord + uDirection * float(i), uMaxUV)).rg;
+
+    float spatial = exp(-float(i * i) / 8.0);
+    float range = exp(-abs(tap.g - center.g) / max(center.g, 0.0001) * uSharpness);
+    float weight = spatial * range;
+
+    ao += tap.r * weight;
+    weightSum += weight;
+  }
+
+  gl_FragColor = vec4(ao / weightSum, center.g, 0.0, 1.0);
+}
@@ -0,0 +1,25 @@
+/******************************************************************************/
+/*!
+\file   SSAOComposite.fs
+\par    Course: CS370
+\brief  
+  Darkens the image by the blurred half resolution occlusion
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap; // image
+uniform sampler2D uPass1;    // half resolution occlusion
+
+varying vec2 vTexCoord;
+uniform vec2 uUVScale;   // part of uColorMap that holds the image
+uniform vec2 uAOUVScale; // part of uPass1 that holds the occlusion
+
+uniform float uAOStrength;
+
+void main(void)
+{
+  vec4 color = texture2D(uColorMap, vTexCoord * uUVScale);
+  float ao = texture2D(uPass1, vTexCoord * uAOUVScale).r;
+
+  gl_FragColor = vec4(color.rgb * mix(1.0, ao, clamp(uAOStrength, 0.0, 1.0)), color.a);
+}
@@ -0,0 +1,36 @@
+/******************************************************************************/
+/*!
+\file   SSAODeinterleave.fs
+\par    Course: CS370
+\brief  
+  Splits the half resolution depth into 4x4 layers placed side by side.
+  The closest depth of each 2x2 block is used, so thin occluders survive.
+  Layer (i, j) holds the half resolution pixels (4x + i, 4y + j), as
+  linear depth
+*/
+/******************************************************************************/
+
+uniform sampler2D uShadowMap; // depth pyramid level 0, covers the whole view
+
+uniform vec2 uLayerSize; // in texels
+uniform vec2 uHalfRect;  // half resolution view size in pixels
+
+uniform float uCameraNear;
+uniform float uCameraFar;
+
+void main(void)
+{
+  vec2 pixel = floor(gl_FragCoord.xy);
+  vec2 layer = floor(pixel / uLayerSize);
+  vec2 local = pixel - layer * uLayerSize;
+
+  vec2 halfPixel = local * 4.0 + layer;
+  float depth = texture2D(uShadowMap, min((halfPixel + 0.5) / uHalfRect, vec2(1.0))).g;
+
+  // Same reconstruction as the fog
+  float p34 = (-2.0 * uCameraFar * uCameraNear) / (uCameraFar - uCameraNear);
+  float p33 = (uCameraFar + uCameraNear) / (uCameraNear - uCameraFar);
+  float z = -p34 / (depth + p33);
+
+  gl_FragColor = vec4(z, 0.0, 0.0, 1.0);
+}
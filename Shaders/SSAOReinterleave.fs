@@ -0,0 +1,21 @@
+/******************************************************************************/
+/*!
+\file   SSAOReinterleave.fs
+\par    Course: CS370
+\brief  
+  Puts the occlusion layers back together at half resolution
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap; // occlusion and linear depth layers
+
+uniform vec2 uLayerSize; // in texels
+
+void main(void)
+{
+  vec2 pixel = floor(gl_FragCoord.xy);
+  vec2 layer = mod(pixel, 4.0);
+  vec2 local = floor(pixel / 4.0);
+
+  gl_FragColor = texture2D(uColorMap, (layer * uLayerSize + local + 0.5) / (uLayerSize * 4.0));
+}
@@ -0,0 +1,42 @@
+/******************************************************************************/
+/*!
+\file   Sobel.fs
+\par    Course: CS370
+\brief  
+  Sobel edge detection out of four filtered taps instead of nine texels
+*/
+/******************************************************************************/
+
+varying vec2 vTexCoord;
+
+uniform sampler2D uColorMap;
+uniform float uMapWidth;
+uniform float uMapHeight;
+
+uniform vec2 uUVScale; // part of uColorMap that holds the image
+
+vec4 Tap(vec2 center, vec2 texelSize, float x, float y)
+{
+  return texture2D(uColorMap, min(center + vec2(x, y) * texelSize, uUVScale - 0.5 * texelSize));
+}
+
+void main(void)
+{
+  vec2 texelSize = vec2(1.0 / uMapWidth, 1.0 / uMapHeight);
+  vec2 center = vTexCoord.xy * uUVScale;
+
+  // A filtered tap on the corner between 4 texels is their average.
+  // Differences of the diagonal corners add up to a quarter of the kernels
+  //      -1 0 1          1  2  1
+  // Gx = -2 0 2     Gy = 0  0  0
+  //      -1 0 1         -1 -2 -1
+  vec4 upperRight = Tap(center, texelSize, 0.5, 0.5);
+  vec4 upperLeft = Tap(center, texelSize, -0.5, 0.5);
+  vec4 lowerLeft = Tap(center, texelSize, -0.5, -0.5);
+  vec4 lowerRight = Tap(center, texelSize, 0.5, -0.5);
+
+  vec3 gx = ((upperRight - upperLeft) + (lowerRight - lowerLeft)).rgb * 4.0;
+  vec3 gy = ((upperRight - lowerRight) + (upperLeft - lowerLeft)).rgb * 4.0;
+
+  gl_FragColor = vec4(sqrt(gx * gx + gy * gy), 1.0);
+}
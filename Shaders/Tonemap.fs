@@ -0,0 +1,33 @@
+/******************************************************************************/
+/*!
+\file   Tonemap.fs
+\par    Course: CS370
+\brief  
+  Maps the HDR post processing chain to displayable 0..1 color
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap;
+uniform sampler2D uPass3; // automatic exposure in r
+
+varying vec2 vTexCoord;
+uniform vec2 uUVScale; // part of uColorMap that holds the image
+
+uniform float uExposure; // scales the automatic exposure when that is on
+uniform bool uAutoExposure;
+uniform bool uFilmic;
+
+// Narkowicz's fit of the ACES filmic curve
+vec3 ACESFilm(vec3 x)
+{
+  return clamp((x * (2.51 * x + 0.03)) / (x * (2.43 * x + 0.59) + 0.14), 0.0, 1.0);
+}
+
+void main(void)
+{
+  vec4 color = texture2D(uColorMap, vTexCoord * uUVScale);
+  float exposure = uAutoExposure ? uExposure * texture2D(uPass3, vec2(0.5)).r : uExposure;
+  vec3 hdr = color.rgb * exposure;
+
+  gl_FragColor = vec4(uFilmic ? ACESFilm(hdr) : hdr / (1.0 + hdr), color.a);
+}
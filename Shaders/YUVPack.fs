@@ -0,0 +1,67 @@
+/******************************************************************************/
+/*!
+\file   YUVPack.fs
+\par    Course: CS370
+\brief  
+  Converts the frame to BT.709 limited range YUV 4:2:0 and packs the three
+  planes four bytes to a texel. Row 0 of the target is read back first, so
+  the Y rows go first, top row first, then two U rows per target row, then
+  the V rows
+*/
+/******************************************************************************/
+
+uniform sampler2D uColorMap; // final image
+
+uniform vec2 uUVScale;   // part of uColorMap that holds the image
+uniform vec2 uFrameSize; // in pixels, width a multiple of 8, height of 4
+
+// Color of a frame pixel, rows counted from the top
+vec3 FrameColor(vec2 pixelFromTop, vec2 footprint)
+{
+  vec2 coord = vec2(pixelFromTop.x, uFrameSize.y - pixelFromTop.y - footprint.y) + footprint * 0.5;
+  return texture2D(uColorMap, coord / uFrameSize * uUVScale).rgb;
+}
+
+float Luma(vec3 color)
+{
+  return dot(color, vec3(0.2126, 0.7152, 0.0722));
+}
+
+void main(void)
+{
+  vec2 texel = floor(gl_FragCoord.xy);
+  vec4 bytes;
+
+  if(texel.y < uFrameSize.y)
+  {
+    // Four luma values of one row
+    for(int i = 0; i < 4; ++i)
+    {
+      float luma = Luma(FrameColor(vec2(texel.x * 4.0 + float(i), texel.y), vec2(1.0)));
+      bytes[i] = (16.0 + 219.0 * luma) / 255.0;
+    }
+  }
+  else
+  {
+    // Chroma planes are half size in both directions, one target row holds two of their rows
+    float chromaRows = uFrameSize.y * 0.25;
+    float row = texel.y - uFrameSize.y;
+    bool isV = row >= chromaRows;
+    row -= isV ? chromaRows : 0.0;
+
+    float chromaWidth = uFrameSize.x * 0.5;
+    float first = row * uFrameSize.x + texel.x * 4.0;
+    vec2 chroma = vec2(mod(first, chromaWidth), floor(first / chromaWidth));
+
+    for(int i = 0; i < 4; ++i)
+    {
+      // One bilinear tap averages the 2x2 block, centered like JPEG chroma
+      vec3 color = FrameColor((chroma + vec2(float(i), 0.0)) * 2.0, vec2(2.0));
+      float luma = Luma(color);
+      float value = isV ? (color.r - luma) / 1.5748 : (color.b - luma) / 1.8556;
+      bytes[i] = (128.0 + 224.0 * value) / 255.0;
+    }
+  }
+
+  gl_FragColor = clamp(bytes, 0.0, 1.0);
+}